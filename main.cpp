@@ -7,6 +7,7 @@
 
 #include <iostream>
 #include <string>
+#include <cstring>
 #include <algorithm>
 #include <memory>
 #include <iterator>
@@ -19,10 +20,18 @@ void print_usage(std::ostream& stream, char* name) {
   << " [-k <order>]"
   << " [--mode <moment-mode>]"
   << " [--dist <sample-distribution>]"
-  << " [--n <n-samples>]"
+  << " [-n <n-samples>]"
   << " [--output <output-directory>]"
   << " [--plot <plot-samples>]"
   << " [--clt <show-clt-convergence>]"
+  << " [--stream <stream-samples>]"
+  << " [--chunk <chunk-size>]"
+  << " [--threads <n-threads>]"
+  << " [--analytic <analytic-moments>]"
+  << " [--replicates <n-replicates>]"
+  << " [--antithetic <antithetic-variates>]"
+  << " [--control <control-degree>]"
+  << " [--proposal <proposal-scale>]"
   << std::endl;
 }
 
@@ -34,8 +43,8 @@ void print_help(std::ostream& stream) {
   stream << "[--mode <moment-mode>]" << std::endl;
   stream << "\t *Optional* Moment type (Default: \"standardized\")" << std::endl;
   stream << "[--dist <sample-distribution>]" << std::endl;
-  stream << "\t *Optional* Source sample distribution (Default: \"normal\")" << std::endl;
-  stream << "[--n <n-samples>]" << std::endl;
+  stream << "\t *Optional* Source sample distribution: \"normal\", \"uniform\", or their quasi-random versions \"sobol-normal\", \"sobol-uniform\", \"halton-normal\", \"halton-uniform\" (Default: \"normal\")" << std::endl;
+  stream << "[-n <n-samples>]" << std::endl;
   stream << "\t *Optional* Number of samples (Default: 1000)" << std::endl;
   stream << "[--output <output-directory>]" << std::endl;
   stream << "\t *Optional* Path to output directory" << std::endl;
@@ -43,6 +52,22 @@ void print_help(std::ostream& stream) {
   stream << "\t *Optional* Whether to save plots of samples" << std::endl;
   stream << "[--clt <show-clt-errors>]" << std::endl;
   stream << "\t *Optional* Whether to print CLT outputs" << std::endl;
+  stream << "[--stream <stream-samples>]" << std::endl;
+  stream << "\t *Optional* Whether to accumulate the samples in chunks without storing them" << std::endl;
+  stream << "[--chunk <chunk-size>]" << std::endl;
+  stream << "\t *Optional* Number of samples in each chunk of the streaming mode (Default: 65536)" << std::endl;
+  stream << "[--threads <n-threads>]" << std::endl;
+  stream << "\t *Optional* Number of threads (Default: number of hardware threads)" << std::endl;
+  stream << "[--analytic <analytic-moments>]" << std::endl;
+  stream << "\t *Optional* Whether to use the closed-form moments when they are known: \"auto\", \"off\", or \"check\" (Default: \"auto\")" << std::endl;
+  stream << "[--replicates <n-replicates>]" << std::endl;
+  stream << "\t *Optional* Number of independent replicates, whose spread gives the standard errors (Default: 1)" << std::endl;
+  stream << "[--antithetic <antithetic-variates>]" << std::endl;
+  stream << "\t *Optional* Whether to pair the samples with their reflections around the mean (Default: 0)" << std::endl;
+  stream << "[--control <control-degree>]" << std::endl;
+  stream << "\t *Optional* Highest power of the inputs used as control variates, 0 for none (Default: 0)" << std::endl;
+  stream << "[--proposal <proposal-scale>]" << std::endl;
+  stream << "\t *Optional* Scale of the spread of the proposal distribution of importance sampling, 0 for none (Default: 0)" << std::endl;
 }
 
 void launch_workflow(const ArgParser& parser) {
@@ -131,7 +156,7 @@ int main(int argc, char** argv){
     print_help(std::cout);
   }
   // Set up arguments from the command line inputs
-  else if (argc < 19) {
+  else if (argc < 35) {
     try{
       ArgParser parser(argc, argv);
       launch_workflow(parser);
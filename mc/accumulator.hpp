@@ -0,0 +1,203 @@
+#ifndef MC_ACCUMULATOR_HPP
+#define MC_ACCUMULATOR_HPP
+
+#include "distributions.hpp"
+#include "samples.hpp"
+#include "vector.hpp"
+#include "exceptions.hpp"
+
+#include <Eigen/Core>
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+/**
+ * @brief Class for accumulating the statistical moments of a stream of samples.
+ * The samples are processed one by one and are not stored. For each dimension, the
+ * accumulator keeps the number of samples \f$ n \f$, the mean \f$ \mu \f$ and the central power sums
+ * \f[
+ *      M_p = \sum_{i=1}^{n} (x_i - \mu)^p, \quad p = 2, \dots, P,
+ * \f]
+ * up to a chosen order \f$ P \f$.
+ *
+ * The power sums are updated with the numerically stable formulas of Pébay (2008),
+ * which generalize the algorithm of Welford to arbitrary orders.
+ * Adding a sample \f$ x \f$ to \f$ n - 1 \f$ samples with \f$ \delta = x - \mu \f$ gives:
+ * \f[
+ *      M_p \leftarrow M_p + \sum_{k=1}^{p-2} \binom{p}{k} M_{p-k} \left(-\frac{\delta}{n}\right)^k
+ *          + (n - 1) \left(\frac{\delta}{n}\right)^p \left((n - 1)^{p-1} - (-1)^{p-1}\right).
+ * \f]
+ *
+ * Two accumulators \f$ A \f$ and \f$ B \f$ are merged exactly with the pairwise formulas
+ * (\f$ n = n_A + n_B \f$ and \f$ \delta = \mu_B - \mu_A \f$):
+ * \f[
+ *      M_p = M_p^A + M_p^B + \sum_{k=1}^{p-2} \binom{p}{k} \delta^k
+ *          \left[\left(-\frac{n_B}{n}\right)^k M_{p-k}^A + \left(\frac{n_A}{n}\right)^k M_{p-k}^B\right]
+ *          + n_A n_B \left(\frac{\delta}{n}\right)^p \left(n_A^{p-1} - (-n_B)^{p-1}\right),
+ * \f]
+ * which is the update above for \f$ n_B = 1 \f$. The merge is associative up to rounding errors,
+ * so samples can be accumulated separately by several threads or processes and combined at the end.
+ * Buffers of samples are also accumulated block by block: the power sums of each block are computed
+ * around the mean of the block and then merged.
+ *
+ * The raw, central, and standardized moments of any order up to \f$ P \f$ are then obtained
+ * in \f$ O(P) \f$ operations per dimension, without passing over the samples again.
+ *
+ * The samples can also be weighted (e.g., by the likelihood ratios of importance sampling): the count
+ * \f$ n \f$ is then replaced by the sum of the weights \f$ W = \sum_i w_i \f$ in the formulas above,
+ * the mean is \f$ \sum_i w_i x_i / W \f$, and \f$ M_p = \sum_i w_i (x_i - \mu)^p \f$ (self-normalized
+ * estimates). The effective number of samples \f$ W^2 / \sum_i w_i^2 \f$ (Kish, 1965) measures
+ * the loss of accuracy due to the spread of the weights.
+ *
+ * @tparam dim The dimension of the samples.
+ */
+template <unsigned int dim = 1>
+class MomentAccumulator
+{
+public:
+  /// @brief Construct an empty accumulator.
+  /// @param order The highest order of the moments that can be calculated.
+  MomentAccumulator(unsigned int order = 6);
+
+  /**
+   * @brief Construct an accumulator from the exact moments of a distribution.
+   * The accumulator holds one sample with the given mean and central moments \f$ M_p / n \f$,
+   * so the moments are returned exactly (e.g., the analytic moments of a function),
+   * but it should not be merged with accumulators of samples.
+   * @param mean The mean in each dimension.
+   * @param central The central moments (row p contains the p-th central moment of each dimension).
+   * @return MomentAccumulator<dim> The accumulator, with the order of the highest central moment.
+   */
+  static MomentAccumulator<dim> from_moments(
+    const Eigen::Matrix<double, dim, 1>& mean, const Eigen::Matrix<double, Eigen::Dynamic, dim>& central);
+
+  /// @brief Add a sample to the accumulator.
+  void add(const Vector<dim>& x);
+
+  /**
+   * @brief Add a buffer of samples to the accumulator.
+   * @param x Pointer to the samples.
+   * @param n The number of the samples.
+   * @param layout The layout of the buffer (see Distribution::samples).
+   */
+  void add(const double* x, std::size_t n, Layout layout = Layout::AoS);
+
+  /**
+   * @brief Add a buffer of samples stored coordinate by coordinate to the accumulator.
+   * The coordinates are read in place, without copies.
+   * @param x Pointer to the samples (coordinate `d` of sample `i` is `x[d * ld + i]`).
+   * @param n The number of the samples.
+   * @param ld The distance between the coordinates of a sample (leading dimension).
+   */
+  void add(const double* x, std::size_t n, std::size_t ld);
+
+  /**
+   * @brief Add a buffer of weighted samples stored coordinate by coordinate to the accumulator.
+   * @param x Pointer to the samples (coordinate `d` of sample `i` is `x[d * ld + i]`).
+   * @param w Pointer to the non-negative weights of the samples.
+   * @param n The number of the samples.
+   * @param ld The distance between the coordinates of a sample (leading dimension).
+   */
+  void add(const double* x, const double* w, std::size_t n, std::size_t ld);
+
+  /// @brief Add a set of samples to the accumulator.
+  void add(const std::vector<Vector<dim>>& samples);
+
+  /// @brief Add a block of samples to the accumulator.
+  void add(const SampleBlock<dim>& samples);
+
+  /// @brief Add a block of weighted samples to the accumulator.
+  void add(const SampleBlock<dim>& samples, const double* w);
+
+  /**
+   * @brief Merge the samples of another accumulator into this one.
+   * The result is the same as accumulating all the samples in one accumulator.
+   * The other accumulator must have at least the same order, otherwise
+   * an InvalidInputException exception is thrown.
+   * @param other The other accumulator.
+   */
+  void merge(const MomentAccumulator<dim>& other);
+
+  /// @brief Merge the samples of another accumulator into this one.
+  MomentAccumulator<dim>& operator+=(const MomentAccumulator<dim>& other);
+
+  /// @brief Return the highest order of the moments.
+  unsigned int order() const;
+  /// @brief Return the number of accumulated samples.
+  std::uint64_t count() const;
+  /// @brief Return the sum of the weights of the accumulated samples (the count without weights).
+  double weight() const;
+  /// @brief Return the effective number of samples \f$ W^2 / \sum_i w_i^2 \f$ (the count without weights).
+  double ess() const;
+
+  /**
+   * @brief Calculate a moment of the accumulated samples in one dimension.
+   * @param d The dimension.
+   * @param order The moment order.
+   * @param mode The mode of the moment among "raw", "central", and "standardized".
+   * @return double The moment.
+   */
+  double moment(unsigned int d, unsigned int order, const std::string& mode) const;
+
+  /**
+   * @brief Calculate a moment of the accumulated samples.
+   * @param order The moment order in all dimensions.
+   * @param mode The mode of the moment among "raw", "central", and "standardized".
+   * @return Eigen::VectorXd The vector of moments along each dimension.
+   */
+  Eigen::VectorXd moment(unsigned int order, const std::string& mode) const;
+
+  /// @brief Return the mean of the accumulated samples.
+  Eigen::VectorXd mean() const;
+  /// @brief Return the variance of the accumulated samples.
+  Eigen::VectorXd var() const;
+
+private:
+  /// @brief Return the k-th central moment in one dimension.
+  double central(unsigned int d, unsigned int k) const;
+
+  /**
+   * @brief Accumulate the power sums of a block of at most SAMPLE_BLOCK_SIZE samples stored coordinate by coordinate.
+   * @param x Pointer to the samples.
+   * @param w Pointer to the weights of the samples (null without weights).
+   * @param m The number of the samples.
+   * @param ld The leading dimension of the samples.
+   */
+  void add_block(const double* x, const double* w, std::size_t m, std::size_t ld);
+
+  /**
+   * @brief Merge a set of samples given by its count, weights, mean, and central power sums.
+   * @param count The number of samples.
+   * @param weight The sum of the weights of the samples.
+   * @param weight2 The sum of the squares of the weights of the samples.
+   * @param mean The mean of the samples.
+   * @param sums The central power sums of the samples (with at least the same order).
+   */
+  void merge(std::uint64_t count, double weight, double weight2, const Eigen::Matrix<double, dim, 1>& mean,
+    const Eigen::Matrix<double, Eigen::Dynamic, dim>& sums);
+
+  /// @brief The highest order of the power sums.
+  unsigned int m_order;
+  /// @brief The number of samples.
+  std::uint64_t m_count;
+  /// @brief The sum of the weights of the samples.
+  double m_weight;
+  /// @brief The sum of the squares of the weights of the samples.
+  double m_weight2;
+  /// @brief The mean of the samples.
+  Eigen::Matrix<double, dim, 1> m_mean;
+  /// @brief The central power sums (row p contains \f$ M_p \f$ for each dimension).
+  Eigen::Matrix<double, Eigen::Dynamic, dim> m_sums;
+
+  /// @brief The mean of the current block of samples.
+  Eigen::Matrix<double, dim, 1> m_block_mean;
+  /// @brief The central power sums of the current block of samples (allocated with the accumulator).
+  Eigen::Matrix<double, Eigen::Dynamic, dim> m_block_sums;
+};
+
+#include "accumulator.tpp"
+
+#endif
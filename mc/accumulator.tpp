@@ -0,0 +1,311 @@
+#include "accumulator.hpp"
+
+
+template <unsigned int dim>
+MomentAccumulator<dim>::MomentAccumulator(unsigned int order)
+  : m_order(std::max(order, 2u)), m_count(0), m_weight(0.), m_weight2(0.)
+{
+  m_mean.setZero();
+  m_sums.setZero(m_order + 1, dim);
+  m_block_mean.setZero();
+  m_block_sums.setZero(m_order + 1, dim);
+}
+
+template <unsigned int dim>
+MomentAccumulator<dim> MomentAccumulator<dim>::from_moments(
+  const Eigen::Matrix<double, dim, 1>& mean, const Eigen::Matrix<double, Eigen::Dynamic, dim>& central) {
+  if (central.rows() < 3) {
+    throw InvalidInputException("The central moments must be given up to the order 2 at least.");
+  }
+  MomentAccumulator<dim> acc(central.rows() - 1);
+  acc.m_count = 1;
+  acc.m_weight = 1.;
+  acc.m_weight2 = 1.;
+  acc.m_mean = mean;
+  acc.m_sums = central;
+  return acc;
+}
+
+template <unsigned int dim>
+void MomentAccumulator<dim>::add(const Vector<dim>& x) {
+  // Initialize with the first sample
+  if (m_weight == 0.) {
+    for (unsigned int d = 0; d < dim; ++d) {
+      m_mean[d] = x[d];
+    }
+    m_count += 1;
+    m_weight = 1.;
+    m_weight2 = 1.;
+    return;
+  }
+
+  const double n_prev = m_weight;
+  const double n = m_weight + 1.;
+  for (unsigned int d = 0; d < dim; ++d) {
+    const double delta = x[d] - m_mean[d];
+    const double delta_n = delta / n;
+
+    // Update the higher orders first since they depend on the lower ones
+    for (unsigned int p = m_order; p >= 2; --p) {
+      double update = 0.;
+      double binom = 1.;
+      double factor = 1.;
+      for (unsigned int k = 1; k + 2 <= p; ++k) {
+        binom = binom * (p - k + 1) / k;
+        factor *= -delta_n;
+        update += binom * m_sums(p - k, d) * factor;
+      }
+      double sign = (p % 2 == 0) ? -1. : 1.;
+      update += n_prev * std::pow(delta_n, p) * (std::pow(n_prev, p - 1) - sign);
+      m_sums(p, d) += update;
+    }
+
+    m_mean[d] += delta_n;
+  }
+  ++m_count;
+  m_weight += 1.;
+  m_weight2 += 1.;
+}
+
+template <unsigned int dim>
+void MomentAccumulator<dim>::add(const double* x, std::size_t n, Layout layout) {
+  if (layout == Layout::SoA) {
+    add(x, n, n);
+    return;
+  }
+
+  // Transpose each block of samples
+  double block[dim * SAMPLE_BLOCK_SIZE];
+  for (std::size_t start = 0; start < n; start += SAMPLE_BLOCK_SIZE) {
+    std::size_t m = std::min<std::size_t>(SAMPLE_BLOCK_SIZE, n - start);
+    for (unsigned int d = 0; d < dim; ++d) {
+      for (std::size_t i = 0; i < m; ++i) block[d * SAMPLE_BLOCK_SIZE + i] = x[(start + i) * dim + d];
+    }
+    add_block(block, nullptr, m, SAMPLE_BLOCK_SIZE);
+  }
+}
+
+template <unsigned int dim>
+void MomentAccumulator<dim>::add(const double* x, std::size_t n, std::size_t ld) {
+  for (std::size_t start = 0; start < n; start += SAMPLE_BLOCK_SIZE) {
+    add_block(x + start, nullptr, std::min<std::size_t>(SAMPLE_BLOCK_SIZE, n - start), ld);
+  }
+}
+
+template <unsigned int dim>
+void MomentAccumulator<dim>::add(const double* x, const double* w, std::size_t n, std::size_t ld) {
+  for (std::size_t start = 0; start < n; start += SAMPLE_BLOCK_SIZE) {
+    add_block(x + start, w + start, std::min<std::size_t>(SAMPLE_BLOCK_SIZE, n - start), ld);
+  }
+}
+
+template <unsigned int dim>
+void MomentAccumulator<dim>::add_block(const double* x, const double* w, std::size_t m, std::size_t ld) {
+  double centered[SAMPLE_BLOCK_SIZE];
+  double powered[SAMPLE_BLOCK_SIZE];
+
+  // The sums of the weights of the block (the count without weights)
+  double weight = m;
+  double weight2 = m;
+  if (w) {
+    weight = 0.;
+    weight2 = 0.;
+    for (std::size_t i = 0; i < m; ++i) {
+      weight += w[i];
+      weight2 += w[i] * w[i];
+    }
+    if (weight == 0.) {
+      merge(m, 0., 0., m_block_mean, m_block_sums);
+      return;
+    }
+  }
+
+  // Compute the moments of the block with two passes over each coordinate
+  for (unsigned int d = 0; d < dim; ++d) {
+    const double* column = x + d * ld;
+
+    double mean = 0.;
+    if (w) {
+      for (std::size_t i = 0; i < m; ++i) mean += w[i] * column[i];
+    }
+    else {
+      for (std::size_t i = 0; i < m; ++i) mean += column[i];
+    }
+    mean /= weight;
+    m_block_mean[d] = mean;
+
+    for (std::size_t i = 0; i < m; ++i) {
+      centered[i] = column[i] - mean;
+      powered[i] = w ? w[i] * centered[i] : centered[i];
+    }
+    for (unsigned int p = 2; p <= m_order; ++p) {
+      double sum = 0.;
+      for (std::size_t i = 0; i < m; ++i) {
+        powered[i] *= centered[i];
+        sum += powered[i];
+      }
+      m_block_sums(p, d) = sum;
+    }
+  }
+
+  // Merge the block
+  merge(m, weight, weight2, m_block_mean, m_block_sums);
+}
+
+template <unsigned int dim>
+void MomentAccumulator<dim>::add(const std::vector<Vector<dim>>& samples) {
+  if (!samples.empty()) {
+    add(&samples[0][0], samples.size(), Layout::AoS);
+  }
+}
+
+template <unsigned int dim>
+void MomentAccumulator<dim>::add(const SampleBlock<dim>& samples) {
+  add(samples.data(), samples.size(), samples.ld());
+}
+
+template <unsigned int dim>
+void MomentAccumulator<dim>::add(const SampleBlock<dim>& samples, const double* w) {
+  add(samples.data(), w, samples.size(), samples.ld());
+}
+
+template <unsigned int dim>
+void MomentAccumulator<dim>::merge(const MomentAccumulator<dim>& other) {
+  if (other.m_order < m_order) {
+    std::string msg = "Cannot merge an accumulator of order " + std::to_string(other.m_order)
+      + " into an accumulator of order " + std::to_string(m_order) + ".";
+    throw InvalidInputException(msg);
+  }
+  merge(other.m_count, other.m_weight, other.m_weight2, other.m_mean, other.m_sums);
+}
+
+template <unsigned int dim>
+MomentAccumulator<dim>& MomentAccumulator<dim>::operator+=(const MomentAccumulator<dim>& other) {
+  merge(other);
+  return *this;
+}
+
+template <unsigned int dim>
+void MomentAccumulator<dim>::merge(std::uint64_t count, double weight, double weight2,
+  const Eigen::Matrix<double, dim, 1>& mean, const Eigen::Matrix<double, Eigen::Dynamic, dim>& sums) {
+  // Samples without weight are only counted
+  if (weight == 0.) {
+    m_count += count;
+    return;
+  }
+  if (m_weight == 0.) {
+    m_count += count;
+    m_weight = weight;
+    m_weight2 = weight2;
+    m_mean = mean;
+    m_sums = sums.topRows(m_order + 1);
+    m_sums.topRows(2).setZero();
+    return;
+  }
+
+  const double n_a = m_weight;
+  const double n_b = weight;
+  const double n = n_a + n_b;
+  for (unsigned int d = 0; d < dim; ++d) {
+    const double delta = mean[d] - m_mean[d];
+    const double delta_n = delta / n;
+
+    // Update the higher orders first since they depend on the lower ones
+    for (unsigned int p = m_order; p >= 2; --p) {
+      double update = sums(p, d);
+      double binom = 1.;
+      double factor_a = 1.;
+      double factor_b = 1.;
+      for (unsigned int k = 1; k + 2 <= p; ++k) {
+        binom = binom * (p - k + 1) / k;
+        factor_a *= -n_b * delta_n;
+        factor_b *= n_a * delta_n;
+        update += binom * (factor_a * m_sums(p - k, d) + factor_b * sums(p - k, d));
+      }
+      update += n_a * n_b * std::pow(delta_n, p) * (std::pow(n_a, p - 1) - std::pow(-n_b, p - 1));
+      m_sums(p, d) += update;
+    }
+
+    m_mean[d] += n_b * delta_n;
+  }
+  m_count += count;
+  m_weight += weight;
+  m_weight2 += weight2;
+}
+
+template <unsigned int dim>
+unsigned int MomentAccumulator<dim>::order() const {
+  return m_order;
+}
+
+template <unsigned int dim>
+std::uint64_t MomentAccumulator<dim>::count() const {
+  return m_count;
+}
+
+template <unsigned int dim>
+double MomentAccumulator<dim>::weight() const {
+  return m_weight;
+}
+
+template <unsigned int dim>
+double MomentAccumulator<dim>::ess() const {
+  return m_weight2 > 0. ? m_weight * m_weight / m_weight2 : 0.;
+}
+
+template <unsigned int dim>
+double MomentAccumulator<dim>::central(unsigned int d, unsigned int k) const {
+  if (k == 0) return 1.;
+  if (k == 1) return 0.;
+  return m_sums(k, d) / m_weight;
+}
+
+template <unsigned int dim>
+double MomentAccumulator<dim>::moment(unsigned int d, unsigned int k, const std::string& mode) const {
+  if (k > m_order) {
+    std::string msg = "The moment order " + std::to_string(k)
+      + " is higher than the order of the accumulator (" + std::to_string(m_order) + ").";
+    throw InvalidInputException(msg);
+  }
+
+  if (mode == "raw") {
+    // Binomial expansion of E[((x - mu) + mu)^k]
+    double raw = 0.;
+    double binom = 1.;
+    for (unsigned int j = 0; j <= k; ++j) {
+      raw += binom * std::pow(m_mean[d], k - j) * central(d, j);
+      binom = binom * (k - j) / (j + 1);
+    }
+    return raw;
+  }
+  else if (mode == "central") {
+    return central(d, k);
+  }
+  else if (mode == "standardized") {
+    double std = sqrt(central(d, 2));
+    return central(d, k) / pow(std, k);
+  }
+  else {
+    std::string msg = "The requested mode is not supported: \"" + mode + "\".";
+    throw InvalidInputException(msg);
+  }
+}
+
+template <unsigned int dim>
+Eigen::VectorXd MomentAccumulator<dim>::moment(unsigned int order, const std::string& mode) const {
+  Eigen::VectorXd moment(dim);
+  for (unsigned int d = 0; d < dim; ++d) {
+    moment[d] = this->moment(d, order, mode);
+  }
+  return moment;
+}
+
+template <unsigned int dim>
+Eigen::VectorXd MomentAccumulator<dim>::mean() const {
+  return m_mean;
+}
+
+template <unsigned int dim>
+Eigen::VectorXd MomentAccumulator<dim>::var() const {
+  return moment(2, "central");
+}
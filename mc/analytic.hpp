@@ -0,0 +1,41 @@
+#ifndef MC_ANALYTIC_HPP
+#define MC_ANALYTIC_HPP
+
+#include "functions.hpp"
+#include "distributions.hpp"
+#include "accumulator.hpp"
+#include "mathutils.hpp"
+#include "vector.hpp"
+
+#include <Eigen/Core>
+
+#include <vector>
+#include <algorithm>
+
+
+/**
+ * @brief Calculates the exact moments of a function of a random variable, when they are known in closed form.
+ * This is the case for separable polynomials (see Function::separable_polynomial) of random variables with
+ * independent coordinates whose central moments are known (see Distribution::central_moments), e.g.,
+ * polynomials and linear functions of uniform or uncorrelated normal random variables.
+ *
+ * Each output is a sum of independent terms \f$ p_d(u_d) \f$. Each polynomial is shifted to the centered
+ * variable \f$ w_d = u_d - \mu_d \f$, its mean \f$ e_d = E[p_d(u_d)] \f$ is subtracted, and the central moments
+ * \f$ E[(p_d - e_d)^i] \f$ are calculated from the moments of \f$ w_d \f$ with powers of the shifted polynomial.
+ * The central moments of the sum are then the binomial convolutions of the ones of the terms.
+ *
+ * @tparam dim_inp The input dimension of the function.
+ * @tparam dim_out The output dimension of the function.
+ * @param f The function.
+ * @param dist The distribution of the inputs.
+ * @param order The highest order of the moments.
+ * @param moments The accumulator with the exact moments (see MomentAccumulator::from_moments).
+ * @return bool Whether the moments are known in closed form. If not, the moments must be approximated.
+ */
+template <unsigned int dim_inp, unsigned int dim_out>
+bool analytic_moments(const Function<dim_inp, dim_out>& f, Distribution<dim_inp>& dist,
+  unsigned int order, MomentAccumulator<dim_out>& moments);
+
+#include "analytic.tpp"
+
+#endif
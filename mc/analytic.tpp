@@ -0,0 +1,79 @@
+#include "analytic.hpp"
+
+
+template <unsigned int dim_inp, unsigned int dim_out>
+bool analytic_moments(const Function<dim_inp, dim_out>& f, Distribution<dim_inp>& dist,
+  unsigned int order, MomentAccumulator<dim_out>& moments) {
+  order = std::max(order, 2u);
+
+  // Get the coefficients of the function
+  std::vector<std::vector<std::vector<double>>> coeffs;
+  if (!f.separable_polynomial(coeffs)) {
+    return false;
+  }
+  std::size_t degree = 0;
+  for (const auto& output : coeffs) {
+    for (const auto& c : output) {
+      degree = std::max(degree, c.size() > 0 ? c.size() - 1 : 0);
+    }
+  }
+
+  // Get the central moments of the inputs, up to the highest power of the polynomials
+  std::vector<std::vector<double>> inputs;
+  if (!dist.central_moments(order * std::max<std::size_t>(degree, 1), inputs)) {
+    return false;
+  }
+  Vector<dim_inp> mu = dist.mean();
+
+  Eigen::Matrix<double, dim_out, 1> mean;
+  Eigen::Matrix<double, Eigen::Dynamic, dim_out> central(order + 1, dim_out);
+  std::vector<double> total(order + 1), term(order + 1), sum(order + 1);
+  for (unsigned int j = 0; j < dim_out; ++j) {
+    mean[j] = 0.;
+    std::fill(total.begin(), total.end(), 0.);
+    total[0] = 1.;
+
+    for (unsigned int d = 0; d < dim_inp; ++d) {
+      if (coeffs[j][d].empty()) continue;
+
+      // Shift the polynomial to the centered variable and subtract its mean
+      std::vector<double> q = polynomial_shift(coeffs[j][d], mu[d]);
+      double e = 0.;
+      for (std::size_t n = 0; n < q.size(); ++n) {
+        e += q[n] * inputs[d][n];
+      }
+      mean[j] += e;
+      q[0] -= e;
+
+      // Calculate the central moments of the term with the powers of the polynomial
+      std::vector<double> power = {1.};
+      term[0] = 1.;
+      for (unsigned int i = 1; i <= order; ++i) {
+        power = polynomial_product(power, q);
+        term[i] = 0.;
+        for (std::size_t n = 0; n < power.size(); ++n) {
+          term[i] += power[n] * inputs[d][n];
+        }
+      }
+
+      // Add the independent term: E[(S + T)^p] = sum_i C(p, i) E[S^i] E[T^(p-i)]
+      for (unsigned int p = 0; p <= order; ++p) {
+        double binomial = 1.;
+        sum[p] = 0.;
+        for (unsigned int i = 0; i <= p; ++i) {
+          sum[p] += binomial * total[i] * term[p - i];
+          binomial = binomial * (p - i) / (i + 1);
+        }
+      }
+      std::swap(total, sum);
+    }
+
+    total[1] = 0.;
+    for (unsigned int p = 0; p <= order; ++p) {
+      central(p, j) = total[p];
+    }
+  }
+
+  moments = MomentAccumulator<dim_out>::from_moments(mean, central);
+  return true;
+}
@@ -0,0 +1,148 @@
+#ifndef MC_CONTROL_HPP
+#define MC_CONTROL_HPP
+
+#include "accumulator.hpp"
+#include "distributions.hpp"
+#include "vector.hpp"
+#include "exceptions.hpp"
+
+#include <Eigen/Core>
+
+#include <cstdint>
+#include <cstddef>
+
+
+/**
+ * @brief Class for accumulating the moments of function outputs with control variates.
+ * The controls are the powers \f$ c_{d,p} = (x_d - \mu_d)^p \f$, \f$ p = 1, \dots, q \f$, of the centered
+ * input coordinates, whose expectations are the central moments of the distribution. The targets are the
+ * powers \f$ t_{j,k} = (y_j - s_j)^k \f$, \f$ k = 1, \dots, P \f$, of the outputs shifted by
+ * \f$ s = f(\mu) \f$, so that the central moments of the outputs are obtained from the expectations of the
+ * targets without cancellations.
+ *
+ * The accumulator keeps the count, the means and the centered cross products of the controls and the
+ * targets in one pass, with the pairwise updates of the covariances (blocks of samples are merged as
+ * in MomentAccumulator, in buffers allocated with the accumulator). The expectation of each target is
+ * then estimated by the regression estimator
+ * \f[
+ *      \hat{t} = \bar{t} - \beta^T (\bar{c} - E[c]), \quad \beta = S_{cc}^{-1} S_{ct},
+ * \f]
+ * whose coefficients minimize the variance of \f$ t - \beta^T c \f$. The coefficients are fitted on the
+ * same samples, which only adds a bias of order \f$ 1/n \f$. The variance of the estimator is reduced by
+ * the factor \f$ 1 / (1 - R^2) \f$, where \f$ R^2 \f$ is the squared multiple correlation of the target
+ * and the controls, e.g., the mean of a linear function is exact with the controls of degree one.
+ *
+ * @tparam dim_inp The dimension of the inputs.
+ * @tparam dim_out The dimension of the outputs.
+ */
+template <unsigned int dim_inp, unsigned int dim_out>
+class ControlVariateAccumulator
+{
+public:
+  /// @brief Construct an empty accumulator without controls.
+  ControlVariateAccumulator();
+
+  /**
+   * @brief Construct an empty accumulator.
+   * The expectations of the controls of degree one and two are the zero mean and the variance of the
+   * centered coordinates. Higher degrees require the central moments of the distribution
+   * (see Distribution::central_moments), otherwise an InvalidInputException exception is thrown.
+   * @param dist The distribution of the inputs.
+   * @param shift The shift of the outputs (usually the output at the mean of the inputs).
+   * @param degree The highest power of the controls (at least one).
+   * @param order The highest order of the moments of the outputs (at least two).
+   */
+  ControlVariateAccumulator(Distribution<dim_inp>& dist, const Vector<dim_out>& shift,
+    unsigned int degree = 1, unsigned int order = 6);
+
+  /**
+   * @brief Add a buffer of inputs and of their outputs, both stored coordinate by coordinate.
+   * @param x Pointer to the inputs (coordinate `d` of input `i` is `x[d * ldx + i]`).
+   * @param ldx The leading dimension of the inputs.
+   * @param y Pointer to the outputs (coordinate `j` of output `i` is `y[j * ldy + i]`).
+   * @param ldy The leading dimension of the outputs.
+   * @param n The number of the samples.
+   */
+  void add(const double* x, std::size_t ldx, const double* y, std::size_t ldy, std::size_t n);
+
+  /**
+   * @brief Merge the samples of another accumulator into this one.
+   * The accumulators must have the same controls and targets, otherwise an
+   * InvalidInputException exception is thrown.
+   * @param other The other accumulator.
+   */
+  void merge(const ControlVariateAccumulator<dim_inp, dim_out>& other);
+
+  /// @brief Merge the samples of another accumulator into this one.
+  ControlVariateAccumulator<dim_inp, dim_out>& operator+=(const ControlVariateAccumulator<dim_inp, dim_out>& other);
+
+  /// @brief Return the highest power of the controls.
+  unsigned int degree() const;
+  /// @brief Return the highest order of the moments of the outputs.
+  unsigned int order() const;
+  /// @brief Return the number of accumulated samples.
+  std::uint64_t count() const;
+
+  /// @brief Return the fitted coefficients \f$ \beta \f$ (one column for each target).
+  Eigen::MatrixXd coefficients() const;
+
+  /// @brief Return the adjusted estimates of the expectations \f$ E[(y_j - s_j)^k] \f$ of the targets of order k.
+  Eigen::VectorXd raw(unsigned int k) const;
+
+  /// @brief Return the adjusted estimate of the mean of the outputs.
+  Eigen::VectorXd mean() const;
+  /// @brief Return the sample mean of the outputs, without control variates.
+  Eigen::VectorXd plain_mean() const;
+
+  /**
+   * @brief Return the variance reduction factors of the estimators of the targets of order k.
+   * The factor is the ratio of the variances of the targets and of their residuals after the regression.
+   * @param k The order of the targets (1 for the mean).
+   * @return Eigen::VectorXd The factor along each dimension of the outputs.
+   */
+  Eigen::VectorXd reduction(unsigned int k = 1) const;
+
+  /// @brief Return an accumulator which holds the adjusted moments (see MomentAccumulator::from_moments), empty without samples.
+  MomentAccumulator<dim_out> moments() const;
+
+private:
+  /// @brief Return the number of the controls.
+  unsigned int controls() const;
+
+  /**
+   * @brief Merge a set of samples given by its count, means, and centered cross products.
+   * @param count The number of samples.
+   * @param mean The means of the controls and of the targets.
+   * @param sums The centered cross products of the controls and of the targets.
+   */
+  void merge(std::uint64_t count, const Eigen::VectorXd& mean, const Eigen::MatrixXd& sums);
+
+  /// @brief The highest power of the controls.
+  unsigned int m_degree;
+  /// @brief The highest order of the targets.
+  unsigned int m_order;
+  /// @brief The number of samples.
+  std::uint64_t m_count;
+  /// @brief The mean of the inputs.
+  Eigen::Matrix<double, dim_inp, 1> m_center;
+  /// @brief The shift of the outputs.
+  Eigen::Matrix<double, dim_out, 1> m_shift;
+  /// @brief The expectations of the controls.
+  Eigen::VectorXd m_expectations;
+  /// @brief The means of the controls followed by the means of the targets.
+  Eigen::VectorXd m_mean;
+  /// @brief The centered cross products of the controls and of the targets.
+  Eigen::MatrixXd m_sums;
+  /// @brief The controls and the targets of the current block of samples (one column each).
+  Eigen::MatrixXd m_block;
+  /// @brief The means of the current block of samples.
+  Eigen::VectorXd m_block_mean;
+  /// @brief The centered cross products of the current block of samples.
+  Eigen::MatrixXd m_block_sums;
+  /// @brief The difference of the means of two merged sets of samples.
+  Eigen::VectorXd m_delta;
+};
+
+#include "control.tpp"
+
+#endif
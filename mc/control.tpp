@@ -0,0 +1,231 @@
+#include "control.hpp"
+
+#include <Eigen/Cholesky>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+template <unsigned int dim_inp, unsigned int dim_out>
+ControlVariateAccumulator<dim_inp, dim_out>::ControlVariateAccumulator()
+  : m_degree(0), m_order(0), m_count(0)
+{
+  m_center.setZero();
+  m_shift.setZero();
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+ControlVariateAccumulator<dim_inp, dim_out>::ControlVariateAccumulator(Distribution<dim_inp>& dist,
+  const Vector<dim_out>& shift, unsigned int degree, unsigned int order)
+  : m_degree(degree), m_order(order), m_count(0)
+{
+  if (degree == 0) {
+    throw InvalidInputException("The degree of the control variates must be positive.");
+  }
+  if (order < 2) {
+    throw InvalidInputException("The order of the control variates must be at least 2.");
+  }
+
+  // The expectations of the centered powers of the inputs
+  std::vector<std::vector<double>> central;
+  if (degree > 2 && !dist.central_moments(degree, central)) {
+    throw InvalidInputException("The central moments of the distribution are required for control variates of degree "
+      + std::to_string(degree) + ".");
+  }
+  const Vector<dim_inp> mean = dist.mean();
+  const Vector<dim_inp> var = dist.var();
+  m_expectations.setZero(controls());
+  for (unsigned int d = 0; d < dim_inp; ++d) {
+    m_center[d] = mean[d];
+    for (unsigned int p = 2; p <= degree; ++p) {
+      m_expectations[(p - 1) * dim_inp + d] = p == 2 ? var[d] : central[d][p];
+    }
+  }
+  for (unsigned int j = 0; j < dim_out; ++j) {
+    m_shift[j] = shift[j];
+  }
+
+  const unsigned int n_z = controls() + order * dim_out;
+  m_mean.setZero(n_z);
+  m_sums.setZero(n_z, n_z);
+  m_block.setZero(SAMPLE_BLOCK_SIZE, n_z);
+  m_block_mean.setZero(n_z);
+  m_block_sums.setZero(n_z, n_z);
+  m_delta.setZero(n_z);
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+unsigned int ControlVariateAccumulator<dim_inp, dim_out>::controls() const {
+  return m_degree * dim_inp;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+void ControlVariateAccumulator<dim_inp, dim_out>::add(const double* x, std::size_t ldx,
+  const double* y, std::size_t ldy, std::size_t n) {
+  const unsigned int n_c = controls();
+  for (std::size_t start = 0; start < n; start += SAMPLE_BLOCK_SIZE) {
+    const std::size_t m = std::min<std::size_t>(SAMPLE_BLOCK_SIZE, n - start);
+    auto block = m_block.topRows(m);
+
+    // The powers of the centered inputs and of the shifted outputs
+    for (unsigned int d = 0; d < dim_inp; ++d) {
+      const double* xd = x + d * ldx + start;
+      for (std::size_t i = 0; i < m; ++i) {
+        block(i, d) = xd[i] - m_center[d];
+      }
+      for (unsigned int p = 2; p <= m_degree; ++p) {
+        block.col((p - 1) * dim_inp + d) = block.col((p - 2) * dim_inp + d).cwiseProduct(block.col(d));
+      }
+    }
+    for (unsigned int j = 0; j < dim_out; ++j) {
+      const double* yj = y + j * ldy + start;
+      for (std::size_t i = 0; i < m; ++i) {
+        block(i, n_c + j) = yj[i] - m_shift[j];
+      }
+      for (unsigned int k = 2; k <= m_order; ++k) {
+        block.col(n_c + (k - 1) * dim_out + j) =
+          block.col(n_c + (k - 2) * dim_out + j).cwiseProduct(block.col(n_c + j));
+      }
+    }
+
+    // The cross products of the block are computed around the mean of the block and then merged
+    m_block_mean.noalias() = block.colwise().mean().transpose();
+    block.rowwise() -= m_block_mean.transpose();
+    m_block_sums.noalias() = block.transpose() * block;
+    merge(m, m_block_mean, m_block_sums);
+  }
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+void ControlVariateAccumulator<dim_inp, dim_out>::merge(std::uint64_t count,
+  const Eigen::VectorXd& mean, const Eigen::MatrixXd& sums) {
+  if (count == 0) {
+    return;
+  }
+  if (m_count == 0) {
+    m_count = count;
+    m_mean = mean;
+    m_sums = sums;
+    return;
+  }
+
+  // Pairwise update of the means and of the centered cross products
+  const double n_a = m_count;
+  const double n_b = count;
+  const double n = n_a + n_b;
+  m_delta = mean - m_mean;
+  m_sums += sums;
+  m_sums.noalias() += (n_a * n_b / n) * m_delta * m_delta.transpose();
+  m_mean += (n_b / n) * m_delta;
+  m_count += count;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+void ControlVariateAccumulator<dim_inp, dim_out>::merge(const ControlVariateAccumulator<dim_inp, dim_out>& other) {
+  if (other.m_degree != m_degree || other.m_order != m_order) {
+    throw InvalidInputException("The accumulators of control variates must have the same degree and order.");
+  }
+  merge(other.m_count, other.m_mean, other.m_sums);
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+ControlVariateAccumulator<dim_inp, dim_out>& ControlVariateAccumulator<dim_inp, dim_out>::operator+=(
+  const ControlVariateAccumulator<dim_inp, dim_out>& other) {
+  merge(other);
+  return *this;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+unsigned int ControlVariateAccumulator<dim_inp, dim_out>::degree() const {
+  return m_degree;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+unsigned int ControlVariateAccumulator<dim_inp, dim_out>::order() const {
+  return m_order;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+std::uint64_t ControlVariateAccumulator<dim_inp, dim_out>::count() const {
+  return m_count;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+Eigen::MatrixXd ControlVariateAccumulator<dim_inp, dim_out>::coefficients() const {
+  const unsigned int n_c = controls();
+  const unsigned int n_t = m_order * dim_out;
+  return m_sums.topLeftCorner(n_c, n_c).ldlt().solve(m_sums.topRightCorner(n_c, n_t));
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+Eigen::VectorXd ControlVariateAccumulator<dim_inp, dim_out>::raw(unsigned int k) const {
+  if (k == 0 || k > m_order) {
+    throw InvalidInputException("The order of the targets must be between 1 and " + std::to_string(m_order) + ".");
+  }
+  const unsigned int n_c = controls();
+  const Eigen::MatrixXd beta = coefficients().middleCols((k - 1) * dim_out, dim_out);
+  const Eigen::VectorXd error = m_mean.head(n_c) - m_expectations;
+  return m_mean.segment(n_c + (k - 1) * dim_out, dim_out) - beta.transpose() * error;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+Eigen::VectorXd ControlVariateAccumulator<dim_inp, dim_out>::mean() const {
+  return m_shift + raw(1);
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+Eigen::VectorXd ControlVariateAccumulator<dim_inp, dim_out>::plain_mean() const {
+  return m_shift + m_mean.segment(controls(), dim_out);
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+Eigen::VectorXd ControlVariateAccumulator<dim_inp, dim_out>::reduction(unsigned int k) const {
+  if (k == 0 || k > m_order) {
+    throw InvalidInputException("The order of the targets must be between 1 and " + std::to_string(m_order) + ".");
+  }
+  const unsigned int n_c = controls();
+  const Eigen::MatrixXd beta = coefficients();
+  Eigen::VectorXd factor(dim_out);
+  for (unsigned int j = 0; j < dim_out; ++j) {
+    // The residual variance is the variance of the target minus the part explained by the controls
+    const unsigned int c = (k - 1) * dim_out + j;
+    const double total = m_sums(n_c + c, n_c + c);
+    const double explained = m_sums.col(n_c + c).head(n_c).dot(beta.col(c));
+    factor[j] = total / std::max(total - explained, 0.);
+  }
+  return factor;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+MomentAccumulator<dim_out> ControlVariateAccumulator<dim_inp, dim_out>::moments() const {
+  // Without samples, there are no moments to report
+  if (m_count == 0) {
+    return MomentAccumulator<dim_out>(m_order);
+  }
+
+  // The adjusted moments of the shifted outputs, with a_0 = 1
+  Eigen::MatrixXd raws(m_order + 1, dim_out);
+  raws.row(0).setOnes();
+  for (unsigned int k = 1; k <= m_order; ++k) {
+    raws.row(k) = raw(k).transpose();
+  }
+
+  // Binomial expansion of E[((y - s) - (mu - s))^p]
+  Eigen::Matrix<double, Eigen::Dynamic, dim_out> central(m_order + 1, dim_out);
+  for (unsigned int j = 0; j < dim_out; ++j) {
+    const double offset = raws(1, j);
+    for (unsigned int p = 0; p <= m_order; ++p) {
+      double sum = 0.;
+      double binom = 1.;
+      for (unsigned int i = 0; i <= p; ++i) {
+        sum += binom * raws(i, j) * std::pow(-offset, p - i);
+        binom = binom * (p - i) / (i + 1);
+      }
+      central(p, j) = sum;
+    }
+    central(1, j) = 0.;
+  }
+  Eigen::Matrix<double, dim_out, 1> mean = m_shift + raws.row(1).transpose();
+  return MomentAccumulator<dim_out>::from_moments(mean, central);
+}
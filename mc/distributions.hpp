@@ -3,23 +3,45 @@
 
 #include "mathutils.hpp"
 #include "exceptions.hpp"
+#include "random.hpp"
 #include "vector.hpp"
+#include "parallel.hpp"
+#include "samples.hpp"
+#include "qmc.hpp"
 
-#include <cstdlib>
+#include <Eigen/Core>
+#include <Eigen/Cholesky>
+
+#include <cstdint>
+#include <cstddef>
 #include <vector>
 #include <memory>
-#include <ctime>
+#include <algorithm>
 
 
-#ifndef RAND_SEED
-/// @brief Seed for random number generation.
-#define RAND_SEED 42
+#ifndef SAMPLE_BLOCK_SIZE
+/// @brief Number of samples generated by one call of the batch kernels.
+#define SAMPLE_BLOCK_SIZE 256
 #endif
 
+/// @brief Memory layout of a buffer of samples.
+enum class Layout
+{
+  /// @brief Array of structures: the coordinates of each sample are contiguous.
+  AoS,
+  /// @brief Structure of arrays: each coordinate of all the samples is contiguous.
+  SoA
+};
+
 
 /**
  * @brief Abstract class for a distribution.
  * This class wraps the common members of a distribution.
+ * Each distribution owns a counter-based random number generator,
+ * so that distributions do not share any global state.
+ *
+ * The samples are obtained by transforming uniform numbers in (0, 1), which are either drawn from
+ * the generator or taken from a low-discrepancy sequence (quasi-Monte Carlo, see Distribution::set_sequence).
  * @tparam dim The dimension of the samples of the distribution.
  */
 template<unsigned int dim>
@@ -27,34 +49,165 @@ class Distribution
 {
 public:
   /// @brief Constructs a distribution object.
-  Distribution();
+  /// @param seed The seed of the random number generator.
+  Distribution(std::uint64_t seed = RAND_SEED);
 
   /// @brief Destroys the distribution object.
   virtual ~Distribution();
 
+  /// @brief Resets the random number generator to the beginning of a stream.
+  void seed(std::uint64_t seed, std::uint64_t stream = 0);
+
+  /// @brief Returns the random number generator of the distribution.
+  Philox& rng();
+  /// @brief Returns the random number generator of the distribution.
+  const Philox& rng() const;
+
   /**
    * @brief Generates n samples from the distribution.
    * The samples are drawn from each dimension one by one randomly.
    * @param n The number of the samples.
+   * @param threads The number of threads (the samples do not depend on it).
    * @return std::shared_ptr<std::vector<Vector<dim>>> A pointer to the generated samples.
    */
-  std::shared_ptr<std::vector<Vector<dim>>> samples(const int n = 1);
+  std::shared_ptr<std::vector<Vector<dim>>> samples(std::size_t n = 1, unsigned int threads = 1);
+
+  /**
+   * @brief Generates n samples from the distribution using another generator.
+   * This method does not modify the distribution, so several threads can call it
+   * at the same time with their own generators (e.g., from Philox::split).
+   * @param n The number of the samples.
+   * @param rng The random number generator.
+   * @return std::shared_ptr<std::vector<Vector<dim>>> A pointer to the generated samples.
+   */
+  std::shared_ptr<std::vector<Vector<dim>>> samples(std::size_t n, Philox& rng) const;
+
+  /**
+   * @brief Generates n samples from the distribution into a buffer.
+   * The samples are generated in blocks of SAMPLE_BLOCK_SIZE samples.
+   * The random numbers are consumed in the same order for both layouts.
+   * @param out Pointer to a buffer of at least `n * dim` doubles.
+   * @param n The number of the samples.
+   * @param layout The layout of the buffer. With Layout::SoA, coordinate `d`
+   * of sample `i` is stored at `out[d * n + i]`.
+   */
+  void samples(double* out, std::size_t n, Layout layout = Layout::AoS);
+
+  /**
+   * @brief Generates n samples from the distribution into a buffer using another generator.
+   * Since each sample consumes `dim` random numbers, the blocks of samples can be generated
+   * by several threads which jump ahead in copies of the generator. The samples are the same
+   * for any number of threads and the generator is advanced past all of them.
+   * @param out Pointer to a buffer of at least `n * dim` doubles.
+   * @param n The number of the samples.
+   * @param layout The layout of the buffer.
+   * @param rng The random number generator.
+   * @param threads The number of threads.
+   */
+  void samples(double* out, std::size_t n, Layout layout, Philox& rng, unsigned int threads = 1) const;
+
+  /**
+   * @brief Generates the samples of a block (see SampleBlock).
+   * The samples are the same as the ones of the other methods, and do not depend on the number of threads.
+   * @param block The block, whose size is the number of the samples.
+   * @param threads The number of threads.
+   */
+  void samples(SampleBlock<dim>& block, unsigned int threads = 1);
+
+  /// @brief Generates the samples of a block using another generator (see Distribution::samples).
+  void samples(SampleBlock<dim>& block, Philox& rng, unsigned int threads = 1) const;
+
+  /**
+   * @brief Uses the points of a low-discrepancy sequence instead of the random numbers.
+   * Sample i of a stream is obtained from the point i of the sequence, where i is the position of the
+   * generator divided by dim. Hence, the samples of the other methods are consecutive ranges of the
+   * sequence, which are generated in parallel by jumping ahead in the generator, and do not depend on
+   * the seed and on the stream of the generator, unless the sequence is randomized: the key of its
+   * randomization is drawn from the seed and the stream, so the streams give independent replicates
+   * (see Function::replicates). A null sequence restores the random numbers.
+   * @param sequence The sequence, whose dimension must be at least the dimension of the distribution.
+   */
+  void set_sequence(std::shared_ptr<const QuasiRandomSequence> sequence);
+
+  /// @brief Returns the low-discrepancy sequence of the distribution (null for random numbers).
+  std::shared_ptr<const QuasiRandomSequence> sequence() const;
+
+  /**
+   * @brief Returns the generator of the k-th chunk of samples of a generator.
+   * For random numbers, the chunks are drawn from independent substreams (see Philox::substream).
+   * For a low-discrepancy sequence, the k-th chunk is the k-th range of `chunk` points of the
+   * stream, so that the chunks cover the first points of the sequence.
+   * @param rng The generator.
+   * @param k The index of the chunk.
+   * @param chunk The number of samples of each chunk.
+   * @return Philox The generator of the chunk.
+   */
+  Philox substream(const Philox& rng, std::uint64_t k, std::size_t chunk) const;
 
   /// @brief Returns the mean of the distribution.
   virtual Vector<dim> mean() = 0;
   /// @brief Returns the variance of the distribution.
   virtual Vector<dim> var() = 0;
 
+  /**
+   * @brief Returns the exact central moments of the independent coordinates of the distribution.
+   * The default implementation returns false, i.e., the moments are not known in closed form
+   * (for example, when the coordinates are correlated).
+   * @param order The highest order of the moments.
+   * @param moments The central moments, where `moments[d][p]` is the p-th central moment of coordinate d.
+   * @return bool Whether the moments are known.
+   */
+  virtual bool central_moments(unsigned int order, std::vector<std::vector<double>>& moments);
+
+  /**
+   * @brief Evaluates the logarithm of the probability density function on a buffer of points.
+   * The points outside of the support have a density of zero (\f$ -\infty \f$).
+   * @param x Pointer to the points (coordinate `d` of point `i` is `x[d * ld + i]`).
+   * @param ld The leading dimension of the points.
+   * @param out Pointer to the log-densities of the points.
+   * @param n The number of the points.
+   */
+  virtual void log_density(const double* x, std::size_t ld, double* out, std::size_t n) const = 0;
+
+protected:
+  /**
+   * @brief Draws the uniform numbers of a block of samples, coordinate by coordinate.
+   * Coordinate `d` of sample `i` is written to `out[d * ld + i]`, and exactly `n * dim` numbers are
+   * consumed from the generator (the position of the generator is the index of the points of the sequence).
+   * @param out Pointer to the block.
+   * @param n The number of the samples in the block.
+   * @param ld The leading dimension of the block.
+   * @param rng The random number generator.
+   */
+  void uniforms(double* out, std::size_t n, std::size_t ld, Philox& rng) const;
+
 private:
   /**
-   * @brief Draws a random sample in the specified dimension.
+   * @brief Generates n samples into a buffer with a leading dimension, possibly in parallel.
+   * @param ld The distance between the coordinates of a sample with Layout::SoA.
+   */
+  void generate(double* out, std::size_t n, std::size_t ld, Layout layout, Philox& rng, unsigned int threads) const;
+
+  /// @brief Generates the samples with indices in [begin, end) of a buffer with a leading dimension.
+  void fill(double* out, std::size_t begin, std::size_t end, std::size_t ld, Layout layout, Philox& rng) const;
+
+  /**
+   * @brief Draws a block of random samples.
    * The parameters in each dimension might be different.
-   * This function draws a random sample by reading the parameters
-   * of the corresponding dimension.
-   * @param d The desired dimension of the sample.
-   * @return double An element of a random sample.
+   * Each coordinate of the block is stored contiguously: coordinate `d` of
+   * sample `i` is written to `out[d * ld + i]`.
+   * Implementations must consume exactly `n * dim` random numbers.
+   * @param out Pointer to the block.
+   * @param n The number of the samples in the block.
+   * @param ld The distance between the coordinates of a sample (leading dimension).
+   * @param rng The random number generator.
    */
-  virtual double sample_dim(const int d) = 0;
+  virtual void sample_block(double* out, std::size_t n, std::size_t ld, Philox& rng) const = 0;
+
+  /// @brief The random number generator.
+  Philox m_rng;
+  /// @brief The low-discrepancy sequence (null for random numbers).
+  std::shared_ptr<const QuasiRandomSequence> m_sequence;
 };
 
 /**
@@ -87,10 +240,14 @@ public:
   virtual Vector<dim> mean() override;
   /// @brief Returns the variance of the Uniform distribution.
   virtual Vector<dim> var() override;
+  /// @brief Returns the central moments \f$ h^p / (p + 1) \f$ (even p) of each coordinate, with \f$ h = (b - a) / 2 \f$.
+  virtual bool central_moments(unsigned int order, std::vector<std::vector<double>>& moments) override;
+  /// @brief Evaluates the log-density \f$ -\sum_d \log(b_d - a_d) \f$ inside of the bounds.
+  virtual void log_density(const double* x, std::size_t ld, double* out, std::size_t n) const override;
 
 private:
-  /// @brief Returns an element of a random sample from the uniform distribution.
-  double sample_dim(const int d) override;
+  /// @brief Draws a block of random samples from the uniform distribution.
+  void sample_block(double* out, std::size_t n, std::size_t ld, Philox& rng) const override;
 
   /// @brief The lower bounds.
   std::vector<double> m_lower;
@@ -100,6 +257,9 @@ private:
 
 /**
  * @brief Multidimensional normal distribution.
+ * The covariance matrix \f$ \Sigma \f$ is factorized once at construction as
+ * \f$ \Sigma = L L^T \f$ (Cholesky decomposition). Correlated samples are then obtained from
+ * independent standard normal samples \f$ z \f$ as \f$ x = \mu + L z \f$.
  * @tparam dim Dimension of the distribution.
  */
 template<unsigned int dim>
@@ -109,6 +269,8 @@ class Normal:
 public:
   /**
    * @brief Construct a new Normal object.
+   * The covariance matrix must be symmetric and positive definite,
+   * otherwise an InvalidArgumentException exception is thrown.
    * @param mean The mean value on each dimension.
    * @param covariance The covariance matrix of the normal distribution.
    */
@@ -139,26 +301,43 @@ public:
   virtual Vector<dim> mean() override;
   /// @return Returns the variance of the distribution.
   virtual Vector<dim> var() override;
+  /// @brief Returns the central moments \f$ (p - 1)!! \sigma^p \f$ (even p) if the covariance matrix is diagonal.
+  virtual bool central_moments(unsigned int order, std::vector<std::vector<double>>& moments) override;
+  /**
+   * @brief Evaluates the log-density with the Cholesky factor of the covariance matrix.
+   * The standardized points \f$ z = L^{-1} (x - \mu) \f$ are obtained by forward substitution, and
+   * \f$ \log p(x) = -\frac{1}{2} z^T z - \sum_d \log L_{dd} - \frac{d}{2} \log(2 \pi) \f$.
+   */
+  virtual void log_density(const double* x, std::size_t ld, double* out, std::size_t n) const override;
 
 private:
   /**
-   * @brief Returns an element of a random sample from the uniform distribution.
+   * @brief Draws a block of random samples from the normal distribution.
    * This is done by applying the inverse transform sampling method.
    * Assuming that \f$ z \sim N(0, 1) \f$ is a random sample from the standard normal distribution,
-   * a sample \f$ u \sim U([0, 1]) \f$ is randomly drawn from the unfiform distribution.
-   * \f$ z \f$ is then calculated by \f$ \sqrt{2} {erfinv}(2u-1) \f$, where \f$ {erfinv} \f$
-   * is the inverse error function. The return value is obtained by mapping \f$ z \f$ to the current
-   * normal distribution using the mean and the standard deviation of the desired dimension.
-   * @param d The dimension of the sample element.
-   * @return double the sample element.
+   * a sample \f$ u \sim U((0, 1)) \f$ is randomly drawn from the unfiform distribution.
+   * \f$ z \f$ is then calculated by \f$ \Phi^{-1}(u) \f$, where \f$ \Phi^{-1} \f$
+   * is the quantile function of the standard normal distribution. The samples are obtained by mapping
+   * the vectors \f$ z \f$ to the current normal distribution with the mean and the Cholesky factor
+   * of the covariance matrix. Since the factor is lower triangular, the block is transformed in place.
+   * @param out Pointer to the block.
+   * @param n The number of the samples in the block.
+   * @param ld The leading dimension of the block.
+   * @param rng The random number generator.
    */
-  double sample_dim(const int d) override;
+  void sample_block(double* out, std::size_t n, std::size_t ld, Philox& rng) const override;
 
   /// @brief The mean value of each dimension.
   std::vector<double> m_mean;
 
+  /// @brief Compute the Cholesky factor of the covariance matrix.
+  void factorize();
+
   /// @brief The covariane matrix.
   std::vector<std::vector<double>> m_covariance;
+
+  /// @brief The lower triangular Cholesky factor of the covariance matrix.
+  Eigen::Matrix<double, dim, dim> m_cholesky;
 };
 
 #include "distributions.tpp"
@@ -2,28 +2,165 @@
 
 
 template<unsigned int dim>
-Distribution<dim>::Distribution()
+Distribution<dim>::Distribution(std::uint64_t seed)
+  : m_rng(seed) {}
+
+template<unsigned int dim>
+Distribution<dim>::~Distribution() {}
+
+template<unsigned int dim>
+bool Distribution<dim>::central_moments(unsigned int, std::vector<std::vector<double>>&) {
+  return false;
+}
+
+template<unsigned int dim>
+void Distribution<dim>::seed(std::uint64_t seed, std::uint64_t stream)
 {
-  srand(RAND_SEED);
+  m_rng.seed(seed, stream);
 }
 
 template<unsigned int dim>
-Distribution<dim>::~Distribution() {}
+Philox& Distribution<dim>::rng()
+{
+  return m_rng;
+}
+
+template<unsigned int dim>
+const Philox& Distribution<dim>::rng() const
+{
+  return m_rng;
+}
+
+template<unsigned int dim>
+void Distribution<dim>::set_sequence(std::shared_ptr<const QuasiRandomSequence> sequence)
+{
+  if (sequence && sequence->dims() < dim) {
+    throw InvalidInputException("The dimension of the sequence must be at least " + std::to_string(dim) + ".");
+  }
+  m_sequence = sequence;
+}
+
+template<unsigned int dim>
+std::shared_ptr<const QuasiRandomSequence> Distribution<dim>::sequence() const
+{
+  return m_sequence;
+}
+
+template<unsigned int dim>
+Philox Distribution<dim>::substream(const Philox& rng, std::uint64_t k, std::size_t chunk) const
+{
+  if (!m_sequence) {
+    return rng.substream(k);
+  }
+  Philox local = rng;
+  local.discard(k * chunk * dim);
+  return local;
+}
 
 template<unsigned int dim>
-std::shared_ptr<std::vector<Vector<dim>>> Distribution<dim>::samples(const int n)
+void Distribution<dim>::uniforms(double* out, std::size_t n, std::size_t ld, Philox& rng) const
+{
+  if (!m_sequence) {
+    for (unsigned int d = 0; d < dim; d++) {
+      rng.uniform(out + d * ld, n);
+    }
+    return;
+  }
+  // The randomization only depends on the seed and on the stream of the generator
+  std::uint64_t key = m_sequence->randomized() ? Philox(rng.seed(), rng.stream()).next() : 0;
+  m_sequence->points(rng.position() / dim, n, out, ld, key);
+  rng.discard(n * dim);
+}
+
+template<unsigned int dim>
+std::shared_ptr<std::vector<Vector<dim>>> Distribution<dim>::samples(std::size_t n, unsigned int threads)
 {
   std::shared_ptr<std::vector<Vector<dim>>> samples (new std::vector<Vector<dim>>(n));
-  for (int i = 0; i < n; i++)
+  if (n > 0) {
+    this->samples(&(*samples)[0][0], n, Layout::AoS, m_rng, threads);
+  }
+  return samples;
+}
+
+template<unsigned int dim>
+std::shared_ptr<std::vector<Vector<dim>>> Distribution<dim>::samples(std::size_t n, Philox& rng) const
+{
+  static_assert(sizeof(Vector<dim>) == dim * sizeof(double), "Vector<dim> must be stored contiguously.");
+
+  std::shared_ptr<std::vector<Vector<dim>>> samples (new std::vector<Vector<dim>>(n));
+  if (n > 0) {
+    this->samples(&(*samples)[0][0], n, Layout::AoS, rng);
+  }
+  return samples;
+}
+
+template<unsigned int dim>
+void Distribution<dim>::samples(double* out, std::size_t n, Layout layout)
+{
+  samples(out, n, layout, m_rng);
+}
+
+template<unsigned int dim>
+void Distribution<dim>::samples(double* out, std::size_t n, Layout layout, Philox& rng, unsigned int threads) const
+{
+  generate(out, n, n, layout, rng, threads);
+}
+
+template<unsigned int dim>
+void Distribution<dim>::samples(SampleBlock<dim>& block, unsigned int threads)
+{
+  samples(block, m_rng, threads);
+}
+
+template<unsigned int dim>
+void Distribution<dim>::samples(SampleBlock<dim>& block, Philox& rng, unsigned int threads) const
+{
+  generate(block.data(), block.size(), block.ld(), Layout::SoA, rng, threads);
+}
+
+template<unsigned int dim>
+void Distribution<dim>::generate(double* out, std::size_t n, std::size_t ld, Layout layout, Philox& rng, unsigned int threads) const
+{
+  if (threads <= 1 || n <= SAMPLE_BLOCK_SIZE) {
+    fill(out, 0, n, ld, layout, rng);
+    return;
+  }
+
+  // Jump to the first block of each thread
+  parallel_for(n, threads, [&](unsigned int, std::uint64_t begin, std::uint64_t end) {
+    Philox local = rng;
+    local.discard(begin * dim);
+    fill(out, begin, end, ld, layout, local);
+  }, SAMPLE_BLOCK_SIZE);
+  rng.discard(n * dim);
+}
+
+template<unsigned int dim>
+void Distribution<dim>::fill(double* out, std::size_t begin, std::size_t end, std::size_t ld, Layout layout, Philox& rng) const
+{
+  double block[dim * SAMPLE_BLOCK_SIZE];
+
+  for (std::size_t start = begin; start < end; start += SAMPLE_BLOCK_SIZE)
   {
-    Vector<dim>& sample = (*samples)[i];
+    std::size_t m = std::min<std::size_t>(SAMPLE_BLOCK_SIZE, end - start);
+
+    // Write directly to the buffer
+    if (layout == Layout::SoA) {
+      sample_block(out + start, m, ld, rng);
+      continue;
+    }
 
-    for (int d = 0; d < dim; d++)
+    // Transpose the block to the buffer
+    sample_block(block, m, SAMPLE_BLOCK_SIZE, rng);
+    double* dst = out + start * dim;
+    for (std::size_t i = 0; i < m; i++)
     {
-      sample[d] = sample_dim(d);
+      for (unsigned int d = 0; d < dim; d++)
+      {
+        dst[i * dim + d] = block[d * SAMPLE_BLOCK_SIZE + i];
+      }
     }
   }
-  return samples;
 }
 
 template<unsigned int dim>
@@ -62,14 +199,19 @@ template<unsigned int dim>
 Uniform<dim>::~Uniform() {}
 
 template<unsigned int dim>
-double Uniform<dim>::sample_dim(const int d)
+void Uniform<dim>::sample_block(double* out, std::size_t n, std::size_t ld, Philox& rng) const
 {
-  if (d < 0 || d >= dim) {
-    std::string msg = "Dimension " + std::to_string(d) +
-    " is invakid for Distribution<" + std::to_string(dim) + ">.";
-    throw InvalidInputException(msg);
+  this->uniforms(out, n, ld, rng);
+  for (unsigned int d = 0; d < dim; d++)
+  {
+    double* x = out + d * ld;
+    const double lower = m_lower[d];
+    const double width = m_upper[d] - m_lower[d];
+    for (std::size_t i = 0; i < n; i++)
+    {
+      x[i] = lower + width * x[i];
+    }
   }
-  return m_lower[d] + (m_upper[d] - m_lower[d]) * (double)rand() / RAND_MAX;
 }
 
 template<unsigned int dim>
@@ -94,6 +236,45 @@ Vector<dim> Uniform<dim>::var()
   return var;
 }
 
+template<unsigned int dim>
+bool Uniform<dim>::central_moments(unsigned int order, std::vector<std::vector<double>>& moments)
+{
+  moments.assign(dim, std::vector<double>(order + 1, 0.));
+  for (unsigned int d = 0; d < dim; d++)
+  {
+    const double h = (m_upper[d] - m_lower[d]) / 2.0;
+    double power = 1.;
+    for (unsigned int p = 0; p <= order; p += 2)
+    {
+      moments[d][p] = power / (p + 1);
+      power *= h * h;
+    }
+  }
+  return true;
+}
+
+template<unsigned int dim>
+void Uniform<dim>::log_density(const double* x, std::size_t ld, double* out, std::size_t n) const
+{
+  double log_volume = 0.;
+  for (unsigned int d = 0; d < dim; d++)
+  {
+    log_volume += std::log(m_upper[d] - m_lower[d]);
+  }
+  for (std::size_t i = 0; i < n; i++)
+  {
+    out[i] = -log_volume;
+  }
+  for (unsigned int d = 0; d < dim; d++)
+  {
+    const double* xd = x + d * ld;
+    for (std::size_t i = 0; i < n; i++)
+    {
+      if (xd[i] < m_lower[d] || xd[i] > m_upper[d]) out[i] = -INFINITY;
+    }
+  }
+}
+
 template<unsigned int dim>
 Normal<dim>::Normal(std::vector<double>& mean, std::vector<std::vector<double>>& covariance):
   Distribution<dim>(),
@@ -115,6 +296,8 @@ Normal<dim>::Normal(std::vector<double>& mean, std::vector<std::vector<double>>&
       }
     }
   }
+
+  factorize();
 }
 
 template<unsigned int dim>
@@ -139,6 +322,8 @@ Normal<dim>::Normal(std::vector<double>& mean, std::vector<double>& variance):
   for (int d = 0; d < dim; d++) {
     m_covariance[d][d] = variance[d];
   }
+
+  factorize();
 }
 
 template<unsigned int dim>
@@ -157,6 +342,27 @@ Normal<dim>::Normal(const double& mean, const double& variance):
   {
     m_covariance[d][d] = variance;
   }
+
+  factorize();
+}
+
+template<unsigned int dim>
+void Normal<dim>::factorize()
+{
+  Eigen::Matrix<double, dim, dim> covariance;
+  for (unsigned int d1 = 0; d1 < dim; d1++)
+  {
+    for (unsigned int d2 = 0; d2 < dim; d2++)
+    {
+      covariance(d1, d2) = m_covariance[d1][d2];
+    }
+  }
+
+  Eigen::LLT<Eigen::Matrix<double, dim, dim>> llt(covariance);
+  if (llt.info() != Eigen::Success) {
+    throw InvalidArgumentException("The covariance matrix must be positive definite.");
+  }
+  m_cholesky = llt.matrixL();
 }
 
 template<unsigned int dim>
@@ -181,16 +387,108 @@ Vector<dim> Normal<dim>::var()
 }
 
 template<unsigned int dim>
-double Normal<dim>::sample_dim(const int d)
+bool Normal<dim>::central_moments(unsigned int order, std::vector<std::vector<double>>& moments)
 {
-  // Check that the dimension matches
-  if (d < 0 || d >= dim) {
-    std::string msg = "Dimension " + std::to_string(d) +
-    " is invakid for Distribution<" + std::to_string(dim) + ">.";
-    throw InvalidInputException(msg);
+  for (unsigned int i = 0; i < dim; i++)
+  {
+    for (unsigned int j = 0; j < dim; j++)
+    {
+      if (i != j && m_covariance[i][j] != 0.) return false;
+    }
+  }
+
+  moments.assign(dim, std::vector<double>(order + 1, 0.));
+  for (unsigned int d = 0; d < dim; d++)
+  {
+    // E[w^p] = (p - 1) sigma^2 E[w^(p-2)]
+    moments[d][0] = 1.;
+    for (unsigned int p = 2; p <= order; p += 2)
+    {
+      moments[d][p] = (p - 1) * m_covariance[d][d] * moments[d][p - 2];
+    }
   }
+  return true;
+}
 
-  double u = (double)rand() / RAND_MAX;
-  double z = sqrt(2.) * erfinv(2. * u - 1.);
-  return m_mean[d] + sqrt(m_covariance[d][d]) * z;
+template<unsigned int dim>
+void Normal<dim>::log_density(const double* x, std::size_t ld, double* out, std::size_t n) const
+{
+  double constant = 0.5 * dim * std::log(2. * M_PI);
+  for (unsigned int d = 0; d < dim; d++)
+  {
+    constant += std::log(m_cholesky(d, d));
+  }
+
+  double z[dim * SAMPLE_BLOCK_SIZE];
+  for (std::size_t start = 0; start < n; start += SAMPLE_BLOCK_SIZE)
+  {
+    const std::size_t m = std::min<std::size_t>(SAMPLE_BLOCK_SIZE, n - start);
+    double* y = out + start;
+    for (std::size_t i = 0; i < m; i++)
+    {
+      y[i] = -constant;
+    }
+
+    // Solve L z = x - mean by forward substitution, coordinate by coordinate
+    for (unsigned int d = 0; d < dim; d++)
+    {
+      double* zd = z + d * SAMPLE_BLOCK_SIZE;
+      const double* xd = x + d * ld + start;
+      for (std::size_t i = 0; i < m; i++)
+      {
+        zd[i] = xd[i] - m_mean[d];
+      }
+      for (unsigned int j = 0; j < d; j++)
+      {
+        const double l_dj = m_cholesky(d, j);
+        if (l_dj == 0.) continue;
+        const double* zj = z + j * SAMPLE_BLOCK_SIZE;
+        for (std::size_t i = 0; i < m; i++)
+        {
+          zd[i] -= l_dj * zj[i];
+        }
+      }
+      const double l_dd = m_cholesky(d, d);
+      for (std::size_t i = 0; i < m; i++)
+      {
+        zd[i] /= l_dd;
+        y[i] -= 0.5 * zd[i] * zd[i];
+      }
+    }
+  }
+}
+
+template<unsigned int dim>
+void Normal<dim>::sample_block(double* out, std::size_t n, std::size_t ld, Philox& rng) const
+{
+  // Draw independent standard normal samples
+  this->uniforms(out, n, ld, rng);
+  for (unsigned int d = 0; d < dim; d++)
+  {
+    double* z = out + d * ld;
+    normal_quantile(z, z, n);
+  }
+
+  // Apply x = mean + L z in place, starting from the last coordinate
+  // so that the coordinates z_j (j < d) are still available
+  for (int d = dim - 1; d >= 0; d--)
+  {
+    double* x = out + d * ld;
+    const double mean = m_mean[d];
+    const double l_dd = m_cholesky(d, d);
+    for (std::size_t i = 0; i < n; i++)
+    {
+      x[i] = mean + l_dd * x[i];
+    }
+    for (int j = 0; j < d; j++)
+    {
+      const double* z = out + j * ld;
+      const double l_dj = m_cholesky(d, j);
+      if (l_dj == 0.) continue;
+      for (std::size_t i = 0; i < n; i++)
+      {
+        x[i] += l_dj * z[i];
+      }
+    }
+  }
 }
@@ -0,0 +1,271 @@
+#ifndef MC_EXPRESSIONS_HPP
+#define MC_EXPRESSIONS_HPP
+
+#include "functions.hpp"
+#include "distributions.hpp"
+#include "vector.hpp"
+
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+
+/**
+ * @brief Base class of the expression templates of functions.
+ * An expression is a tree of arithmetic operations whose type is built at compile time, e.g.,
+ * `(expr(f) + expr(g)) * expr(h)` has the type
+ * `BinaryExpression<OperationMul, BinaryExpression<OperationSum, Operand, Operand>, Operand>`.
+ * The leaves are functions (see Operand) or constants (see Constant).
+ *
+ * An expression is evaluated on blocks of SAMPLE_BLOCK_SIZE inputs in two steps:
+ *
+ * - The function of each leaf is evaluated on the block into its own buffer (one virtual call per leaf).
+ * - The outputs are computed in a single loop over the block, in which the operations
+ *   of the whole tree are inlined. There are no virtual calls and no temporary vectors between the nodes.
+ *
+ * The nodes hold their operands by value and the leaves hold their functions by shared pointers,
+ * so the expressions can be copied and combined freely without dangling references.
+ *
+ * The derived classes provide the number of leaves `leaves` and the methods `evaluate`, `value`,
+ * and `functions` (see BinaryExpression).
+ *
+ * @tparam Derived The type of the expression.
+ * @tparam dim_inp The input dimension of the expression.
+ * @tparam dim_out The output dimension of the expression.
+ */
+template <typename Derived, unsigned int dim_inp, unsigned int dim_out>
+class Expression
+{
+public:
+  /// @brief The input dimension of the expression.
+  static constexpr unsigned int input_dim = dim_inp;
+  /// @brief The output dimension of the expression.
+  static constexpr unsigned int output_dim = dim_out;
+  /// @brief The size of the buffer of a leaf for one block of outputs.
+  static constexpr std::size_t block = dim_out * SAMPLE_BLOCK_SIZE;
+
+  /// @brief Return the derived expression.
+  const Derived& derived() const;
+
+  /// @brief Compute the output of the expression on an input.
+  Vector<dim_out> operator()(const Vector<dim_inp>& x) const;
+
+  /**
+   * @brief Compute the outputs of the expression on a block of inputs.
+   * The inputs and the outputs are stored coordinate by coordinate (see Layout::SoA).
+   * @param x Pointer to the inputs.
+   * @param ldx The leading dimension of the inputs.
+   * @param y Pointer to the outputs.
+   * @param ldy The leading dimension of the outputs.
+   * @param n The number of inputs.
+   */
+  void operator()(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const;
+
+  /**
+   * @brief Return the number of evaluations outside of the domain of the functions of the leaves.
+   * A function which appears in several leaves is only counted once.
+   */
+  std::uint64_t domain_errors() const;
+};
+
+/**
+ * @brief Leaf of an expression which evaluates a function.
+ * The function is shared with the other copies of the leaf and with the caller.
+ * @tparam dim_inp The input dimension of the function.
+ * @tparam dim_out The output dimension of the function.
+ */
+template <unsigned int dim_inp, unsigned int dim_out>
+class Operand : public Expression<Operand<dim_inp, dim_out>, dim_inp, dim_out>
+{
+public:
+  /// @brief The number of the leaves with a buffer.
+  static constexpr unsigned int leaves = 1;
+
+  /// @brief Construct a leaf from a shared function.
+  explicit Operand(std::shared_ptr<const Function<dim_inp, dim_out>> f);
+
+  /// @brief Evaluate the function on a block of at most SAMPLE_BLOCK_SIZE inputs into the buffer.
+  void evaluate(const double* x, std::size_t ldx, double* buffer, std::size_t n) const;
+
+  /// @brief Return coordinate d of output i from the buffer.
+  double value(const double* buffer, unsigned int d, std::size_t i) const;
+
+  /// @brief Append the function to a list.
+  void functions(std::vector<const Function<dim_inp, dim_out>*>& list) const;
+
+private:
+  /// @brief The function.
+  std::shared_ptr<const Function<dim_inp, dim_out>> m_f;
+};
+
+/**
+ * @brief Leaf of an expression with the same constant value on all coordinates.
+ * @tparam dim_inp The input dimension of the expression.
+ * @tparam dim_out The output dimension of the expression.
+ */
+template <unsigned int dim_inp, unsigned int dim_out>
+class Constant : public Expression<Constant<dim_inp, dim_out>, dim_inp, dim_out>
+{
+public:
+  /// @brief The number of the leaves with a buffer.
+  static constexpr unsigned int leaves = 0;
+
+  /// @brief Construct a constant leaf.
+  explicit Constant(double value);
+
+  /// @brief Do nothing, since the constant does not depend on the inputs.
+  void evaluate(const double* x, std::size_t ldx, double* buffer, std::size_t n) const;
+
+  /// @brief Return the constant.
+  double value(const double* buffer, unsigned int d, std::size_t i) const;
+
+  /// @brief Do nothing, since the leaf has no function.
+  void functions(std::vector<const Function<dim_inp, dim_out>*>& list) const;
+
+private:
+  /// @brief The constant value.
+  double m_value;
+};
+
+/**
+ * @brief Node of an expression which combines the outputs of two expressions coordinate by coordinate.
+ * The leaves of the left operand use the first buffers and the leaves of the right operand use the
+ * following ones, so the offsets of all the buffers are known at compile time.
+ * @tparam Op The operation (e.g., OperationSum).
+ * @tparam L The type of the left operand.
+ * @tparam R The type of the right operand.
+ */
+template <typename Op, typename L, typename R>
+class BinaryExpression : public Expression<BinaryExpression<Op, L, R>, L::input_dim, L::output_dim>
+{
+  static_assert(L::input_dim == R::input_dim, "The operands must have the same input dimension.");
+  static_assert(L::output_dim == R::output_dim, "The operands must have the same output dimension.");
+
+public:
+  /// @brief The number of the leaves with a buffer.
+  static constexpr unsigned int leaves = L::leaves + R::leaves;
+
+  /// @brief Construct a node from two operands.
+  BinaryExpression(const L& left, const R& right);
+
+  /**
+   * @brief Evaluate the functions of the leaves on a block of inputs.
+   * @param x Pointer to the inputs.
+   * @param ldx The leading dimension of the inputs.
+   * @param buffer Pointer to the buffers of the leaves (`leaves * block` doubles).
+   * @param n The number of inputs (at most SAMPLE_BLOCK_SIZE).
+   */
+  void evaluate(const double* x, std::size_t ldx, double* buffer, std::size_t n) const;
+
+  /// @brief Return coordinate d of output i from the buffers of the leaves.
+  double value(const double* buffer, unsigned int d, std::size_t i) const;
+
+  /// @brief Append the functions of the leaves to a list.
+  void functions(std::vector<const Function<L::input_dim, L::output_dim>*>& list) const;
+
+private:
+  /// @brief The left operand.
+  L m_left;
+  /// @brief The right operand.
+  R m_right;
+};
+
+/**
+ * @brief Function which evaluates an expression.
+ * This adapter makes the expressions usable wherever a Function is expected
+ * (e.g., Function::mca and Function::accumulate) with a single virtual call per block.
+ * @tparam E The type of the expression.
+ */
+template <typename E>
+class ExpressionFunction : public Function<E::input_dim, E::output_dim>
+{
+public:
+  /// @brief Construct a function from an expression.
+  ExpressionFunction(const E& expression);
+
+  /// @brief Copy an ExpressionFunction object.
+  ExpressionFunction(const ExpressionFunction<E>& f);
+
+  /// @brief Return the expression.
+  const E& expression() const;
+
+  /// @brief Return the number of evaluations outside of the domain of the functions of the expression.
+  std::uint64_t domain_errors() const override;
+
+private:
+  /// @brief Call the expression on an input.
+  Vector<E::output_dim> call(const Vector<E::input_dim>& x) const override;
+
+  /// @brief Call the expression on a block of inputs.
+  void call_batch(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const override;
+
+  /// @brief The expression.
+  E m_expression;
+};
+
+/**
+ * @brief Construct a leaf from a shared function.
+ * The function is not copied, so it can be modified (e.g., read from a file) by its owners.
+ * @param f The function.
+ */
+template <typename F>
+Operand<F::input_dim, F::output_dim> expr(std::shared_ptr<F> f);
+
+/**
+ * @brief Construct a leaf from a copy of a function.
+ * The copy is owned by the leaf (and by its copies), so the function can be a temporary.
+ * Combined functions (e.g., CombinedFunctionSum) still refer to their source functions.
+ * @param f The function.
+ */
+template <typename F, typename = std::enable_if_t<std::is_base_of_v<Function<F::input_dim, F::output_dim>, F>>>
+Operand<F::input_dim, F::output_dim> expr(const F& f);
+
+/// @brief Construct a function from an expression.
+template <typename E, unsigned int dim_inp, unsigned int dim_out>
+ExpressionFunction<E> make_function(const Expression<E, dim_inp, dim_out>& e);
+
+/// @brief Construct the sum of two expressions.
+template <typename L, typename R, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationSum, L, R> operator+(const Expression<L, dim_inp, dim_out>& l, const Expression<R, dim_inp, dim_out>& r);
+/// @brief Construct the difference of two expressions.
+template <typename L, typename R, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationSub, L, R> operator-(const Expression<L, dim_inp, dim_out>& l, const Expression<R, dim_inp, dim_out>& r);
+/// @brief Construct the product of two expressions.
+template <typename L, typename R, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationMul, L, R> operator*(const Expression<L, dim_inp, dim_out>& l, const Expression<R, dim_inp, dim_out>& r);
+/// @brief Construct the quotient of two expressions.
+template <typename L, typename R, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationDiv, L, R> operator/(const Expression<L, dim_inp, dim_out>& l, const Expression<R, dim_inp, dim_out>& r);
+
+/// @brief Construct the sum of an expression and a constant.
+template <typename L, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationSum, L, Constant<dim_inp, dim_out>> operator+(const Expression<L, dim_inp, dim_out>& l, double c);
+/// @brief Construct the difference of an expression and a constant.
+template <typename L, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationSub, L, Constant<dim_inp, dim_out>> operator-(const Expression<L, dim_inp, dim_out>& l, double c);
+/// @brief Construct the product of an expression and a constant.
+template <typename L, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationMul, L, Constant<dim_inp, dim_out>> operator*(const Expression<L, dim_inp, dim_out>& l, double c);
+/// @brief Construct the quotient of an expression and a constant.
+template <typename L, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationDiv, L, Constant<dim_inp, dim_out>> operator/(const Expression<L, dim_inp, dim_out>& l, double c);
+
+/// @brief Construct the sum of a constant and an expression.
+template <typename R, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationSum, Constant<dim_inp, dim_out>, R> operator+(double c, const Expression<R, dim_inp, dim_out>& r);
+/// @brief Construct the difference of a constant and an expression.
+template <typename R, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationSub, Constant<dim_inp, dim_out>, R> operator-(double c, const Expression<R, dim_inp, dim_out>& r);
+/// @brief Construct the product of a constant and an expression.
+template <typename R, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationMul, Constant<dim_inp, dim_out>, R> operator*(double c, const Expression<R, dim_inp, dim_out>& r);
+/// @brief Construct the quotient of a constant and an expression.
+template <typename R, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationDiv, Constant<dim_inp, dim_out>, R> operator/(double c, const Expression<R, dim_inp, dim_out>& r);
+
+#include "expressions.tpp"
+
+#endif
@@ -0,0 +1,209 @@
+#include "expressions.hpp"
+
+
+template <typename Derived, unsigned int dim_inp, unsigned int dim_out>
+const Derived& Expression<Derived, dim_inp, dim_out>::derived() const {
+  return static_cast<const Derived&>(*this);
+}
+
+template <typename Derived, unsigned int dim_inp, unsigned int dim_out>
+Vector<dim_out> Expression<Derived, dim_inp, dim_out>::operator()(const Vector<dim_inp>& x) const {
+  Vector<dim_out> y;
+  (*this)(&x[0], 1, &y[0], 1, 1);
+  return y;
+}
+
+template <typename Derived, unsigned int dim_inp, unsigned int dim_out>
+void Expression<Derived, dim_inp, dim_out>::operator()(
+  const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const {
+  const Derived& e = derived();
+  double buffer[std::max(Derived::leaves, 1u) * block];
+
+  for (std::size_t start = 0; start < n; start += SAMPLE_BLOCK_SIZE) {
+    std::size_t m = std::min<std::size_t>(SAMPLE_BLOCK_SIZE, n - start);
+    e.evaluate(x + start, ldx, buffer, m);
+    for (unsigned int d = 0; d < dim_out; ++d) {
+      double* out = y + d * ldy + start;
+      for (std::size_t i = 0; i < m; ++i) {
+        out[i] = e.value(buffer, d, i);
+      }
+    }
+  }
+}
+
+template <typename Derived, unsigned int dim_inp, unsigned int dim_out>
+std::uint64_t Expression<Derived, dim_inp, dim_out>::domain_errors() const {
+  std::vector<const Function<dim_inp, dim_out>*> list;
+  derived().functions(list);
+  std::sort(list.begin(), list.end());
+  list.erase(std::unique(list.begin(), list.end()), list.end());
+
+  std::uint64_t errors = 0;
+  for (const Function<dim_inp, dim_out>* f : list) {
+    errors += f->domain_errors();
+  }
+  return errors;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+Operand<dim_inp, dim_out>::Operand(std::shared_ptr<const Function<dim_inp, dim_out>> f)
+  : m_f(f)
+{
+  if (!m_f) {
+    throw InvalidInputException("The function of an operand must not be null.");
+  }
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+void Operand<dim_inp, dim_out>::evaluate(const double* x, std::size_t ldx, double* buffer, std::size_t n) const {
+  (*m_f)(x, ldx, buffer, SAMPLE_BLOCK_SIZE, n);
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+double Operand<dim_inp, dim_out>::value(const double* buffer, unsigned int d, std::size_t i) const {
+  return buffer[d * SAMPLE_BLOCK_SIZE + i];
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+void Operand<dim_inp, dim_out>::functions(std::vector<const Function<dim_inp, dim_out>*>& list) const {
+  list.push_back(m_f.get());
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+Constant<dim_inp, dim_out>::Constant(double value)
+  : m_value(value) {}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+void Constant<dim_inp, dim_out>::evaluate(const double*, std::size_t, double*, std::size_t) const {}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+double Constant<dim_inp, dim_out>::value(const double*, unsigned int, std::size_t) const {
+  return m_value;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+void Constant<dim_inp, dim_out>::functions(std::vector<const Function<dim_inp, dim_out>*>&) const {}
+
+template <typename Op, typename L, typename R>
+BinaryExpression<Op, L, R>::BinaryExpression(const L& left, const R& right)
+  : m_left(left), m_right(right) {}
+
+template <typename Op, typename L, typename R>
+void BinaryExpression<Op, L, R>::evaluate(const double* x, std::size_t ldx, double* buffer, std::size_t n) const {
+  m_left.evaluate(x, ldx, buffer, n);
+  m_right.evaluate(x, ldx, buffer + L::leaves * L::block, n);
+}
+
+template <typename Op, typename L, typename R>
+double BinaryExpression<Op, L, R>::value(const double* buffer, unsigned int d, std::size_t i) const {
+  return Op::apply(m_left.value(buffer, d, i), m_right.value(buffer + L::leaves * L::block, d, i));
+}
+
+template <typename Op, typename L, typename R>
+void BinaryExpression<Op, L, R>::functions(std::vector<const Function<L::input_dim, L::output_dim>*>& list) const {
+  m_left.functions(list);
+  m_right.functions(list);
+}
+
+template <typename E>
+ExpressionFunction<E>::ExpressionFunction(const E& expression)
+  : Function<E::input_dim, E::output_dim>(), m_expression(expression) {}
+
+template <typename E>
+ExpressionFunction<E>::ExpressionFunction(const ExpressionFunction<E>& f)
+  : Function<E::input_dim, E::output_dim>(), m_expression(f.m_expression) {}
+
+template <typename E>
+const E& ExpressionFunction<E>::expression() const {
+  return m_expression;
+}
+
+template <typename E>
+std::uint64_t ExpressionFunction<E>::domain_errors() const {
+  return Function<E::input_dim, E::output_dim>::domain_errors() + m_expression.domain_errors();
+}
+
+template <typename E>
+Vector<E::output_dim> ExpressionFunction<E>::call(const Vector<E::input_dim>& x) const {
+  return m_expression(x);
+}
+
+template <typename E>
+void ExpressionFunction<E>::call_batch(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const {
+  m_expression(x, ldx, y, ldy, n);
+}
+
+template <typename F>
+Operand<F::input_dim, F::output_dim> expr(std::shared_ptr<F> f) {
+  return Operand<F::input_dim, F::output_dim>(f);
+}
+
+template <typename F, typename>
+Operand<F::input_dim, F::output_dim> expr(const F& f) {
+  return Operand<F::input_dim, F::output_dim>(std::make_shared<const F>(f));
+}
+
+template <typename E, unsigned int dim_inp, unsigned int dim_out>
+ExpressionFunction<E> make_function(const Expression<E, dim_inp, dim_out>& e) {
+  return ExpressionFunction<E>(e.derived());
+}
+
+template <typename L, typename R, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationSum, L, R> operator+(const Expression<L, dim_inp, dim_out>& l, const Expression<R, dim_inp, dim_out>& r) {
+  return BinaryExpression<OperationSum, L, R>(l.derived(), r.derived());
+}
+
+template <typename L, typename R, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationSub, L, R> operator-(const Expression<L, dim_inp, dim_out>& l, const Expression<R, dim_inp, dim_out>& r) {
+  return BinaryExpression<OperationSub, L, R>(l.derived(), r.derived());
+}
+
+template <typename L, typename R, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationMul, L, R> operator*(const Expression<L, dim_inp, dim_out>& l, const Expression<R, dim_inp, dim_out>& r) {
+  return BinaryExpression<OperationMul, L, R>(l.derived(), r.derived());
+}
+
+template <typename L, typename R, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationDiv, L, R> operator/(const Expression<L, dim_inp, dim_out>& l, const Expression<R, dim_inp, dim_out>& r) {
+  return BinaryExpression<OperationDiv, L, R>(l.derived(), r.derived());
+}
+
+template <typename L, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationSum, L, Constant<dim_inp, dim_out>> operator+(const Expression<L, dim_inp, dim_out>& l, double c) {
+  return BinaryExpression<OperationSum, L, Constant<dim_inp, dim_out>>(l.derived(), Constant<dim_inp, dim_out>(c));
+}
+
+template <typename L, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationSub, L, Constant<dim_inp, dim_out>> operator-(const Expression<L, dim_inp, dim_out>& l, double c) {
+  return BinaryExpression<OperationSub, L, Constant<dim_inp, dim_out>>(l.derived(), Constant<dim_inp, dim_out>(c));
+}
+
+template <typename L, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationMul, L, Constant<dim_inp, dim_out>> operator*(const Expression<L, dim_inp, dim_out>& l, double c) {
+  return BinaryExpression<OperationMul, L, Constant<dim_inp, dim_out>>(l.derived(), Constant<dim_inp, dim_out>(c));
+}
+
+template <typename L, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationDiv, L, Constant<dim_inp, dim_out>> operator/(const Expression<L, dim_inp, dim_out>& l, double c) {
+  return BinaryExpression<OperationDiv, L, Constant<dim_inp, dim_out>>(l.derived(), Constant<dim_inp, dim_out>(c));
+}
+
+template <typename R, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationSum, Constant<dim_inp, dim_out>, R> operator+(double c, const Expression<R, dim_inp, dim_out>& r) {
+  return BinaryExpression<OperationSum, Constant<dim_inp, dim_out>, R>(Constant<dim_inp, dim_out>(c), r.derived());
+}
+
+template <typename R, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationSub, Constant<dim_inp, dim_out>, R> operator-(double c, const Expression<R, dim_inp, dim_out>& r) {
+  return BinaryExpression<OperationSub, Constant<dim_inp, dim_out>, R>(Constant<dim_inp, dim_out>(c), r.derived());
+}
+
+template <typename R, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationMul, Constant<dim_inp, dim_out>, R> operator*(double c, const Expression<R, dim_inp, dim_out>& r) {
+  return BinaryExpression<OperationMul, Constant<dim_inp, dim_out>, R>(Constant<dim_inp, dim_out>(c), r.derived());
+}
+
+template <typename R, unsigned int dim_inp, unsigned int dim_out>
+BinaryExpression<OperationDiv, Constant<dim_inp, dim_out>, R> operator/(double c, const Expression<R, dim_inp, dim_out>& r) {
+  return BinaryExpression<OperationDiv, Constant<dim_inp, dim_out>, R>(Constant<dim_inp, dim_out>(c), r.derived());
+}
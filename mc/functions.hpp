@@ -2,19 +2,25 @@
 #define MC_FUNCTIONS_HPP
 
 #include "mca.hpp"
+#include "control.hpp"
 #include "distributions.hpp"
 #include "vector.hpp"
 #include "exceptions.hpp"
+#include "parallel.hpp"
 
 #include <Eigen/Core>
 
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
 #include <cmath>
 #include <fstream>
 #include <iostream>
 
+template <unsigned int dim_inp, unsigned int dim_out> class CombinedFunction;
 template <unsigned int dim_inp, unsigned int dim_out> class CombinedFunctionSum;
 template <unsigned int dim_inp, unsigned int dim_out> class CombinedFunctionSub;
 template <unsigned int dim_inp, unsigned int dim_out> class CombinedFunctionMul;
@@ -38,6 +44,11 @@ template <unsigned int dim_inp, unsigned int dim_out>
 class Function
 {
 public:
+  /// @brief The input dimension of the function.
+  static constexpr unsigned int input_dim = dim_inp;
+  /// @brief The output dimension of the function.
+  static constexpr unsigned int output_dim = dim_out;
+
   /// @brief Construct a new Function object.
   Function();
 
@@ -57,6 +68,26 @@ public:
   /// @return A pointer to the outputs.
   std::shared_ptr<std::vector<Vector<dim_out>>> operator()(std::shared_ptr<std::vector<Vector<dim_inp>>> x);
 
+  /**
+   * @brief Compute the outputs of the function on a block of samples (see SampleBlock).
+   * The batch kernel of the function reads the contiguous columns of the inputs.
+   * @param x The inputs.
+   * @return SampleBlock<dim_out> The outputs.
+   */
+  SampleBlock<dim_out> operator()(const SampleBlock<dim_inp>& x) const;
+
+  /**
+   * @brief Compute the outputs of the function on a block of inputs.
+   * The inputs and the outputs are stored coordinate by coordinate (see Layout::SoA):
+   * coordinate `d` of input `i` is `x[d * ldx + i]` and coordinate `d` of output `i` is `y[d * ldy + i]`.
+   * @param x Pointer to the inputs.
+   * @param ldx The distance between the coordinates of an input (leading dimension).
+   * @param y Pointer to the outputs.
+   * @param ldy The distance between the coordinates of an output (leading dimension).
+   * @param n The number of inputs.
+   */
+  void operator()(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const;
+
   /// @brief Construct a combined function from the present function an another one by summing their outputs.
   CombinedFunctionSum<dim_inp, dim_out> operator+(const Function<dim_inp, dim_out>&) const;
   /// @brief Construct a combined function from the present function an another one by subtracting their outputs.
@@ -74,18 +105,188 @@ public:
    * These samples are then used to build a Monte Carlo Approximator object which can be used to
    * calculate approximations about the distribution of the function samples.
    *
+   * The input and output samples are stored in blocks (see SampleBlock), and the function
+   * is evaluated on the contiguous columns of the inputs. The blocks are leased from the shared
+   * pool (see BufferPool), so the input block and the output block of the approximator are recycled
+   * by the next estimates once they are released.
+   * With several threads, the samples are generated, evaluated, and accumulated by contiguous parts
+   * and the partial accumulators are merged in order. The samples do not depend on the number of threads.
+   *
    * @param n The number of the function samples to generate.
    * @param dist The source distribution.
+   * @param threads The number of threads.
    * @return std::unique_ptr<MonteCarloApproximator<dim_out>> The Monte Carlo approximator.
    */
-  MonteCarloApproximator<dim_out> mca(unsigned int n, Distribution<dim_inp>& dist);
+  MonteCarloApproximator<dim_out> mca(std::uint64_t n, Distribution<dim_inp>& dist, unsigned int threads = 1);
+
+  /**
+   * @brief Create a Monte Carlo approximator with importance sampling.
+   * The samples are drawn from the proposal distribution \f$ q \f$ and weighted by the likelihood
+   * ratios \f$ w = p(x) / q(x) \f$ with the target distribution \f$ p \f$, computed from the
+   * log-densities (see Distribution::log_density). The moments of the approximator are the weighted
+   * (self-normalized) moments of the outputs, which estimate the moments under the target distribution
+   * as long as the proposal covers its support. A proposal with more mass in the regions which dominate
+   * the moments (e.g., wider tails for the higher moments) reduces their variance, and the effective
+   * number of samples (see MomentAccumulator::ess) shows the cost of the mismatch of the distributions.
+   * The samples are generated as in Function::mca, and the generator of the proposal is advanced.
+   *
+   * @param n The number of the function samples to generate.
+   * @param proposal The distribution of the samples.
+   * @param target The distribution of the moments.
+   * @param threads The number of threads.
+   * @return MonteCarloApproximator<dim_out> The Monte Carlo approximator, with the weights of the samples.
+   */
+  MonteCarloApproximator<dim_out> mca(std::uint64_t n, Distribution<dim_inp>& proposal,
+    const Distribution<dim_inp>& target, unsigned int threads = 1);
+
+  /**
+   * @brief Accumulate the moments of the function outputs without storing the samples.
+   * The n samples are generated, evaluated, and accumulated in chunks, so the memory usage only
+   * depends on the chunk size. The k-th chunk is drawn from the k-th substream of the generator of
+   * the distribution (see Distribution::substream), hence the result only depends on the seed and the
+   * stream of the distribution and on the chunk size. The generator of the distribution is not advanced.
+   *
+   * With several threads, each thread processes a contiguous range of chunks with its own buffers and
+   * partial accumulator, and the partial accumulators are merged in order. The result is deterministic
+   * for a given number of threads, and only differs by rounding errors between different numbers of threads.
+   *
+   * @param n The number of the function samples to generate.
+   * @param dist The source distribution.
+   * @param chunk The number of samples in each chunk.
+   * @param order The highest order of the accumulated moments.
+   * @param threads The number of threads.
+   * @return MomentAccumulator<dim_out> The accumulated moments of the function samples.
+   */
+  MomentAccumulator<dim_out> accumulate(std::uint64_t n, const Distribution<dim_inp>& dist,
+    std::size_t chunk = MCA_CHUNK_SIZE, unsigned int order = MCA_DEFAULT_ORDER, unsigned int threads = 1) const;
+
+  /**
+   * @brief Accumulate the moments of independent replicates of the function outputs.
+   * Replicate r accumulates n samples in chunks as Function::accumulate, from the stream \f$ s + r \f$
+   * of the generator of the distribution, where \f$ s \f$ is the stream of the generator. Hence, the
+   * first replicate is the same as Function::accumulate. When the distribution uses a randomized
+   * low-discrepancy sequence (see QuasiRandomSequence), each replicate has its own randomization
+   * (randomized quasi-Monte Carlo), and the spread of the replicates gives the error of their estimates.
+   *
+   * The chunks of all the replicates are processed in parallel (see Function::for_each_replicate_chunk).
+   *
+   * @param n The number of the function samples of each replicate.
+   * @param dist The source distribution.
+   * @param count The number of replicates.
+   * @param chunk The number of samples in each chunk.
+   * @param order The highest order of the accumulated moments.
+   * @param threads The number of threads.
+   * @return std::vector<MomentAccumulator<dim_out>> The accumulated moments of each replicate.
+   */
+  std::vector<MomentAccumulator<dim_out>> replicate(std::uint64_t n, const Distribution<dim_inp>& dist, unsigned int count,
+    std::size_t chunk = MCA_CHUNK_SIZE, unsigned int order = MCA_DEFAULT_ORDER, unsigned int threads = 1) const;
+
+  /**
+   * @brief Accumulate the moments of the function outputs with antithetic variates.
+   * Each sample \f$ x \f$ is paired with its reflection \f$ 2 \mu - x \f$ around the mean of the
+   * distribution, which has the same distribution when the distribution is symmetric about its mean
+   * (as Uniform and Normal). Both outputs of each pair are accumulated, so the moments are estimated
+   * from all the evaluations and the mean is the mean of the pair means. For monotone functions, the
+   * outputs of a pair are negatively correlated, and the mean is more accurate than with independent samples.
+   *
+   * The means of the pairs are accumulated separately, so that the variance reduction factor
+   * \f$ Var(f(X)) / (2 Var((f(X) + f(2 \mu - X)) / 2)) \f$ can be calculated from both accumulators
+   * (the factor 2 accounts for the two evaluations of each pair).
+   * The base samples are drawn in chunks of pairs as in Function::accumulate.
+   *
+   * @param n The number of the function evaluations (rounded up to an even number).
+   * @param dist The source distribution, which must be symmetric about its mean.
+   * @param pairs The accumulator of the means of the pairs (second order).
+   * @param chunk The number of pairs in each chunk.
+   * @param order The highest order of the accumulated moments.
+   * @param threads The number of threads.
+   * @return MomentAccumulator<dim_out> The accumulated moments of the function outputs.
+   */
+  MomentAccumulator<dim_out> antithetic(std::uint64_t n, Distribution<dim_inp>& dist, MomentAccumulator<dim_out>& pairs,
+    std::size_t chunk = MCA_CHUNK_SIZE, unsigned int order = MCA_DEFAULT_ORDER, unsigned int threads = 1) const;
+
+  /**
+   * @brief Accumulate the moments of the function outputs with control variates.
+   * The samples are drawn and evaluated in chunks as in Function::accumulate, and the powers of the
+   * centered inputs are used as controls with known expectations (see ControlVariateAccumulator).
+   * The outputs are shifted by the output at the mean of the distribution (or by zero where it is not finite).
+   * @param n The number of the function samples to generate.
+   * @param dist The source distribution.
+   * @param degree The highest power of the controls.
+   * @param chunk The number of samples in each chunk.
+   * @param order The highest order of the accumulated moments.
+   * @param threads The number of threads.
+   * @return ControlVariateAccumulator<dim_inp, dim_out> The accumulated controls and outputs.
+   */
+  ControlVariateAccumulator<dim_inp, dim_out> control(std::uint64_t n, Distribution<dim_inp>& dist, unsigned int degree = 1,
+    std::size_t chunk = MCA_CHUNK_SIZE, unsigned int order = MCA_DEFAULT_ORDER, unsigned int threads = 1) const;
+
+  /**
+   * @brief Evaluate the function on n samples in chunks and pass the outputs of each chunk to a task.
+   * The k-th chunk is drawn from dist.substream(rng, k, chunk). With several threads, each thread
+   * processes a contiguous range of chunks (see parallel_for) with its own buffers of at most `chunk`
+   * samples, which are leased from the shared pool (see BufferPool).
+   * The task must only modify the state of its thread.
+   *
+   * @tparam Task The type of the task.
+   * @param n The number of the function samples to generate.
+   * @param dist The source distribution.
+   * @param rng The generator of the substreams.
+   * @param chunk The number of samples in each chunk.
+   * @param threads The number of threads.
+   * @param task The task, called as task(unsigned int t, const double* inputs, const double* outputs, std::size_t m)
+   * where t is the index of the thread and m is the number of samples in the chunk. The inputs and
+   * the outputs are stored coordinate by coordinate (see Layout::SoA).
+   */
+  template <typename Task>
+  void for_each_chunk(std::uint64_t n, const Distribution<dim_inp>& dist, const Philox& rng,
+    std::size_t chunk, unsigned int threads, const Task& task) const;
+
+  /**
+   * @brief Evaluate the function on n samples in chunks for several replicates and pass the outputs to a task.
+   * Replicate r is drawn from the stream `rng.stream() + r` at the position of rng (replicate 0 is drawn
+   * from rng), and is processed as Function::for_each_chunk. The chunks of all the replicates are split
+   * between the threads, so that small replicates are also processed in parallel.
+   *
+   * @tparam Task The type of the task.
+   * @param n The number of the function samples of each replicate.
+   * @param dist The source distribution.
+   * @param rng The generator of the first replicate.
+   * @param count The number of replicates.
+   * @param chunk The number of samples in each chunk.
+   * @param threads The number of threads.
+   * @param task The task, called as task(unsigned int t, unsigned int r, const double* inputs, const double* outputs, std::size_t m)
+   * where r is the index of the replicate (see Function::for_each_chunk).
+   */
+  template <typename Task>
+  void for_each_replicate_chunk(std::uint64_t n, const Distribution<dim_inp>& dist, const Philox& rng,
+    unsigned int count, std::size_t chunk, unsigned int threads, const Task& task) const;
+
+  /**
+   * @brief Return the number of evaluations outside of the domain of the function.
+   * For example, logarithms of non-positive values and overflowing exponentials give
+   * non-finite outputs. These evaluations are counted (also across threads) instead of
+   * being printed, so that they can be reported with the approximations.
+   */
+  virtual std::uint64_t domain_errors() const;
+
+  /**
+   * @brief Return the coefficients of the function if it is a separable polynomial.
+   * A separable polynomial is a sum of univariate polynomials of each coordinate of the input,
+   * \f$ f_j(u) = \sum_d \sum_k c_{j,d,k} u_d^k \f$, so its moments can be computed exactly from
+   * the moments of the inputs (see analytic_moments). The default implementation returns false.
+   * @param coeffs The coefficients, where `coeffs[j][d][k]` is the coefficient \f$ c_{j,d,k} \f$.
+   * @return bool Whether the function is a separable polynomial.
+   */
+  virtual bool separable_polynomial(std::vector<std::vector<std::vector<double>>>& coeffs) const;
 
   /// @brief Return the approximated mean value of the function using n samples from a given distribution.
-  Vector<dim_out> mean(unsigned int n, Distribution<dim_inp>& dist);
+  Vector<dim_out> mean(std::uint64_t n, Distribution<dim_inp>& dist);
   /// @brief Return the approximated variance of the function using n samples from a given distribution.
-  Vector<dim_out> var(unsigned int n, Distribution<dim_inp>& dist);
+  Vector<dim_out> var(std::uint64_t n, Distribution<dim_inp>& dist);
 
 protected:
+  friend CombinedFunction<dim_inp, dim_out>;
   friend CombinedFunctionSum<dim_inp, dim_out>;
   friend CombinedFunctionSub<dim_inp, dim_out>;
   friend CombinedFunctionMul<dim_inp, dim_out>;
@@ -93,9 +294,38 @@ protected:
 
   /// @brief Call the function on an input and return its output.
   virtual Vector<dim_out> call(const Vector<dim_inp>& x) const = 0;
+
+  /**
+   * @brief Call the function on a block of inputs stored coordinate by coordinate.
+   * The default implementation calls the function on each input. The derived classes override it
+   * with loops over the inputs which can be vectorized by the compiler.
+   */
+  virtual void call_batch(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const;
+
+  /// @brief Add evaluations outside of the domain of the function to the counter.
+  void count_domain_errors(std::uint64_t n) const;
+
+  /**
+   * @brief Remove evaluations outside of the domain of the function from the counter.
+   * The errors of combined functions are counted by their operands, so the counter of this function may
+   * wrap around, but the total returned by domain_errors is exact (modulo \f$ 2^{64} \f$).
+   */
+  void discount_domain_errors(std::uint64_t n) const;
+
+private:
+  /// @brief Call the function on an array of inputs by transposing them in blocks.
+  void call_vectors(const Vector<dim_inp>* x, Vector<dim_out>* y, std::size_t n) const;
+
+  /// @brief The number of evaluations outside of the domain of the function.
+  mutable std::atomic<std::uint64_t> m_domain_errors;
 };
 
-/// @brief Base class for combining two functions by aggregating their outputs.
+/**
+ * @brief Base class for combining two functions by aggregating their outputs.
+ * The source functions are referenced, so they must outlive the combined function.
+ * For combinations of temporaries, or for fusing the evaluation of nested combinations,
+ * see the expression templates (e.g., `expr(f) + expr(g)` in expressions.hpp).
+ */
 template <unsigned int dim_inp, unsigned int dim_out>
 class CombinedFunction : public Function<dim_inp, dim_out>
 {
@@ -106,7 +336,25 @@ public:
   /// @brief Copy a CombinedFunction object.
   CombinedFunction(const CombinedFunction<dim_inp, dim_out>& f);
 
+  /// @brief Return the number of evaluations outside of the domain of the source functions.
+  std::uint64_t domain_errors() const override;
+
 protected:
+  /**
+   * @brief Call the source functions on a block of inputs and aggregate their outputs.
+   * The outputs of the second function are computed in a buffer of SAMPLE_BLOCK_SIZE samples.
+   * @param op The aggregation, which updates the output of the first function with the output of the second one.
+   */
+  template <typename Op>
+  void combine_batch(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n, const Op& op) const;
+
+  /**
+   * @brief Return the coefficients of \f$ f_1 + s f_2 \f$ if both source functions are separable polynomials.
+   * @param coeffs The coefficients (see Function::separable_polynomial).
+   * @param sign The sign \f$ s \f$ of the second function.
+   */
+  bool combine_polynomials(std::vector<std::vector<std::vector<double>>>& coeffs, double sign) const;
+
   /// @brief The first (left) source function.
   const Function<dim_inp, dim_out>& m_f1;
   /// @brief The second (right) source function.
@@ -129,9 +377,15 @@ public:
     const Function<dim_inp, dim_out>& f1, const Function<dim_inp, dim_out>& f2, const Args&... args)
     : CombinedFunctionSum<dim_inp, dim_out>(f1, CombinedFunctionSum<dim_inp, dim_out>(f2, args...)) {};
 
+  /// @brief Return the coefficients of the sum of the source functions if both are separable polynomials.
+  bool separable_polynomial(std::vector<std::vector<std::vector<double>>>& coeffs) const override;
+
 private:
   /// @brief Call the combined function by calling the source functions.
   Vector<dim_out> call(const Vector<dim_inp>& x) const override;
+
+  /// @brief Call the combined function on a block of inputs by calling the source functions.
+  void call_batch(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const override;
 };
 
 template <unsigned int dim_inp, unsigned int dim_out>
@@ -148,9 +402,15 @@ public:
     const Function<dim_inp, dim_out>& f1, const Function<dim_inp, dim_out>& f2, const Args&... args)
     : CombinedFunctionSub<dim_inp, dim_out>(f1, CombinedFunctionSub<dim_inp, dim_out>(f2, args...)) {};
 
+  /// @brief Return the coefficients of the difference of the source functions if both are separable polynomials.
+  bool separable_polynomial(std::vector<std::vector<std::vector<double>>>& coeffs) const override;
+
 private:
   /// @brief Call the combined function by calling the source functions.
   Vector<dim_out> call(const Vector<dim_inp>& x) const override;
+
+  /// @brief Call the combined function on a block of inputs by calling the source functions.
+  void call_batch(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const override;
 };
 
 template <unsigned int dim_inp, unsigned int dim_out>
@@ -170,6 +430,9 @@ public:
 private:
   /// @brief Call the combined function by calling the source functions.
   Vector<dim_out> call(const Vector<dim_inp>& x) const override;
+
+  /// @brief Call the combined function on a block of inputs by calling the source functions.
+  void call_batch(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const override;
 };
 
 template <unsigned int dim_inp, unsigned int dim_out>
@@ -189,6 +452,9 @@ public:
 private:
   /// @brief Call the combined function by calling the source functions.
   Vector<dim_out> call(const Vector<dim_inp>& x) const override;
+
+  /// @brief Call the combined function on a block of inputs by calling the source functions.
+  void call_batch(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const override;
 };
 
 /**
@@ -229,12 +495,24 @@ public:
   /// @brief Destroy a Polynomial object.
   ~Polynomial() = default;
 
+  /// @brief Return the coefficients of the polynomial (it is always separable).
+  bool separable_polynomial(std::vector<std::vector<std::vector<double>>>& coeffs) const override;
+
 private:
+  /// @brief Store the coefficients of each dimension contiguously.
+  void transpose();
+
   /// @brief coefficients of the function.
   std::vector<std::vector<double>> m_coeffs;
 
+  /// @brief The coefficients \f$ c_{0,d}, \dots, c_{K,d} \f$ of each dimension \f$ d \f$, one after the other.
+  std::vector<double> m_horner;
+
   /// @brief call the function.
   Vector<dim_out> call(const Vector<dim_inp>& x) const override;
+
+  /// @brief Call the function on a block of inputs (SIMD Horner's scheme in each dimension, see horner).
+  void call_batch(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const override;
 };
 
 /**
@@ -276,11 +554,25 @@ public:
   ~SumExponential() = default;
 
 private:
+  /// @brief Store the coefficients of each dimension contiguously.
+  void transpose();
+
   /// @brief The coefficients of the function.
   std::vector<std::vector<double>> m_coeffs;
 
+  /// @brief The coefficients \f$ c_{0,d}, \dots, c_{K,d} \f$ of each dimension \f$ d \f$, one after the other.
+  std::vector<double> m_horner;
+
   /// @brief Call the function.
   Vector<dim_out> call(const Vector<dim_inp>& x) const override;
+
+  /**
+   * @brief Call the function on a block of inputs.
+   * Since \f$ exp(ku) = exp(u)^k \f$, the function is a polynomial of \f$ exp(u) \f$ in each dimension.
+   * Hence, only one exponential (see exp_batch) is computed per coordinate and the polynomial is evaluated
+   * with Horner's scheme (see horner). The samples with a non-finite output are counted as domain errors.
+   */
+  void call_batch(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const override;
 };
 
 /**
@@ -322,11 +614,28 @@ public:
   ~SumLogarithm() = default;
 
 private:
+  /// @brief Sum the coefficients and the constant terms of each dimension.
+  void reduce();
+
   /// @brief The coefficients of the function.
   std::vector<std::vector<double>> m_coeffs;
 
+  /// @brief The sums \f$ a_d = \sum_{k} c_{k,d} \f$ of the coefficients of each dimension.
+  std::vector<double> m_scales;
+
+  /// @brief The constant term \f$ b = \sum_{k,d} c_{k,d} \log(k+1) \f$.
+  double m_shift;
+
   /// @brief Call the function.
   Vector<dim_out> call(const Vector<dim_inp>& x) const override;
+
+  /**
+   * @brief Call the function on a block of inputs.
+   * Since \f$ log((k+1)u) = log(k+1) + log(u) \f$, the function is evaluated as
+   * \f$ f(u) = b + \sum_d a_d \log(u_d) \f$ with only one logarithm (see log_batch) per coordinate.
+   * The samples with a non-positive coordinate (hence a non-finite output) are counted as domain errors.
+   */
+  void call_batch(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const override;
 };
 
 /**
@@ -363,7 +672,7 @@ public:
   MultivariatePolynomial(std::string filepath);
 
   /// @brief Construct a MultivariatePolynomial object from a matrix of coefficients.
-  MultivariatePolynomial(std::vector<std::vector<std::vector<double>>> &weights, std::vector<double> &biases);
+  MultivariatePolynomial(const std::vector<std::vector<std::vector<double>>> &weights, const std::vector<double> &biases);
 
   /// @brief Copy a MultivariatePolynomial object.
   MultivariatePolynomial(const MultivariatePolynomial<dim_inp, dim_out>&);
@@ -371,15 +680,31 @@ public:
   /// @brief Destroy the object.
   ~MultivariatePolynomial() = default;
 
+  /// @brief Return the coefficients of the polynomial (it is always separable, the bias is put in the first coordinate).
+  bool separable_polynomial(std::vector<std::vector<std::vector<double>>>& coeffs) const override;
+
 protected:
-  /// @brief The weight matrices of the function.
-  std::vector<std::vector<std::vector<double>>> m_weights;
+  /// @brief Store the weight matrices and the bias vector after checking their dimensions.
+  void set_parameters(const std::vector<std::vector<std::vector<double>>> &weights, const std::vector<double> &biases);
+
+  /// @brief Return the number of weight matrices (order of the polynomial).
+  unsigned int order() const;
+
+  /**
+   * @brief The weight matrices of the function stored side by side, \f$ W = [A_1, \dots, A_K] \f$.
+   * The function is then evaluated with one matrix product \f$ p(u) = b + W [u; u^2; \dots; u^K] \f$.
+   */
+  Eigen::Matrix<double, dim_out, Eigen::Dynamic> m_weights;
 
   /// @brief The bias vector of the function.
-  std::vector<double> m_biases;
+  Eigen::Matrix<double, dim_out, 1> m_biases;
 
   /// @brief Call the function.
   virtual Vector<dim_out> call(const Vector<dim_inp>& x) const override;
+
+  /// @brief Call the function on a block of inputs with one matrix product per power and tile of SAMPLE_BLOCK_SIZE
+  /// inputs (the powers of the current tile are kept on the stack).
+  virtual void call_batch(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const override;
 };
 
 
@@ -413,7 +738,7 @@ public:
   Linear(std::string filepath);
 
   /// @brief Construct a Polynomial object from a matrix of coefficients.
-  Linear(std::vector<std::vector<double>> &weights, std::vector<double> &biases);
+  Linear(const std::vector<std::vector<double>> &weights, const std::vector<double> &biases);
 
   /// @brief Copy a Polynomial object.
   Linear(const Linear<dim_inp, dim_out>&);
@@ -2,10 +2,12 @@
 
 
 template <unsigned int dim_inp, unsigned int dim_out>
-Function<dim_inp, dim_out>::Function() {}
+Function<dim_inp, dim_out>::Function()
+  : m_domain_errors(0) {}
 
 template <unsigned int dim_inp, unsigned int dim_out>
-Function<dim_inp, dim_out>::Function(const Function<dim_inp, dim_out>& f) {}
+Function<dim_inp, dim_out>::Function(const Function<dim_inp, dim_out>& f)
+  : m_domain_errors(0) {}
 
 template <unsigned int dim_inp, unsigned int dim_out>
 Function<dim_inp, dim_out>::~Function() {}
@@ -18,12 +20,81 @@ Vector<dim_out> Function<dim_inp, dim_out>::operator()(const Vector<dim_inp>& x)
 template <unsigned int dim_inp, unsigned int dim_out>
 std::shared_ptr<std::vector<Vector<dim_out>>> Function<dim_inp, dim_out>::operator()(std::shared_ptr<std::vector<Vector<dim_inp>>> x) {
   std::shared_ptr<std::vector<Vector<dim_out>>> y(new std::vector<Vector<dim_out>>(x->size()));
-  for (int i = 0; i < x->size(); ++i) {
-    (*y)[i] = this->call((*x)[i]);
-  }
+  this->call_vectors(x->data(), y->data(), x->size());
   return y;
 }
 
+template <unsigned int dim_inp, unsigned int dim_out>
+SampleBlock<dim_out> Function<dim_inp, dim_out>::operator()(const SampleBlock<dim_inp>& x) const {
+  SampleBlock<dim_out> y(x.size());
+  this->call_batch(x.data(), x.ld(), y.data(), y.ld(), x.size());
+  return y;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+void Function<dim_inp, dim_out>::operator()(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const {
+  this->call_batch(x, ldx, y, ldy, n);
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+void Function<dim_inp, dim_out>::call_batch(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const {
+  Vector<dim_inp> input;
+  for (std::size_t i = 0; i < n; ++i) {
+    for (unsigned int d = 0; d < dim_inp; ++d) {
+      input[d] = x[d * ldx + i];
+    }
+    Vector<dim_out> output = this->call(input);
+    for (unsigned int d = 0; d < dim_out; ++d) {
+      y[d * ldy + i] = output[d];
+    }
+  }
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+std::uint64_t Function<dim_inp, dim_out>::domain_errors() const {
+  return m_domain_errors.load(std::memory_order_relaxed);
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+bool Function<dim_inp, dim_out>::separable_polynomial(std::vector<std::vector<std::vector<double>>>&) const {
+  return false;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+void Function<dim_inp, dim_out>::count_domain_errors(std::uint64_t n) const {
+  if (n > 0) {
+    m_domain_errors.fetch_add(n, std::memory_order_relaxed);
+  }
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+void Function<dim_inp, dim_out>::discount_domain_errors(std::uint64_t n) const {
+  if (n > 0) {
+    m_domain_errors.fetch_sub(n, std::memory_order_relaxed);
+  }
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+void Function<dim_inp, dim_out>::call_vectors(const Vector<dim_inp>* x, Vector<dim_out>* y, std::size_t n) const {
+  double inputs[dim_inp * SAMPLE_BLOCK_SIZE];
+  double outputs[dim_out * SAMPLE_BLOCK_SIZE];
+
+  for (std::size_t start = 0; start < n; start += SAMPLE_BLOCK_SIZE) {
+    std::size_t m = std::min<std::size_t>(SAMPLE_BLOCK_SIZE, n - start);
+    for (std::size_t i = 0; i < m; ++i) {
+      for (unsigned int d = 0; d < dim_inp; ++d) {
+        inputs[d * SAMPLE_BLOCK_SIZE + i] = x[start + i][d];
+      }
+    }
+    this->call_batch(inputs, SAMPLE_BLOCK_SIZE, outputs, SAMPLE_BLOCK_SIZE, m);
+    for (std::size_t i = 0; i < m; ++i) {
+      for (unsigned int d = 0; d < dim_out; ++d) {
+        y[start + i][d] = outputs[d * SAMPLE_BLOCK_SIZE + i];
+      }
+    }
+  }
+}
+
 template <unsigned int dim_inp, unsigned int dim_out>
 CombinedFunctionSum<dim_inp, dim_out> Function<dim_inp, dim_out>::operator+(const Function<dim_inp, dim_out>& f) const {
   CombinedFunctionSum<dim_inp, dim_out> out(*this, f);
@@ -49,21 +120,238 @@ CombinedFunctionDiv<dim_inp, dim_out> Function<dim_inp, dim_out>::operator/(cons
 }
 
 template <unsigned int dim_inp, unsigned int dim_out>
-MonteCarloApproximator<dim_out> Function<dim_inp, dim_out>::mca(unsigned int n, Distribution<dim_inp>& dist) {
-  auto samples = dist.samples(n);
-  auto outputs = (*this)(samples);
-  MonteCarloApproximator<dim_out> mca(outputs);
+MonteCarloApproximator<dim_out> Function<dim_inp, dim_out>::mca(std::uint64_t n, Distribution<dim_inp>& dist, unsigned int threads) {
+  threads = std::max(1u, threads);
+  SampleBlock<dim_inp> inputs(n, BufferPool::shared());
+  dist.samples(inputs, threads);
+
+  // Evaluate and accumulate the samples by parts (the blocks are recycled by the pool)
+  auto outputs = std::make_shared<SampleBlock<dim_out>>(n, BufferPool::shared());
+  std::vector<MomentAccumulator<dim_out>> partial(threads, MomentAccumulator<dim_out>(MCA_DEFAULT_ORDER));
+  parallel_for(n, threads, [&](unsigned int t, std::uint64_t begin, std::uint64_t end) {
+    if (end > begin) {
+      this->call_batch(inputs.data() + begin, inputs.ld(), outputs->data() + begin, outputs->ld(), end - begin);
+      partial[t].add(outputs->data() + begin, end - begin, outputs->ld());
+    }
+  }, SAMPLE_BLOCK_SIZE);
+
+  for (unsigned int t = 1; t < threads; ++t) {
+    partial[0] += partial[t];
+  }
+  MonteCarloApproximator<dim_out> mca(outputs, partial[0]);
+  return mca;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+MonteCarloApproximator<dim_out> Function<dim_inp, dim_out>::mca(std::uint64_t n, Distribution<dim_inp>& proposal,
+  const Distribution<dim_inp>& target, unsigned int threads) {
+  threads = std::max(1u, threads);
+  SampleBlock<dim_inp> inputs(n, BufferPool::shared());
+  proposal.samples(inputs, threads);
+
+  // Evaluate the samples and their likelihood ratios, and accumulate the weighted outputs by parts
+  auto outputs = std::make_shared<SampleBlock<dim_out>>(n, BufferPool::shared());
+  auto weights = std::make_shared<std::vector<double>>(n);
+  std::vector<MomentAccumulator<dim_out>> partial(threads, MomentAccumulator<dim_out>(MCA_DEFAULT_ORDER));
+  parallel_for(n, threads, [&](unsigned int t, std::uint64_t begin, std::uint64_t end) {
+    if (end == begin) {
+      return;
+    }
+    double* w = weights->data() + begin;
+    BufferPool::Buffer log_q = BufferPool::shared().acquire(end - begin);
+    target.log_density(inputs.data() + begin, inputs.ld(), w, end - begin);
+    proposal.log_density(inputs.data() + begin, inputs.ld(), log_q.data(), end - begin);
+    for (std::size_t i = 0; i < end - begin; ++i) {
+      w[i] -= log_q.data()[i];
+    }
+    exp_batch(w, w, end - begin);
+    this->call_batch(inputs.data() + begin, inputs.ld(), outputs->data() + begin, outputs->ld(), end - begin);
+    partial[t].add(outputs->data() + begin, w, end - begin, outputs->ld());
+  }, SAMPLE_BLOCK_SIZE);
+
+  for (unsigned int t = 1; t < threads; ++t) {
+    partial[0] += partial[t];
+  }
+  MonteCarloApproximator<dim_out> mca(outputs, weights, partial[0]);
   return mca;
 }
 
 template <unsigned int dim_inp, unsigned int dim_out>
-Vector<dim_out> Function<dim_inp, dim_out>::mean(unsigned int n, Distribution<dim_inp>& dist) {
+MomentAccumulator<dim_out> Function<dim_inp, dim_out>::accumulate(std::uint64_t n,
+  const Distribution<dim_inp>& dist, std::size_t chunk, unsigned int order, unsigned int threads) const {
+  threads = std::max(1u, threads);
+  std::vector<MomentAccumulator<dim_out>> partial(threads, MomentAccumulator<dim_out>(order));
+  for_each_chunk(n, dist, dist.rng(), chunk, threads,
+    [&](unsigned int t, const double*, const double* outputs, std::size_t m) {
+      partial[t].add(outputs, m, Layout::SoA);
+    });
+
+  for (unsigned int t = 1; t < threads; ++t) {
+    partial[0] += partial[t];
+  }
+  return partial[0];
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+std::vector<MomentAccumulator<dim_out>> Function<dim_inp, dim_out>::replicate(std::uint64_t n,
+  const Distribution<dim_inp>& dist, unsigned int count, std::size_t chunk, unsigned int order, unsigned int threads) const {
+  threads = std::max(1u, threads);
+  std::vector<std::vector<MomentAccumulator<dim_out>>> partial(
+    threads, std::vector<MomentAccumulator<dim_out>>(count, MomentAccumulator<dim_out>(order)));
+  for_each_replicate_chunk(n, dist, dist.rng(), count, chunk, threads,
+    [&](unsigned int t, unsigned int r, const double*, const double* outputs, std::size_t m) {
+      partial[t][r].add(outputs, m, Layout::SoA);
+    });
+
+  for (unsigned int t = 1; t < threads; ++t) {
+    for (unsigned int r = 0; r < count; ++r) {
+      partial[0][r] += partial[t][r];
+    }
+  }
+  return partial[0];
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+MomentAccumulator<dim_out> Function<dim_inp, dim_out>::antithetic(std::uint64_t n, Distribution<dim_inp>& dist,
+  MomentAccumulator<dim_out>& pairs, std::size_t chunk, unsigned int order, unsigned int threads) const {
+  if (chunk == 0) {
+    throw InvalidInputException("The chunk size must be positive.");
+  }
+  threads = std::max(1u, threads);
+  const Vector<dim_inp> center = dist.mean() * 2.;
+  const Philox& rng = dist.rng();
+  const std::uint64_t n_pairs = (n + 1) / 2;
+
+  // Each thread processes a contiguous range of chunks of pairs
+  std::vector<MomentAccumulator<dim_out>> partial(threads, MomentAccumulator<dim_out>(order));
+  std::vector<MomentAccumulator<dim_out>> partial_pairs(threads, MomentAccumulator<dim_out>(2));
+  const std::uint64_t n_chunks = (n_pairs + chunk - 1) / chunk;
+  parallel_for(n_chunks, threads, [&](unsigned int t, std::uint64_t first, std::uint64_t last) {
+    if (first == last) {
+      return;
+    }
+    std::size_t size = std::min<std::uint64_t>(n_pairs, chunk);
+    BufferPool::Buffer inputs = BufferPool::shared().acquire(size * dim_inp);
+    BufferPool::Buffer reflected = BufferPool::shared().acquire(size * dim_inp);
+    BufferPool::Buffer outputs = BufferPool::shared().acquire(size * dim_out);
+    BufferPool::Buffer images = BufferPool::shared().acquire(size * dim_out);
+
+    for (std::uint64_t k = first; k < last; ++k) {
+      std::size_t m = std::min<std::uint64_t>(chunk, n_pairs - k * chunk);
+      Philox substream = dist.substream(rng, k, chunk);
+      dist.samples(inputs.data(), m, Layout::SoA, substream);
+      for (unsigned int d = 0; d < dim_inp; ++d) {
+        const double* x = inputs.data() + d * m;
+        double* r = reflected.data() + d * m;
+        for (std::size_t i = 0; i < m; ++i) {
+          r[i] = center[d] - x[i];
+        }
+      }
+      this->call_batch(inputs.data(), m, outputs.data(), m, m);
+      this->call_batch(reflected.data(), m, images.data(), m, m);
+      partial[t].add(outputs.data(), m, Layout::SoA);
+      partial[t].add(images.data(), m, Layout::SoA);
+
+      // Combine the outputs of the pairs (in place of the images)
+      double* y = outputs.data();
+      double* z = images.data();
+      for (std::size_t i = 0; i < m * dim_out; ++i) {
+        z[i] = 0.5 * (y[i] + z[i]);
+      }
+      partial_pairs[t].add(z, m, Layout::SoA);
+    }
+  });
+
+  for (unsigned int t = 1; t < threads; ++t) {
+    partial[0] += partial[t];
+    partial_pairs[0] += partial_pairs[t];
+  }
+  pairs = partial_pairs[0];
+  return partial[0];
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+ControlVariateAccumulator<dim_inp, dim_out> Function<dim_inp, dim_out>::control(std::uint64_t n,
+  Distribution<dim_inp>& dist, unsigned int degree, std::size_t chunk, unsigned int order, unsigned int threads) const {
+  threads = std::max(1u, threads);
+  const Vector<dim_inp> mean = dist.mean();
+  double x[dim_inp], y[dim_out];
+  for (unsigned int d = 0; d < dim_inp; ++d) {
+    x[d] = mean[d];
+  }
+  // The output at the mean is not a sample, so its domain errors are not counted
+  const std::uint64_t errors = this->domain_errors();
+  this->call_batch(x, 1, y, 1, 1);
+  this->discount_domain_errors(this->domain_errors() - errors);
+
+  // The shift only avoids cancellations, so a non-finite output at the mean is replaced by zero
+  Vector<dim_out> shift;
+  for (unsigned int d = 0; d < dim_out; ++d) {
+    shift[d] = std::isfinite(y[d]) ? y[d] : 0.;
+  }
+  const ControlVariateAccumulator<dim_inp, dim_out> empty(dist, shift, degree, order);
+  std::vector<ControlVariateAccumulator<dim_inp, dim_out>> partial(threads, empty);
+  for_each_chunk(n, dist, dist.rng(), chunk, threads,
+    [&](unsigned int t, const double* inputs, const double* outputs, std::size_t m) {
+      partial[t].add(inputs, m, outputs, m, m);
+    });
+
+  for (unsigned int t = 1; t < threads; ++t) {
+    partial[0] += partial[t];
+  }
+  return partial[0];
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+template <typename Task>
+void Function<dim_inp, dim_out>::for_each_chunk(std::uint64_t n, const Distribution<dim_inp>& dist,
+  const Philox& rng, std::size_t chunk, unsigned int threads, const Task& task) const {
+  for_each_replicate_chunk(n, dist, rng, 1, chunk, threads,
+    [&](unsigned int t, unsigned int, const double* inputs, const double* outputs, std::size_t m) {
+      task(t, inputs, outputs, m);
+    });
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+template <typename Task>
+void Function<dim_inp, dim_out>::for_each_replicate_chunk(std::uint64_t n, const Distribution<dim_inp>& dist,
+  const Philox& rng, unsigned int count, std::size_t chunk, unsigned int threads, const Task& task) const {
+  if (chunk == 0) {
+    throw InvalidInputException("The chunk size must be positive.");
+  }
+
+  // Each thread processes a contiguous range of the chunks of all the replicates
+  const std::uint64_t n_chunks = (n + chunk - 1) / chunk;
+  parallel_for(count * n_chunks, threads, [&](unsigned int t, std::uint64_t first, std::uint64_t last) {
+    if (first == last) {
+      return;
+    }
+    std::size_t size = std::min<std::uint64_t>(n, chunk);
+    BufferPool::Buffer inputs = BufferPool::shared().acquire(size * dim_inp);
+    BufferPool::Buffer outputs = BufferPool::shared().acquire(size * dim_out);
+
+    for (std::uint64_t j = first; j < last; ++j) {
+      unsigned int r = j / n_chunks;
+      std::uint64_t k = j % n_chunks;
+      std::size_t m = std::min<std::uint64_t>(chunk, n - k * chunk);
+      Philox stream = rng.split(rng.stream() + r);
+      stream.discard(rng.position());
+      Philox substream = dist.substream(stream, k, chunk);
+      dist.samples(inputs.data(), m, Layout::SoA, substream);
+      this->call_batch(inputs.data(), m, outputs.data(), m, m);
+      task(t, r, inputs.data(), outputs.data(), m);
+    }
+  });
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+Vector<dim_out> Function<dim_inp, dim_out>::mean(std::uint64_t n, Distribution<dim_inp>& dist) {
   auto mca = this->mca(n, dist);
   return Vector<dim_out>(mca.mean());
 }
 
 template <unsigned int dim_inp, unsigned int dim_out>
-Vector<dim_out> Function<dim_inp, dim_out>::var(unsigned int n, Distribution<dim_inp>& dist) {
+Vector<dim_out> Function<dim_inp, dim_out>::var(std::uint64_t n, Distribution<dim_inp>& dist) {
   auto mca = this->mca(n, dist);
   return Vector<dim_out>(mca.var());
 }
@@ -76,6 +364,50 @@ template<unsigned int dim_inp, unsigned int dim_out>
 CombinedFunction<dim_inp, dim_out>::CombinedFunction(const CombinedFunction<dim_inp, dim_out>& f)
   : Function<dim_inp, dim_out>(), m_f1(f.m_f1), m_f2(f.m_f2) {}
 
+template<unsigned int dim_inp, unsigned int dim_out>
+std::uint64_t CombinedFunction<dim_inp, dim_out>::domain_errors() const {
+  return Function<dim_inp, dim_out>::domain_errors() + m_f1.domain_errors() + m_f2.domain_errors();
+}
+
+template<unsigned int dim_inp, unsigned int dim_out>
+template <typename Op>
+void CombinedFunction<dim_inp, dim_out>::combine_batch(
+  const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n, const Op& op) const {
+  double buffer[dim_out * SAMPLE_BLOCK_SIZE];
+
+  for (std::size_t start = 0; start < n; start += SAMPLE_BLOCK_SIZE) {
+    std::size_t m = std::min<std::size_t>(SAMPLE_BLOCK_SIZE, n - start);
+    this->m_f1.call_batch(x + start, ldx, y + start, ldy, m);
+    this->m_f2.call_batch(x + start, ldx, buffer, SAMPLE_BLOCK_SIZE, m);
+    for (unsigned int d = 0; d < dim_out; ++d) {
+      double* out = y + d * ldy + start;
+      const double* other = buffer + d * SAMPLE_BLOCK_SIZE;
+      for (std::size_t i = 0; i < m; ++i) {
+        out[i] = op(out[i], other[i]);
+      }
+    }
+  }
+}
+
+template<unsigned int dim_inp, unsigned int dim_out>
+bool CombinedFunction<dim_inp, dim_out>::combine_polynomials(
+  std::vector<std::vector<std::vector<double>>>& coeffs, double sign) const {
+  std::vector<std::vector<std::vector<double>>> other;
+  if (!m_f1.separable_polynomial(coeffs) || !m_f2.separable_polynomial(other)) {
+    return false;
+  }
+  for (unsigned int j = 0; j < dim_out; ++j) {
+    for (unsigned int d = 0; d < dim_inp; ++d) {
+      std::vector<double>& c = coeffs[j][d];
+      c.resize(std::max(c.size(), other[j][d].size()), 0.);
+      for (std::size_t k = 0; k < other[j][d].size(); ++k) {
+        c[k] += sign * other[j][d][k];
+      }
+    }
+  }
+  return true;
+}
+
 template<unsigned int dim_inp, unsigned int dim_out>
 CombinedFunctionSum<dim_inp, dim_out>::CombinedFunctionSum(const Function<dim_inp, dim_out>& f1, const Function<dim_inp, dim_out>& f2)
   : CombinedFunction<dim_inp, dim_out>(f1, f2) {}
@@ -84,12 +416,22 @@ template<unsigned int dim_inp, unsigned int dim_out>
 CombinedFunctionSum<dim_inp, dim_out>::CombinedFunctionSum(const CombinedFunctionSum<dim_inp, dim_out>& f)
   : CombinedFunction<dim_inp, dim_out>(f.m_f1, f.m_f2) {}
 
+template<unsigned int dim_inp, unsigned int dim_out>
+bool CombinedFunctionSum<dim_inp, dim_out>::separable_polynomial(std::vector<std::vector<std::vector<double>>>& coeffs) const {
+  return this->combine_polynomials(coeffs, 1.);
+}
+
 template<unsigned int dim_inp, unsigned int dim_out>
 Vector<dim_out> CombinedFunctionSum<dim_inp, dim_out>::call(const Vector<dim_inp>& x) const {
   Vector<dim_out> out = this->m_f1.call(x) + this->m_f2.call(x);
   return out;
 }
 
+template<unsigned int dim_inp, unsigned int dim_out>
+void CombinedFunctionSum<dim_inp, dim_out>::call_batch(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const {
+  this->combine_batch(x, ldx, y, ldy, n, [](double a, double b) { return a + b; });
+}
+
 template<unsigned int dim_inp, unsigned int dim_out>
 CombinedFunctionSub<dim_inp, dim_out>::CombinedFunctionSub(const Function<dim_inp, dim_out>& f1, const Function<dim_inp, dim_out>& f2)
   : CombinedFunction<dim_inp, dim_out>(f1, f2) {}
@@ -98,12 +440,22 @@ template<unsigned int dim_inp, unsigned int dim_out>
 CombinedFunctionSub<dim_inp, dim_out>::CombinedFunctionSub(const CombinedFunctionSub<dim_inp, dim_out>& f)
   : CombinedFunction<dim_inp, dim_out>(f.m_f1, f.m_f2) {}
 
+template<unsigned int dim_inp, unsigned int dim_out>
+bool CombinedFunctionSub<dim_inp, dim_out>::separable_polynomial(std::vector<std::vector<std::vector<double>>>& coeffs) const {
+  return this->combine_polynomials(coeffs, -1.);
+}
+
 template<unsigned int dim_inp, unsigned int dim_out>
 Vector<dim_out> CombinedFunctionSub<dim_inp, dim_out>::call(const Vector<dim_inp>& x) const {
   Vector<dim_out> out = this->m_f1.call(x) - this->m_f2.call(x);
   return out;
 }
 
+template<unsigned int dim_inp, unsigned int dim_out>
+void CombinedFunctionSub<dim_inp, dim_out>::call_batch(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const {
+  this->combine_batch(x, ldx, y, ldy, n, [](double a, double b) { return a - b; });
+}
+
 template<unsigned int dim_inp, unsigned int dim_out>
 CombinedFunctionMul<dim_inp, dim_out>::CombinedFunctionMul(const Function<dim_inp, dim_out>& f1, const Function<dim_inp, dim_out>& f2)
   : CombinedFunction<dim_inp, dim_out>(f1, f2) {}
@@ -118,6 +470,11 @@ Vector<dim_out> CombinedFunctionMul<dim_inp, dim_out>::call(const Vector<dim_inp
   return out;
 }
 
+template<unsigned int dim_inp, unsigned int dim_out>
+void CombinedFunctionMul<dim_inp, dim_out>::call_batch(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const {
+  this->combine_batch(x, ldx, y, ldy, n, [](double a, double b) { return a * b; });
+}
+
 template<unsigned int dim_inp, unsigned int dim_out>
 CombinedFunctionDiv<dim_inp, dim_out>::CombinedFunctionDiv(const Function<dim_inp, dim_out>& f1, const Function<dim_inp, dim_out>& f2)
   : CombinedFunction<dim_inp, dim_out>(f1, f2) {}
@@ -132,6 +489,11 @@ Vector<dim_out> CombinedFunctionDiv<dim_inp, dim_out>::call(const Vector<dim_inp
   return out;
 }
 
+template<unsigned int dim_inp, unsigned int dim_out>
+void CombinedFunctionDiv<dim_inp, dim_out>::call_batch(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const {
+  this->combine_batch(x, ldx, y, ldy, n, [](double a, double b) { return a / b; });
+}
+
 template<unsigned int dim_inp, unsigned int dim_out>
 Polynomial<dim_inp, dim_out>::Polynomial(std::string filepath)
   : Function<dim_inp, dim_out>()
@@ -172,27 +534,69 @@ Polynomial<dim_inp, dim_out>::Polynomial(std::string filepath)
     throw e;
   }
   file.close();
+  transpose();
 }
 
 template<unsigned int dim_inp, unsigned int dim_out>
 Polynomial<dim_inp, dim_out>::Polynomial(std::vector<std::vector<double>> &coeffs)
-  : Function<dim_inp, dim_out>(), m_coeffs(coeffs) {}
+  : Function<dim_inp, dim_out>(), m_coeffs(coeffs)
+{
+  for (const auto& row : m_coeffs) {
+    if (row.size() != dim_inp) {
+      throw InvalidInputException("The coefficients must have dimension " + std::to_string(dim_inp) + ".");
+    }
+  }
+  transpose();
+}
 
 template<unsigned int dim_inp, unsigned int dim_out>
 Polynomial<dim_inp, dim_out>::Polynomial(const Polynomial<dim_inp, dim_out>& p)
-  : Function<dim_inp, dim_out>(), m_coeffs(p.m_coeffs) {}
+  : Function<dim_inp, dim_out>(), m_coeffs(p.m_coeffs), m_horner(p.m_horner) {}
+
+template<unsigned int dim_inp, unsigned int dim_out>
+void Polynomial<dim_inp, dim_out>::transpose() {
+  const std::size_t K = m_coeffs.size();
+  m_horner.resize(dim_inp * K);
+  for (unsigned int d = 0; d < dim_inp; ++d) {
+    for (std::size_t k = 0; k < K; ++k) {
+      m_horner[d * K + k] = m_coeffs[k][d];
+    }
+  }
+}
+
+template<unsigned int dim_inp, unsigned int dim_out>
+bool Polynomial<dim_inp, dim_out>::separable_polynomial(std::vector<std::vector<std::vector<double>>>& coeffs) const {
+  const std::size_t K = m_coeffs.size();
+  coeffs.assign(dim_out, std::vector<std::vector<double>>(dim_inp));
+  for (unsigned int d = 0; d < dim_inp; ++d) {
+    coeffs[0][d].assign(m_horner.begin() + d * K, m_horner.begin() + (d + 1) * K);
+  }
+  return true;
+}
 
 template<unsigned int dim_inp, unsigned int dim_out>
 Vector<dim_out> Polynomial<dim_inp, dim_out>::call(const Vector<dim_inp>& x) const {
   Vector<dim_out> y = 0;
-  Vector<dim_inp> x_powered = 1;
-  for (int i = 0; i < m_coeffs.size(); ++i) {
-    y = y + x_powered.dot(m_coeffs[i]);
-    x_powered *= x;
+  if (m_coeffs.empty()) return y;
+
+  const std::size_t K = m_coeffs.size();
+  for (unsigned int d = 0; d < dim_inp; ++d) {
+    horner(&m_horner[d * K], K - 1, &x[d], &y[0], 1);
   }
   return y;
 }
 
+template<unsigned int dim_inp, unsigned int dim_out>
+void Polynomial<dim_inp, dim_out>::call_batch(const double* x, std::size_t ldx, double* y, [[maybe_unused]] std::size_t ldy, std::size_t n) const {
+  std::fill(y, y + n, 0.);
+  if (m_coeffs.empty()) return;
+
+  const std::size_t K = m_coeffs.size();
+  for (unsigned int d = 0; d < dim_inp; ++d) {
+    horner(&m_horner[d * K], K - 1, x + d * ldx, y, n);
+  }
+}
+
 template<unsigned int dim_inp, unsigned int dim_out>
 SumExponential<dim_inp, dim_out>::SumExponential(std::string filepath)
   : Function<dim_inp, dim_out>()
@@ -233,25 +637,65 @@ SumExponential<dim_inp, dim_out>::SumExponential(std::string filepath)
     throw e;
   }
   file.close();
+  transpose();
 }
 
 template<unsigned int dim_inp, unsigned int dim_out>
 SumExponential<dim_inp, dim_out>::SumExponential(std::vector<std::vector<double>> &coeffs)
-  : Function<dim_inp, dim_out>(), m_coeffs(coeffs) {}
+  : Function<dim_inp, dim_out>(), m_coeffs(coeffs)
+{
+  for (const auto& row : m_coeffs) {
+    if (row.size() != dim_inp) {
+      throw InvalidInputException("The coefficients must have dimension " + std::to_string(dim_inp) + ".");
+    }
+  }
+  transpose();
+}
 
 template<unsigned int dim_inp, unsigned int dim_out>
 SumExponential<dim_inp, dim_out>::SumExponential(const SumExponential<dim_inp, dim_out>& f)
-  : Function<dim_inp, dim_out>(), m_coeffs(f.m_coeffs) {}
+  : Function<dim_inp, dim_out>(), m_coeffs(f.m_coeffs), m_horner(f.m_horner) {}
 
 template<unsigned int dim_inp, unsigned int dim_out>
-Vector<dim_out> SumExponential<dim_inp, dim_out>::call(const Vector<dim_inp>& x) const {
-  Vector<dim_out> y = 0;
-  for (int i = 0; i < m_coeffs.size(); ++i) {
-    y += (i * x).exp().dot(m_coeffs[i]);
+void SumExponential<dim_inp, dim_out>::transpose() {
+  const std::size_t K = m_coeffs.size();
+  m_horner.resize(dim_inp * K);
+  for (unsigned int d = 0; d < dim_inp; ++d) {
+    for (std::size_t k = 0; k < K; ++k) {
+      m_horner[d * K + k] = m_coeffs[k][d];
+    }
   }
+}
+
+template<unsigned int dim_inp, unsigned int dim_out>
+Vector<dim_out> SumExponential<dim_inp, dim_out>::call(const Vector<dim_inp>& x) const {
+  Vector<dim_out> y;
+  this->call_batch(&x[0], 1, &y[0], 1, 1);
   return y;
 }
 
+template<unsigned int dim_inp, unsigned int dim_out>
+void SumExponential<dim_inp, dim_out>::call_batch(const double* x, std::size_t ldx, double* y, [[maybe_unused]] std::size_t ldy, std::size_t n) const {
+  const std::size_t K = m_coeffs.size();
+  double powers[SAMPLE_BLOCK_SIZE];
+
+  std::fill(y, y + n, 0.);
+  if (K == 0) return;
+  for (std::size_t start = 0; start < n; start += SAMPLE_BLOCK_SIZE) {
+    std::size_t m = std::min<std::size_t>(SAMPLE_BLOCK_SIZE, n - start);
+    for (unsigned int d = 0; d < dim_inp; ++d) {
+      exp_batch(x + d * ldx + start, powers, m);
+      horner(&m_horner[d * K], K - 1, powers, y + start, m);
+    }
+  }
+
+  std::uint64_t errors = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    errors += !std::isfinite(y[i]);
+  }
+  this->count_domain_errors(errors);
+}
+
 template<unsigned int dim_inp, unsigned int dim_out>
 SumLogarithm<dim_inp, dim_out>::SumLogarithm(std::string filepath)
   : Function<dim_inp, dim_out>()
@@ -292,25 +736,70 @@ SumLogarithm<dim_inp, dim_out>::SumLogarithm(std::string filepath)
     throw e;
   }
   file.close();
+  reduce();
 }
 
 template<unsigned int dim_inp, unsigned int dim_out>
 SumLogarithm<dim_inp, dim_out>::SumLogarithm(std::vector<std::vector<double>> &coeffs)
-  : Function<dim_inp, dim_out>(), m_coeffs(coeffs) {}
+  : Function<dim_inp, dim_out>(), m_coeffs(coeffs)
+{
+  for (const auto& row : m_coeffs) {
+    if (row.size() != dim_inp) {
+      throw InvalidInputException("The coefficients must have dimension " + std::to_string(dim_inp) + ".");
+    }
+  }
+  reduce();
+}
 
 template<unsigned int dim_inp, unsigned int dim_out>
 SumLogarithm<dim_inp, dim_out>::SumLogarithm(const SumLogarithm<dim_inp, dim_out>& f)
-  : Function<dim_inp, dim_out>(), m_coeffs(f.m_coeffs) {}
+  : Function<dim_inp, dim_out>(), m_coeffs(f.m_coeffs), m_scales(f.m_scales), m_shift(f.m_shift) {}
 
 template<unsigned int dim_inp, unsigned int dim_out>
-Vector<dim_out> SumLogarithm<dim_inp, dim_out>::call(const Vector<dim_inp>& x) const {
-  Vector<dim_out> y = 0;
-  for (int i = 0; i < m_coeffs.size(); ++i) {
-    y += ((i+1) * x).log().dot(m_coeffs[i]);
+void SumLogarithm<dim_inp, dim_out>::reduce() {
+  m_scales.assign(dim_inp, 0.);
+  m_shift = 0.;
+  for (std::size_t k = 0; k < m_coeffs.size(); ++k) {
+    const double shift = std::log(k + 1.);
+    for (unsigned int d = 0; d < dim_inp; ++d) {
+      m_scales[d] += m_coeffs[k][d];
+      m_shift += m_coeffs[k][d] * shift;
+    }
   }
+}
+
+template<unsigned int dim_inp, unsigned int dim_out>
+Vector<dim_out> SumLogarithm<dim_inp, dim_out>::call(const Vector<dim_inp>& x) const {
+  Vector<dim_out> y;
+  this->call_batch(&x[0], 1, &y[0], 1, 1);
   return y;
 }
 
+template<unsigned int dim_inp, unsigned int dim_out>
+void SumLogarithm<dim_inp, dim_out>::call_batch(const double* x, std::size_t ldx, double* y, [[maybe_unused]] std::size_t ldy, std::size_t n) const {
+  double logs[SAMPLE_BLOCK_SIZE];
+
+  std::fill(y, y + n, m_shift);
+  for (std::size_t start = 0; start < n; start += SAMPLE_BLOCK_SIZE) {
+    std::size_t m = std::min<std::size_t>(SAMPLE_BLOCK_SIZE, n - start);
+    for (unsigned int d = 0; d < dim_inp; ++d) {
+      const double* xd = x + d * ldx + start;
+      const double a = m_scales[d];
+      log_batch(xd, logs, m);
+      for (std::size_t i = 0; i < m; ++i) {
+        y[start + i] += a * logs[i];
+      }
+    }
+  }
+
+  // A non-positive coordinate gives a non-finite output, which is counted once per sample
+  std::uint64_t errors = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    errors += !std::isfinite(y[i]);
+  }
+  this->count_domain_errors(errors);
+}
+
 template<unsigned int dim_inp, unsigned int dim_out>
 MultivariatePolynomial<dim_inp, dim_out>::MultivariatePolynomial(std::string filepath)
   : Function<dim_inp, dim_out>()
@@ -336,21 +825,22 @@ MultivariatePolynomial<dim_inp, dim_out>::MultivariatePolynomial(std::string fil
     std::getline(file, line);
     if (!line.empty()) throw InvalidInputException();
 
-    // Store the biases
+    // Read the biases
     std::getline(file, line);
     std::istringstream linestream(line);
-    m_biases = {std::istream_iterator<double>(linestream), std::istream_iterator<double>()};
-    if (m_biases.size() != dim_out) InvalidInputException();
+    std::vector<double> biases = {std::istream_iterator<double>(linestream), std::istream_iterator<double>()};
 
-    m_weights.resize(k);
+    std::vector<std::vector<std::vector<double>>> weights(k);
     for (int i = 0; i < k; ++i) {
       // Check the preceeding line (empty)
       std::getline(file, line);
       if (!line.empty()) throw InvalidInputException();
-      // Store the weights
-      m_weights[i] = read_matrix(file, d_out, d_inp);
+      // Read the weights
+      weights[i] = read_matrix(file, d_out, d_inp);
     }
 
+    set_parameters(weights, biases);
+
   }
   catch (const Exception& e) {
     std::cout << "Failed to read the file." << std::endl;
@@ -362,30 +852,119 @@ MultivariatePolynomial<dim_inp, dim_out>::MultivariatePolynomial(std::string fil
 }
 
 template<unsigned int dim_inp, unsigned int dim_out>
-MultivariatePolynomial<dim_inp, dim_out>::MultivariatePolynomial(std::vector<std::vector<std::vector<double>>> &weights, std::vector<double> &biases)
-  : Function<dim_inp, dim_out>(), m_weights(weights), m_biases(biases) {}
+MultivariatePolynomial<dim_inp, dim_out>::MultivariatePolynomial(const std::vector<std::vector<std::vector<double>>> &weights, const std::vector<double> &biases)
+  : Function<dim_inp, dim_out>()
+{
+  set_parameters(weights, biases);
+}
 
 template<unsigned int dim_inp, unsigned int dim_out>
 MultivariatePolynomial<dim_inp, dim_out>::MultivariatePolynomial(const MultivariatePolynomial<dim_inp, dim_out>& f)
-  : Function<dim_inp, dim_out>(), m_weights(f.weights), m_biases(f.m_biases) {}
+  : Function<dim_inp, dim_out>(), m_weights(f.m_weights), m_biases(f.m_biases) {}
+
+template<unsigned int dim_inp, unsigned int dim_out>
+void MultivariatePolynomial<dim_inp, dim_out>::set_parameters(
+  const std::vector<std::vector<std::vector<double>>> &weights, const std::vector<double> &biases) {
+  // Check the dimensions
+  if (biases.size() != dim_out) {
+    throw InvalidInputException("The bias vector must have dimension " + std::to_string(dim_out) + ".");
+  }
+  for (const auto& weight : weights) {
+    bool valid = (weight.size() == dim_out);
+    for (const auto& row : weight) {
+      valid = valid && (row.size() == dim_inp);
+    }
+    if (!valid) {
+      std::string msg = "The weight matrices must have dimensions "
+        + std::to_string(dim_out) + "x" + std::to_string(dim_inp) + ".";
+      throw InvalidInputException(msg);
+    }
+  }
+
+  // Store the weight matrices side by side
+  m_weights.resize(dim_out, weights.size() * dim_inp);
+  for (std::size_t k = 0; k < weights.size(); ++k) {
+    for (unsigned int o = 0; o < dim_out; ++o) {
+      for (unsigned int d = 0; d < dim_inp; ++d) {
+        m_weights(o, k * dim_inp + d) = weights[k][o][d];
+      }
+    }
+  }
+  for (unsigned int o = 0; o < dim_out; ++o) {
+    m_biases[o] = biases[o];
+  }
+}
+
+template<unsigned int dim_inp, unsigned int dim_out>
+unsigned int MultivariatePolynomial<dim_inp, dim_out>::order() const {
+  return m_weights.cols() / dim_inp;
+}
+
+template<unsigned int dim_inp, unsigned int dim_out>
+bool MultivariatePolynomial<dim_inp, dim_out>::separable_polynomial(std::vector<std::vector<std::vector<double>>>& coeffs) const {
+  const unsigned int K = order();
+  coeffs.assign(dim_out, std::vector<std::vector<double>>(dim_inp, std::vector<double>(K + 1, 0.)));
+  for (unsigned int j = 0; j < dim_out; ++j) {
+    coeffs[j][0][0] = m_biases[j];
+    for (unsigned int d = 0; d < dim_inp; ++d) {
+      for (unsigned int k = 0; k < K; ++k) {
+        coeffs[j][d][k + 1] = m_weights(j, k * dim_inp + d);
+      }
+    }
+  }
+  return true;
+}
 
 template<unsigned int dim_inp, unsigned int dim_out>
 Vector<dim_out> MultivariatePolynomial<dim_inp, dim_out>::call(const Vector<dim_inp>& x) const {
-  Vector<dim_out> y = m_biases;
-  Vector<dim_inp> x_powered(x);
+  // Stack the element-wise powers of the input
+  Eigen::VectorXd powers(m_weights.cols());
+  for (unsigned int d = 0; d < dim_inp; ++d) {
+    double powered = x[d];
+    for (unsigned int k = 0; k < order(); ++k) {
+      powers[k * dim_inp + d] = powered;
+      powered *= x[d];
+    }
+  }
+
+  Eigen::VectorXd y = m_biases + m_weights * powers;
+  return Vector<dim_out>(y);
+}
 
-  for (std::vector<std::vector<double>> weight : m_weights) {
-    int i = 0;
-    for (std::vector<double> row : weight) {
-      y[i++] += x_powered.dot(row);
+template<unsigned int dim_inp, unsigned int dim_out>
+void MultivariatePolynomial<dim_inp, dim_out>::call_batch(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const {
+  typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> Block;
+  typedef Eigen::Map<const Block, 0, Eigen::OuterStride<>> InputMap;
+  typedef Eigen::Map<Block, 0, Eigen::OuterStride<>> OutputMap;
+
+  // The rows of the blocks are the coordinates of the inputs and outputs
+  InputMap inputs(x, dim_inp, n, Eigen::OuterStride<>(ldx));
+  OutputMap outputs(y, dim_out, n, Eigen::OuterStride<>(ldy));
+
+  const unsigned int K = order();
+  double buffer[dim_inp * SAMPLE_BLOCK_SIZE];
+  for (std::size_t start = 0; start < n; start += SAMPLE_BLOCK_SIZE) {
+    std::size_t m = std::min<std::size_t>(SAMPLE_BLOCK_SIZE, n - start);
+    auto tile = inputs.middleCols(start, m);
+    OutputMap powers(buffer, dim_inp, m, Eigen::OuterStride<>(SAMPLE_BLOCK_SIZE));
+
+    // Add the product of each coefficient matrix with the element-wise powers of the tile
+    auto out = outputs.middleCols(start, m);
+    out.colwise() = m_biases;
+    for (unsigned int k = 0; k < K; ++k) {
+      if (k == 0) {
+        powers = tile;
+      }
+      else {
+        powers = powers.cwiseProduct(tile);
+      }
+      out.noalias() += m_weights.middleCols(k * dim_inp, dim_inp) * powers;
     }
-    x_powered *= x;
   }
-  return y;
 }
 
 template<unsigned int dim_inp, unsigned int dim_out>
-Linear<dim_inp, dim_out>::Linear(std::vector<std::vector<double>> &weights, std::vector<double> &biases)
+Linear<dim_inp, dim_out>::Linear(const std::vector<std::vector<double>> &weights, const std::vector<double> &biases)
   : MultivariatePolynomial<dim_inp, dim_out>(std::vector<std::vector<std::vector<double>>>(1, weights), biases) {}
 
 template<unsigned int dim_inp, unsigned int dim_out>
@@ -0,0 +1,207 @@
+#ifndef MC_GRAPH_HPP
+#define MC_GRAPH_HPP
+
+#include "functions.hpp"
+#include "exceptions.hpp"
+#include "distributions.hpp"
+#include "vector.hpp"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+
+/**
+ * @brief Function defined by a graph of combinations of functions built at runtime.
+ * The nodes of the graph are functions, constants, and arithmetic operations on the outputs of
+ * other nodes. The nodes are hash-consed: adding a node which already exists returns the existing node
+ * (the operands of sums and products are sorted, so \f$ f g \f$ and \f$ g f \f$ are the same node).
+ * Therefore, in \f$ f f + f \f$, the function \f$ f \f$ is only evaluated once per block of samples.
+ *
+ * The graph is evaluated on blocks of SAMPLE_BLOCK_SIZE samples. Each node which the output depends
+ * on is evaluated once per block into a scratch buffer, in the order in which the nodes were added.
+ * The buffer of a node is reused by the following nodes after its last use, so the number of buffers
+ * is usually much smaller than the number of nodes (see FunctionGraph::buffers). The buffers are
+ * leased from the shared pool (see BufferPool) for each call, so they are recycled by all the calls,
+ * also across the worker threads, and nested graphs (graphs can be leaves of graphs) get their own.
+ *
+ * A graph can be read from a "combination" file, which refers to other function files:
+ *
+ *     combination
+ *     <dim_inp> <dim_out> <number of functions>
+ *
+ *     <name> <path to a function file>
+ *     ...
+ *
+ *     <expression, e.g., f * f + f - 2 * g / (h + 1)>
+ *
+ * The paths are relative to the directory of the combination file. The expression supports
+ * the operators `+`, `-`, `*`, `/`, parentheses, numbers, and the names of the functions.
+ *
+ * @tparam dim_inp The input dimension of the function.
+ * @tparam dim_out The output dimension of the function.
+ */
+template <unsigned int dim_inp, unsigned int dim_out>
+class FunctionGraph : public Function<dim_inp, dim_out>
+{
+public:
+  /// @brief The types of the nodes of a graph.
+  enum class NodeType
+  {
+    /// @brief The outputs of a function.
+    Function,
+    /// @brief A constant on all the coordinates.
+    Constant,
+    /// @brief The sum of two nodes.
+    Sum,
+    /// @brief The difference of two nodes.
+    Sub,
+    /// @brief The product of two nodes.
+    Mul,
+    /// @brief The quotient of two nodes.
+    Div
+  };
+
+  /// @brief Construct an empty graph.
+  FunctionGraph();
+
+  /**
+   * @brief Construct a graph from a combination file.
+   * If the file is invalid or includes itself (directly or through other combination files),
+   * an InvalidInputException exception is thrown.
+   * @param filepath The path of the file.
+   */
+  FunctionGraph(std::string filepath);
+
+  /// @brief Copy a FunctionGraph object (the functions of the leaves are shared).
+  FunctionGraph(const FunctionGraph<dim_inp, dim_out>& g);
+
+  /**
+   * @brief Add a node which evaluates a function.
+   * @param f The function, which is shared with the caller.
+   * @return std::size_t The index of the node.
+   */
+  std::size_t function(std::shared_ptr<const Function<dim_inp, dim_out>> f);
+
+  /// @brief Add a node with a constant value and return its index.
+  std::size_t constant(double value);
+
+  /**
+   * @brief Add a node which combines the outputs of two nodes.
+   * If the indices are not valid or the type is not an operation, an InvalidInputException exception is thrown.
+   * @param type The operation (NodeType::Sum, NodeType::Sub, NodeType::Mul, or NodeType::Div).
+   * @param left The index of the left operand.
+   * @param right The index of the right operand.
+   * @return std::size_t The index of the node.
+   */
+  std::size_t combine(NodeType type, std::size_t left, std::size_t right);
+
+  /**
+   * @brief Set the node of the outputs of the graph.
+   * The nodes which the output depends on are scheduled and their buffers are assigned.
+   * @param node The index of the node.
+   */
+  void output(std::size_t node);
+
+  /// @brief Return the number of (distinct) nodes of the graph.
+  std::size_t size() const;
+
+  /// @brief Return the number of scratch buffers of one block of outputs used by an evaluation.
+  std::size_t buffers() const;
+
+  /// @brief Return the number of evaluations outside of the domain of the functions of the graph.
+  std::uint64_t domain_errors() const override;
+
+private:
+  /// @brief A node of the graph.
+  struct Node
+  {
+    /// @brief The type of the node.
+    NodeType type;
+    /// @brief The index of the left operand.
+    std::size_t left;
+    /// @brief The index of the right operand.
+    std::size_t right;
+    /// @brief The value of a constant.
+    double value;
+    /// @brief The function of a leaf.
+    std::shared_ptr<const Function<dim_inp, dim_out>> function;
+  };
+
+  /// @brief The key of a node for hash-consing: the type, the operands, and the bits of the value or of the function.
+  struct Key
+  {
+    NodeType type;
+    std::size_t left;
+    std::size_t right;
+    std::uint64_t payload;
+
+    bool operator==(const Key& other) const;
+  };
+
+  /// @brief The hash of the key of a node.
+  struct KeyHash
+  {
+    std::size_t operator()(const Key& key) const;
+  };
+
+  /// @brief Return the index of a node, after adding it if it does not exist.
+  std::size_t insert(const Key& key, const Node& node);
+
+  /// @brief Read the expression of a combination file from a position (sums and differences).
+  std::size_t parse_sum(const std::string& text, std::size_t& pos, const std::map<std::string, std::size_t>& names);
+  /// @brief Read a product or a quotient from a position.
+  std::size_t parse_product(const std::string& text, std::size_t& pos, const std::map<std::string, std::size_t>& names);
+  /// @brief Read a number, a name, a negation, or an expression in parentheses from a position.
+  std::size_t parse_factor(const std::string& text, std::size_t& pos, const std::map<std::string, std::size_t>& names);
+
+  /// @brief Apply an operation to the buffers of the operands.
+  static void apply(NodeType type, const double* a, const double* b, double* out, std::size_t n);
+
+  /// @brief Call the graph on an input.
+  Vector<dim_out> call(const Vector<dim_inp>& x) const override;
+
+  /// @brief Call the graph on a block of inputs, evaluating each scheduled node once per block.
+  void call_batch(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const override;
+
+  /// @brief The nodes, in the order in which they were added (operands are before their users).
+  std::vector<Node> m_nodes;
+  /// @brief The index of each node from its key.
+  std::unordered_map<Key, std::size_t, KeyHash> m_index;
+  /// @brief The index of the output node.
+  std::size_t m_output;
+  /// @brief The nodes which the output depends on, in the order of evaluation.
+  std::vector<std::size_t> m_schedule;
+  /// @brief The scratch buffer of each node of the schedule.
+  std::vector<std::size_t> m_slots;
+  /// @brief The number of scratch buffers.
+  std::size_t m_buffers;
+};
+
+/**
+ * @brief Construct a function from a function file.
+ * The type of the function is read from the first line of the file
+ * ("polynomial", "sumexponential", "sumlogarithm", "multivariatepolynomial", "linear", or "combination").
+ * If the type is not supported, a FunctionNotSupported exception is thrown.
+ * @param filepath The path of the file.
+ * @return std::shared_ptr<Function<dim_inp, dim_out>> The function.
+ */
+template <unsigned int dim_inp, unsigned int dim_out>
+std::shared_ptr<Function<dim_inp, dim_out>> load_function(const std::string& filepath);
+
+#include "graph.tpp"
+
+#endif
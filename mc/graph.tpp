@@ -0,0 +1,399 @@
+#include "graph.hpp"
+
+
+template <unsigned int dim_inp, unsigned int dim_out>
+FunctionGraph<dim_inp, dim_out>::FunctionGraph()
+  : Function<dim_inp, dim_out>(), m_output(0), m_buffers(0) {}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+FunctionGraph<dim_inp, dim_out>::FunctionGraph(std::string filepath)
+  : FunctionGraph<dim_inp, dim_out>()
+{
+  // Instantiate the file and the line string
+  std::string line;
+  std::ifstream file(filepath);
+  if (!file.is_open()) {
+    throw InvalidInputException("Could not open file: " + filepath + ".");
+  }
+
+  // The files which are being loaded by this thread (a file which includes itself would never end)
+  static thread_local std::set<std::string> loading;
+  std::string canonical = std::filesystem::weakly_canonical(filepath).string();
+  if (!loading.insert(canonical).second) {
+    throw InvalidInputException("Recursive combination file: " + filepath + ".");
+  }
+
+  try {
+    // Check the function type
+    std::getline(file, line);
+    if (line != "combination") throw InvalidInputException();
+    // Check the dimensions
+    std::getline(file, line);
+    unsigned int d_inp, d_out, k;
+    std::istringstream(line) >> d_inp >> d_out >> k;
+    if (d_inp != dim_inp) throw InvalidInputException();
+    if (d_out != dim_out) throw InvalidInputException();
+    // Check the third line (empty)
+    std::getline(file, line);
+    if (!line.empty()) throw InvalidInputException();
+
+    // Read the following k rows as named functions (a file which is used twice is only loaded once)
+    std::filesystem::path directory = std::filesystem::path(filepath).parent_path();
+    std::map<std::string, std::size_t> names;
+    std::map<std::string, std::size_t> files;
+    for (unsigned int i = 0; i < k; ++i) {
+      std::getline(file, line);
+      std::string name, path;
+      std::istringstream(line) >> name >> path;
+      if (name.empty() || path.empty()) throw InvalidInputException("Invalid function: \"" + line + "\".");
+      if (names.count(name)) throw InvalidInputException("Duplicate function name: \"" + name + "\".");
+      std::string resolved = (directory / path).lexically_normal().string();
+      if (!files.count(resolved)) {
+        files[resolved] = function(load_function<dim_inp, dim_out>(resolved));
+      }
+      names[name] = files[resolved];
+    }
+    // Check the empty line
+    std::getline(file, line);
+    if (!line.empty()) throw InvalidInputException();
+
+    // Read the expression
+    std::getline(file, line);
+    std::size_t pos = 0;
+    std::size_t node = parse_sum(line, pos, names);
+    while (pos < line.size() && std::isspace((unsigned char)line[pos])) ++pos;
+    if (pos != line.size()) {
+      throw InvalidInputException("Unexpected character at position " + std::to_string(pos) + ": \"" + line + "\".");
+    }
+    output(node);
+  }
+  catch (const Exception& e) {
+    std::cout << "Failed to read the file." << std::endl;
+    std::cout << e.what() << std::endl;
+    loading.erase(canonical);
+    file.close();
+    throw;
+  }
+  loading.erase(canonical);
+  file.close();
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+FunctionGraph<dim_inp, dim_out>::FunctionGraph(const FunctionGraph<dim_inp, dim_out>& g)
+  : Function<dim_inp, dim_out>(), m_nodes(g.m_nodes), m_index(g.m_index), m_output(g.m_output),
+    m_schedule(g.m_schedule), m_slots(g.m_slots), m_buffers(g.m_buffers) {}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+bool FunctionGraph<dim_inp, dim_out>::Key::operator==(const Key& other) const {
+  return type == other.type && left == other.left && right == other.right && payload == other.payload;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+std::size_t FunctionGraph<dim_inp, dim_out>::KeyHash::operator()(const Key& key) const {
+  std::uint64_t h = (std::uint64_t)key.type;
+  for (std::uint64_t v : {(std::uint64_t)key.left, (std::uint64_t)key.right, key.payload}) {
+    h ^= v + 0x9E3779B97F4A7C15ull + (h << 6) + (h >> 2);
+  }
+  return (std::size_t)h;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+std::size_t FunctionGraph<dim_inp, dim_out>::insert(const Key& key, const Node& node) {
+  auto it = m_index.find(key);
+  if (it != m_index.end()) {
+    return it->second;
+  }
+  m_nodes.push_back(node);
+  m_index[key] = m_nodes.size() - 1;
+  return m_nodes.size() - 1;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+std::size_t FunctionGraph<dim_inp, dim_out>::function(std::shared_ptr<const Function<dim_inp, dim_out>> f) {
+  if (!f) {
+    throw InvalidInputException("The function of a node must not be null.");
+  }
+  Key key = {NodeType::Function, 0, 0, (std::uint64_t)reinterpret_cast<std::uintptr_t>(f.get())};
+  return insert(key, Node{NodeType::Function, 0, 0, 0., f});
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+std::size_t FunctionGraph<dim_inp, dim_out>::constant(double value) {
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  Key key = {NodeType::Constant, 0, 0, bits};
+  return insert(key, Node{NodeType::Constant, 0, 0, value, nullptr});
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+std::size_t FunctionGraph<dim_inp, dim_out>::combine(NodeType type, std::size_t left, std::size_t right) {
+  if (type == NodeType::Function || type == NodeType::Constant) {
+    throw InvalidInputException("The type of a combination must be an operation.");
+  }
+  if (left >= m_nodes.size() || right >= m_nodes.size()) {
+    throw InvalidInputException("The operands of a combination must be nodes of the graph.");
+  }
+  // The sums and the products are commutative (also in floating-point arithmetic)
+  if ((type == NodeType::Sum || type == NodeType::Mul) && right < left) {
+    std::swap(left, right);
+  }
+  Key key = {type, left, right, 0};
+  return insert(key, Node{type, left, right, 0., nullptr});
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+void FunctionGraph<dim_inp, dim_out>::output(std::size_t node) {
+  if (node >= m_nodes.size()) {
+    throw InvalidInputException("The output must be a node of the graph.");
+  }
+  m_output = node;
+
+  // Find the nodes which the output depends on (the operands are before their users)
+  std::vector<bool> needed(node + 1, false);
+  needed[node] = true;
+  for (std::size_t k = node + 1; k-- > 0;) {
+    const Node& nd = m_nodes[k];
+    if (needed[k] && nd.type != NodeType::Function && nd.type != NodeType::Constant) {
+      needed[nd.left] = true;
+      needed[nd.right] = true;
+    }
+  }
+  m_schedule.clear();
+  for (std::size_t k = 0; k <= node; ++k) {
+    if (needed[k]) m_schedule.push_back(k);
+  }
+
+  // Find the last use of each node in the schedule
+  std::vector<std::size_t> last(node + 1, 0);
+  for (std::size_t p = 0; p < m_schedule.size(); ++p) {
+    const Node& nd = m_nodes[m_schedule[p]];
+    if (nd.type != NodeType::Function && nd.type != NodeType::Constant) {
+      last[nd.left] = p;
+      last[nd.right] = p;
+    }
+  }
+  last[node] = m_schedule.size();
+
+  // Assign the buffers: the buffer of an operand is released at its last use, and since the
+  // operations are applied element by element, the result can overwrite the buffer of an operand
+  std::vector<std::size_t> released;
+  m_slots.assign(node + 1, 0);
+  m_buffers = 0;
+  for (std::size_t p = 0; p < m_schedule.size(); ++p) {
+    const Node& nd = m_nodes[m_schedule[p]];
+    if (nd.type != NodeType::Function && nd.type != NodeType::Constant) {
+      if (last[nd.left] == p) released.push_back(m_slots[nd.left]);
+      if (last[nd.right] == p && nd.right != nd.left) released.push_back(m_slots[nd.right]);
+    }
+    if (released.empty()) {
+      m_slots[m_schedule[p]] = m_buffers++;
+    }
+    else {
+      m_slots[m_schedule[p]] = released.back();
+      released.pop_back();
+    }
+  }
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+std::size_t FunctionGraph<dim_inp, dim_out>::size() const {
+  return m_nodes.size();
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+std::size_t FunctionGraph<dim_inp, dim_out>::buffers() const {
+  return m_buffers;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+std::uint64_t FunctionGraph<dim_inp, dim_out>::domain_errors() const {
+  std::uint64_t errors = Function<dim_inp, dim_out>::domain_errors();
+  for (const Node& nd : m_nodes) {
+    if (nd.type == NodeType::Function) {
+      errors += nd.function->domain_errors();
+    }
+  }
+  return errors;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+std::size_t FunctionGraph<dim_inp, dim_out>::parse_sum(
+  const std::string& text, std::size_t& pos, const std::map<std::string, std::size_t>& names) {
+  std::size_t node = parse_product(text, pos, names);
+  while (true) {
+    while (pos < text.size() && std::isspace((unsigned char)text[pos])) ++pos;
+    if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) {
+      NodeType type = (text[pos++] == '+') ? NodeType::Sum : NodeType::Sub;
+      node = combine(type, node, parse_product(text, pos, names));
+    }
+    else {
+      return node;
+    }
+  }
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+std::size_t FunctionGraph<dim_inp, dim_out>::parse_product(
+  const std::string& text, std::size_t& pos, const std::map<std::string, std::size_t>& names) {
+  std::size_t node = parse_factor(text, pos, names);
+  while (true) {
+    while (pos < text.size() && std::isspace((unsigned char)text[pos])) ++pos;
+    if (pos < text.size() && (text[pos] == '*' || text[pos] == '/')) {
+      NodeType type = (text[pos++] == '*') ? NodeType::Mul : NodeType::Div;
+      node = combine(type, node, parse_factor(text, pos, names));
+    }
+    else {
+      return node;
+    }
+  }
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+std::size_t FunctionGraph<dim_inp, dim_out>::parse_factor(
+  const std::string& text, std::size_t& pos, const std::map<std::string, std::size_t>& names) {
+  while (pos < text.size() && std::isspace((unsigned char)text[pos])) ++pos;
+  if (pos == text.size()) {
+    throw InvalidInputException("Unexpected end of the expression: \"" + text + "\".");
+  }
+
+  // Negation
+  if (text[pos] == '-') {
+    ++pos;
+    std::size_t zero = constant(0.);
+    return combine(NodeType::Sub, zero, parse_factor(text, pos, names));
+  }
+  // Expression in parentheses
+  if (text[pos] == '(') {
+    ++pos;
+    std::size_t node = parse_sum(text, pos, names);
+    while (pos < text.size() && std::isspace((unsigned char)text[pos])) ++pos;
+    if (pos == text.size() || text[pos] != ')') {
+      throw InvalidInputException("Missing closing parenthesis: \"" + text + "\".");
+    }
+    ++pos;
+    return node;
+  }
+  // Name of a function
+  if (std::isalpha((unsigned char)text[pos]) || text[pos] == '_') {
+    std::size_t begin = pos;
+    while (pos < text.size() && (std::isalnum((unsigned char)text[pos]) || text[pos] == '_')) ++pos;
+    std::string name = text.substr(begin, pos - begin);
+    auto it = names.find(name);
+    if (it == names.end()) {
+      throw InvalidInputException("Unknown function name: \"" + name + "\".");
+    }
+    return it->second;
+  }
+  // Number
+  const char* begin = text.c_str() + pos;
+  char* end;
+  double value = std::strtod(begin, &end);
+  if (end == begin) {
+    throw InvalidInputException("Unexpected character at position " + std::to_string(pos) + ": \"" + text + "\".");
+  }
+  pos += end - begin;
+  return constant(value);
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+void FunctionGraph<dim_inp, dim_out>::apply(NodeType type, const double* a, const double* b, double* out, std::size_t n) {
+  switch (type) {
+    case NodeType::Sum:
+      for (std::size_t i = 0; i < n; ++i) out[i] = a[i] + b[i];
+      break;
+    case NodeType::Sub:
+      for (std::size_t i = 0; i < n; ++i) out[i] = a[i] - b[i];
+      break;
+    case NodeType::Mul:
+      for (std::size_t i = 0; i < n; ++i) out[i] = a[i] * b[i];
+      break;
+    case NodeType::Div:
+      for (std::size_t i = 0; i < n; ++i) out[i] = a[i] / b[i];
+      break;
+    default:
+      break;
+  }
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+Vector<dim_out> FunctionGraph<dim_inp, dim_out>::call(const Vector<dim_inp>& x) const {
+  Vector<dim_out> y;
+  this->call_batch(&x[0], 1, &y[0], 1, 1);
+  return y;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+void FunctionGraph<dim_inp, dim_out>::call_batch(const double* x, std::size_t ldx, double* y, std::size_t ldy, std::size_t n) const {
+  if (m_schedule.empty()) {
+    throw InvalidInputException("The output of the graph is not set.");
+  }
+
+  // Lease the scratch buffers from the shared pool
+  const std::size_t block = dim_out * SAMPLE_BLOCK_SIZE;
+  BufferPool::Buffer scratch = BufferPool::shared().acquire(m_buffers * block);
+  double* buffers = scratch.data();
+
+  for (std::size_t start = 0; start < n; start += SAMPLE_BLOCK_SIZE) {
+    std::size_t m = std::min<std::size_t>(SAMPLE_BLOCK_SIZE, n - start);
+    for (std::size_t k : m_schedule) {
+      const Node& nd = m_nodes[k];
+      double* out = buffers + m_slots[k] * block;
+      if (nd.type == NodeType::Function) {
+        (*nd.function)(x + start, ldx, out, SAMPLE_BLOCK_SIZE, m);
+      }
+      else if (nd.type == NodeType::Constant) {
+        for (unsigned int d = 0; d < dim_out; ++d) {
+          std::fill(out + d * SAMPLE_BLOCK_SIZE, out + d * SAMPLE_BLOCK_SIZE + m, nd.value);
+        }
+      }
+      else {
+        const double* a = buffers + m_slots[nd.left] * block;
+        const double* b = buffers + m_slots[nd.right] * block;
+        for (unsigned int d = 0; d < dim_out; ++d) {
+          apply(nd.type, a + d * SAMPLE_BLOCK_SIZE, b + d * SAMPLE_BLOCK_SIZE, out + d * SAMPLE_BLOCK_SIZE, m);
+        }
+      }
+    }
+
+    // Copy the outputs
+    const double* out = buffers + m_slots[m_output] * block;
+    for (unsigned int d = 0; d < dim_out; ++d) {
+      std::copy(out + d * SAMPLE_BLOCK_SIZE, out + d * SAMPLE_BLOCK_SIZE + m, y + d * ldy + start);
+    }
+  }
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+std::shared_ptr<Function<dim_inp, dim_out>> load_function(const std::string& filepath) {
+  // Read the function type
+  std::ifstream file(filepath);
+  if (!file.is_open()) {
+    throw InvalidInputException("Could not open file: " + filepath + ".");
+  }
+  std::string functype;
+  std::getline(file, functype);
+  file.close();
+
+  // Construct the function dynamically
+  if (functype == "linear") {
+    return std::make_shared<Linear<dim_inp, dim_out>>(filepath);
+  }
+  else if (functype == "multivariatepolynomial") {
+    return std::make_shared<MultivariatePolynomial<dim_inp, dim_out>>(filepath);
+  }
+  else if (functype == "polynomial") {
+    return std::make_shared<Polynomial<dim_inp, dim_out>>(filepath);
+  }
+  else if (functype == "sumexponential") {
+    return std::make_shared<SumExponential<dim_inp, dim_out>>(filepath);
+  }
+  else if (functype == "sumlogarithm") {
+    return std::make_shared<SumLogarithm<dim_inp, dim_out>>(filepath);
+  }
+  else if (functype == "combination") {
+    return std::make_shared<FunctionGraph<dim_inp, dim_out>>(filepath);
+  }
+  else {
+    throw FunctionNotSupported(functype + " is not supported.");
+  }
+}
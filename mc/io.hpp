@@ -2,12 +2,20 @@
 #define MC_IO_HPP
 
 #include "functions.hpp"
+#include "graph.hpp"
+#include "analytic.hpp"
 #include "distributions.hpp"
 #include "mca.hpp"
+#include "control.hpp"
 #include "exceptions.hpp"
+#include "parallel.hpp"
 
 #include <string>
 #include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <filesystem>
 #include <set>
 #include <map>
 #include <memory>
@@ -16,6 +24,7 @@
 #include <sstream>
 #include <iomanip>
 #include <utility>
+#include <numeric>
 #include <sys/types.h>
 #include <sys/stat.h>
 
@@ -32,6 +41,21 @@ void write_line(std::ostream& stream, char symbol = '-', int width = 80);
 template <unsigned int dim>
 void write_csv(std::ostream& stream, const std::vector<Vector<dim>>& data);
 
+/// @brief Exports a block of samples to a stream in CSV format (one sample per line).
+/// @tparam dim The dimension of the samples.
+/// @param stream The output stream.
+/// @param data The samples.
+template <unsigned int dim>
+void write_csv(std::ostream& stream, const SampleBlock<dim>& data);
+
+/// @brief Exports a block of weighted samples to a stream in CSV format (the weight is the last column).
+/// @tparam dim The dimension of the samples.
+/// @param stream The output stream.
+/// @param data The samples.
+/// @param weights The weights of the samples.
+template <unsigned int dim>
+void write_csv(std::ostream& stream, const SampleBlock<dim>& data, const std::vector<double>& weights);
+
 /// @brief Class for parsing the input arguments and storing them.
 class ArgParser
 {
@@ -56,7 +80,23 @@ public:
   /// @brief Distribution name
   std::string dist;
   /// @brief Number of samples
-  int n_samples;
+  std::uint64_t n_samples;
+  /// @brief Flag for accumulating the samples in chunks without storing them
+  bool stream;
+  /// @brief Number of samples in each chunk of the streaming mode
+  std::size_t chunk;
+  /// @brief Number of threads
+  unsigned int threads;
+  /// @brief Use of the closed-form moments ("auto", "off", or "check")
+  std::string analytic;
+  /// @brief Number of independent replicates of the approximations
+  unsigned int replicates;
+  /// @brief Flag for pairing the samples with their reflections around the mean (antithetic variates)
+  bool antithetic;
+  /// @brief Highest power of the inputs used as control variates (0 without control variates)
+  unsigned int control;
+  /// @brief Scale of the spread of the proposal distribution of importance sampling (0 without importance sampling)
+  double proposal;
   /// @brief Path to output directory
   std::string output;
   /// @brief Falg for saving plots
@@ -88,21 +128,78 @@ public:
   /// @brief Launch the main workflow.
   void launch();
 
-  /// @brief Launch the workflow for calculating errors of the central limit theorem.
-  std::pair<Vector<dim_out>, Vector<dim_out>> clt(int n = 10);
-
-  /// @brief Launch the workflow for calculating errors of the central limit theorem.
-  void write_report(std::ostream& stream, const std::map<std::string, Eigen::VectorXd>& stats);
+  /**
+   * @brief Launch the workflow for checking the central limit theorem.
+   * One extra stream of n_samples function samples is split into consecutive blocks of each size,
+   * and the means of the blocks are accumulated. All the sizes reuse the same samples, and the chunks
+   * of the stream are processed in parallel. The chunk size is rounded up to a multiple of all the sizes
+   * so that the blocks never overlap two chunks, and the incomplete last block is dropped.
+   * @param sizes The sizes of the blocks (number of samples of each empirical mean).
+   * @return std::vector<MomentAccumulator<dim_out>> The accumulated block means for each size.
+   */
+  std::vector<MomentAccumulator<dim_out>> clt(const std::vector<unsigned int>& sizes);
+
+  /**
+   * @brief Write the information about the approximation and the approximated statistics.
+   * @param stream The output stream.
+   * @param stats The approximated statistics.
+   * @param domain_errors The number of evaluations outside of the domain of the function for the statistics.
+   */
+  void write_report(std::ostream& stream, const std::map<std::string, Eigen::VectorXd>& stats,
+    std::uint64_t domain_errors);
+
+  /**
+   * @brief Write the errors of the approximated statistics against their exact values.
+   * @param stream The output stream.
+   * @param stats The approximated statistics.
+   * @param exact The exact statistics, with the same names.
+   */
+  void write_check(std::ostream& stream, const std::map<std::string, Eigen::VectorXd>& stats,
+    const std::map<std::string, Eigen::VectorXd>& exact);
+
+  /// @brief Return the statistics of the report calculated by an approximator.
+  std::map<std::string, Eigen::VectorXd> statistics(MonteCarloApproximator<dim_out>& mca) const;
+
+  /**
+   * @brief Return the means of the statistics of the replicates and their standard errors.
+   * Each statistic is calculated for each replicate (see Function::replicate), and the standard error
+   * of its mean is the standard deviation of the replicates divided by the square root of their number.
+   * @param errors The standard errors of the means of the statistics, with the same names.
+   * @return std::map<std::string, Eigen::VectorXd> The means of the statistics.
+   */
+  std::map<std::string, Eigen::VectorXd> replicate_statistics(std::map<std::string, Eigen::VectorXd>& errors) const;
+
+  /**
+   * @brief Write a section of named values (e.g., the standard errors of the statistics of the replicates).
+   * @param stream The output stream.
+   * @param title The title of the section.
+   * @param values The values.
+   */
+  void write_section(std::ostream& stream, const std::string& title, const std::map<std::string, Eigen::VectorXd>& values);
 
 protected:
   /// @brief Argument parser.
   const ArgParser& m_parser;
   /// @brief Function of interest.
-  Function<dim_inp, dim_out>* m_function;
+  std::shared_ptr<Function<dim_inp, dim_out>> m_function;
   /// @brief Source distribution.
   Distribution<dim_inp>* m_distribution;
+  /// @brief Proposal distribution of importance sampling (null without importance sampling).
+  Distribution<dim_inp>* m_proposal = nullptr;
   /// @brief Monte Carlo approximator.
   MonteCarloApproximator<dim_out> m_mca;
+  /// @brief Approximator of the exact moments, if they are known in closed form (see analytic_moments).
+  MonteCarloApproximator<dim_out> m_exact;
+  /// @brief Whether the exact moments are known.
+  bool m_analytic;
+  /// @brief Whether the exact moments are reported instead of the approximations.
+  bool m_use_exact;
+  /// @brief The accumulated moments of the replicates (empty without replicates).
+  std::vector<MomentAccumulator<dim_out>> m_replicates;
+  /// @brief The accumulated means of the antithetic pairs (empty without antithetic variates).
+  MomentAccumulator<dim_out> m_pairs;
+  /// @brief The accumulated controls and outputs (empty without control variates).
+  ControlVariateAccumulator<dim_inp, dim_out> m_control;
 };
 
 #include "io.tpp"
@@ -15,6 +15,20 @@ void write_csv(std::ostream& stream, const std::vector<Vector<dim>>& data) {
   }
 }
 
+template <unsigned int dim>
+void write_csv(std::ostream& stream, const SampleBlock<dim>& data) {
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    stream << data[i] << std::endl;
+  }
+}
+
+template <unsigned int dim>
+void write_csv(std::ostream& stream, const SampleBlock<dim>& data, const std::vector<double>& weights) {
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    stream << data[i] << ", " << weights[i] << std::endl;
+  }
+}
+
 ArgParser::ArgParser(int argc, char* argv[])
   : args(std::vector<std::string>(argv, argv + argc))
 {
@@ -30,9 +44,17 @@ void ArgParser::parse() {
   auto pos_output = std::find(args.begin(), args.end(), "--output");
   auto pos_plot = std::find(args.begin(), args.end(), "--plot");
   auto pos_clt = std::find(args.begin(), args.end(), "--clt");
+  auto pos_stream = std::find(args.begin(), args.end(), "--stream");
+  auto pos_chunk = std::find(args.begin(), args.end(), "--chunk");
+  auto pos_threads = std::find(args.begin(), args.end(), "--threads");
+  auto pos_analytic = std::find(args.begin(), args.end(), "--analytic");
+  auto pos_replicates = std::find(args.begin(), args.end(), "--replicates");
+  auto pos_antithetic = std::find(args.begin(), args.end(), "--antithetic");
+  auto pos_control = std::find(args.begin(), args.end(), "--control");
+  auto pos_proposal = std::find(args.begin(), args.end(), "--proposal");
 
   // Set the function file
-  std::set<std::string> allowed_functypes = {"polynomial", "sumexponential", "sumlogarithm", "multivariatepolynomial", "linear"};
+  std::set<std::string> allowed_functypes = {"polynomial", "sumexponential", "sumlogarithm", "multivariatepolynomial", "linear", "combination"};
   if (pos_function != args.end()) {
     function = *(pos_function + 1);
     // Check existence of the file
@@ -94,7 +116,7 @@ void ArgParser::parse() {
   }
 
   // Set the distribution
-  std::set<std::string> allowed_dists = {"normal", "uniform"};
+  std::set<std::string> allowed_dists = {"normal", "uniform", "sobol-normal", "sobol-uniform", "halton-normal", "halton-uniform"};
   if (pos_dist != args.end()) {
     dist = *(pos_dist + 1);
     if (std::find(allowed_dists.begin(), allowed_dists.end(), dist) == allowed_dists.end()) {
@@ -108,10 +130,14 @@ void ArgParser::parse() {
   // Set the number of the samples
   if (pos_n != args.end()) {
     try {
-      n_samples = std::stoi(*(pos_n + 1));
+      if ((pos_n + 1)->find('-') != std::string::npos) {
+        throw std::invalid_argument(*(pos_n + 1));
+      }
+      n_samples = std::stoull(*(pos_n + 1));
+      if (n_samples == 0) { throw std::invalid_argument(*(pos_n + 1)); }
     }
-    catch (std::invalid_argument &e){
-      throw InvalidArgumentException("-k", "Number of samples (n) must be an integer (\"" + *(pos_n + 1) + "\").");
+    catch (std::logic_error &e){
+      throw InvalidArgumentException("-n", "Number of samples (n) must be a positive 64-bit integer (\"" + *(pos_n + 1) + "\").");
     }
   }
   else {
@@ -150,75 +176,357 @@ void ArgParser::parse() {
   else {
     clt = false;
   }
-}
 
-template <unsigned int dim_inp, unsigned int dim_out>
-Workflow<dim_inp, dim_out>::Workflow(const ArgParser& parser)
-  : m_parser(parser)
-{
-  // Construct the function dynamically
-  if ((m_parser.functype == "linear")) {
-    m_function = new Linear<dim_inp, dim_out>(m_parser.function);
+  // Set the streaming argument
+  if (pos_stream != args.end()) {
+    if (*(pos_stream + 1) != "0" && *(pos_stream + 1) != "1") {
+      throw InvalidArgumentException("--stream", "Stream argument must be 0 or 1.");
+    }
+    stream = (*(pos_stream + 1) == "1");
+  }
+  else {
+    stream = false;
+  }
+
+  // Set the chunk size of the streaming mode
+  if (pos_chunk != args.end()) {
+    try {
+      if ((pos_chunk + 1)->find('-') != std::string::npos) {
+        throw std::invalid_argument(*(pos_chunk + 1));
+      }
+      chunk = std::stoull(*(pos_chunk + 1));
+    }
+    catch (std::logic_error &e){
+      throw InvalidArgumentException("--chunk", "Chunk size must be a positive integer (\"" + *(pos_chunk + 1) + "\").");
+    }
+    if (chunk == 0) {
+      throw InvalidArgumentException("--chunk", "Chunk size must be a positive integer (\"" + *(pos_chunk + 1) + "\").");
+    }
+  }
+  else {
+    chunk = MCA_CHUNK_SIZE;
+  }
+
+  // Set the number of threads
+  if (pos_threads != args.end()) {
+    int value;
+    try {
+      value = std::stoi(*(pos_threads + 1));
+    }
+    catch (std::logic_error &e){
+      throw InvalidArgumentException("--threads", "Number of threads must be an integer (\"" + *(pos_threads + 1) + "\").");
+    }
+    if (value < 1) {
+      throw InvalidArgumentException("--threads", "Number of threads must be positive (\"" + *(pos_threads + 1) + "\").");
+    }
+    threads = value;
+  }
+  else {
+    threads = default_threads();
+  }
+
+  // Set the use of the closed-form moments
+  std::set<std::string> allowed_analytic = {"auto", "off", "check"};
+  if (pos_analytic != args.end()) {
+    analytic = *(pos_analytic + 1);
+    if (std::find(allowed_analytic.begin(), allowed_analytic.end(), analytic) == allowed_analytic.end()) {
+      throw InvalidArgumentException("--analytic", "Analytic argument must be \"auto\", \"off\", or \"check\".");
+    }
+  }
+  else {
+    analytic = "auto";
+  }
+
+  // Set the number of replicates
+  if (pos_replicates != args.end()) {
+    int value;
+    try {
+      value = std::stoi(*(pos_replicates + 1));
+    }
+    catch (std::logic_error &e){
+      throw InvalidArgumentException("--replicates", "Number of replicates must be an integer (\"" + *(pos_replicates + 1) + "\").");
+    }
+    if (value < 1) {
+      throw InvalidArgumentException("--replicates", "Number of replicates must be positive (\"" + *(pos_replicates + 1) + "\").");
+    }
+    replicates = value;
+  }
+  else {
+    replicates = 1;
+  }
+
+  // Set the antithetic argument
+  if (pos_antithetic != args.end()) {
+    if (*(pos_antithetic + 1) != "0" && *(pos_antithetic + 1) != "1") {
+      throw InvalidArgumentException("--antithetic", "Antithetic argument must be 0 or 1.");
+    }
+    antithetic = (*(pos_antithetic + 1) == "1");
   }
-  else if ((m_parser.functype == "multivariatepolynomial")) {
-    m_function = new MultivariatePolynomial<dim_inp, dim_out>(m_parser.function);
+  else {
+    antithetic = false;
+  }
+  if (antithetic && replicates > 1) {
+    throw InvalidArgumentException("--antithetic", "Antithetic variates cannot be combined with replicates.");
+  }
+
+  // Set the degree of the control variates
+  if (pos_control != args.end()) {
+    int value;
+    try {
+      value = std::stoi(*(pos_control + 1));
+    }
+    catch (std::logic_error &e){
+      throw InvalidArgumentException("--control", "Degree of the control variates must be an integer (\"" + *(pos_control + 1) + "\").");
+    }
+    if (value < 0) {
+      throw InvalidArgumentException("--control", "Degree of the control variates must be non-negative (\"" + *(pos_control + 1) + "\").");
+    }
+    control = value;
   }
-  else if ((m_parser.functype == "polynomial")) {
-    m_function = new Polynomial<dim_inp, dim_out>(m_parser.function);
+  else {
+    control = 0;
   }
-  else if ((m_parser.functype == "sumexponential")) {
-    m_function = new SumExponential<dim_inp, dim_out>(m_parser.function);
+  if (control > 0 && (antithetic || replicates > 1)) {
+    throw InvalidArgumentException("--control", "Control variates cannot be combined with replicates or antithetic variates.");
   }
-  else if ((m_parser.functype == "sumlogarithm")) {
-    m_function = new SumLogarithm<dim_inp, dim_out>(m_parser.function);
+
+  // Set the scale of the proposal distribution
+  if (pos_proposal != args.end()) {
+    try {
+      proposal = std::stod(*(pos_proposal + 1));
+    }
+    catch (std::logic_error &e){
+      throw InvalidArgumentException("--proposal", "Proposal scale must be a number (\"" + *(pos_proposal + 1) + "\").");
+    }
+    if (!(proposal >= 0.)) {
+      throw InvalidArgumentException("--proposal", "Proposal scale must be non-negative (\"" + *(pos_proposal + 1) + "\").");
+    }
   }
   else {
-    throw FunctionNotSupported(m_parser.functype + " is not supported.");
+    proposal = 0.;
+  }
+  if (proposal > 0. && (stream || antithetic || control > 0 || replicates > 1)) {
+    throw InvalidArgumentException("--proposal",
+      "Importance sampling cannot be combined with the streaming mode, replicates, antithetic, or control variates.");
   }
+}
 
-  // Construct the distibution and MCA
+template <unsigned int dim_inp, unsigned int dim_out>
+Workflow<dim_inp, dim_out>::Workflow(const ArgParser& parser)
+  : m_parser(parser)
+{
+  // Construct the function dynamically
+  m_function = load_function<dim_inp, dim_out>(m_parser.function);
+
+  // Construct the distibution (quasi-random distributions are prefixed with their sequence)
+  std::string dist = m_parser.dist;
+  std::string sequence;
+  std::size_t dash = dist.find('-');
+  if (dash != std::string::npos) {
+    sequence = dist.substr(0, dash);
+    dist = dist.substr(dash + 1);
+  }
   // TODO: Parameterize bounds
-  if (m_parser.dist == "uniform") {
+  if (dist == "uniform") {
     m_distribution = new Uniform<dim_inp>(0., 1.);
-    m_mca = m_function->mca(m_parser.n_samples, *m_distribution);
   }
   // TODO: Parameterize mean and variance
-  else if (m_parser.dist == "normal") {
+  else if (dist == "normal") {
     m_distribution = new Normal<dim_inp>(0., 1.);
-    m_mca = m_function->mca(m_parser.n_samples, *m_distribution);
   }
   else {
     throw InvalidArgumentException("--dist");
   }
+
+  // The proposal of importance sampling has the same center and a spread scaled by --proposal
+  const double scale = m_parser.proposal;
+  if (scale > 0. && dist == "uniform") {
+    if (scale < 1.) {
+      throw InvalidArgumentException("--proposal", "The proposal of a uniform distribution must cover its bounds (scale >= 1).");
+    }
+    m_proposal = new Uniform<dim_inp>(0.5 - 0.5 * scale, 0.5 + 0.5 * scale);
+  }
+  else if (scale > 0.) {
+    m_proposal = new Normal<dim_inp>(0., scale * scale);
+  }
+  // The sequences are randomized for the error estimates of the replicates
+  bool randomized = m_parser.replicates > 1;
+  if (sequence == "sobol") {
+    m_distribution->set_sequence(std::make_shared<SobolSequence>(dim_inp, randomized));
+  }
+  else if (sequence == "halton") {
+    m_distribution->set_sequence(std::make_shared<HaltonSequence>(dim_inp, randomized));
+  }
+  else if (!sequence.empty()) {
+    throw InvalidArgumentException("--dist");
+  }
+  if (m_proposal) {
+    m_proposal->set_sequence(m_distribution->sequence());
+  }
+
+  // Calculate the exact moments if they are known in closed form
+  unsigned int order = std::max<unsigned int>(MCA_DEFAULT_ORDER, std::max(m_parser.order, 0));
+  m_analytic = false;
+  if (m_parser.analytic != "off") {
+    MomentAccumulator<dim_out> exact;
+    m_analytic = analytic_moments(*m_function, *m_distribution, order, exact);
+    if (m_analytic) {
+      m_exact = MonteCarloApproximator<dim_out>(exact);
+    }
+  }
+
+  // The exact moments replace the approximations unless an estimator, the streaming mode, or a quasi-random
+  // sequence is requested explicitly, whose approximations are then checked against the exact moments
+  const bool estimator = m_parser.replicates > 1 || m_parser.antithetic || m_parser.control > 0 || m_proposal
+    || m_parser.stream || !sequence.empty();
+  m_use_exact = m_analytic && m_parser.analytic == "auto" && !estimator;
+
+  // Construct the MCA, from the exact moments, or from the accumulated moments of the replicates,
+  // of the antithetic pairs, of the control variates, or of the streaming mode, or from the weighted samples
+  if (m_use_exact) {
+    m_mca = m_exact;
+  }
+  else if (m_parser.replicates > 1) {
+    m_replicates = m_function->replicate(
+      m_parser.n_samples, *m_distribution, m_parser.replicates, m_parser.chunk, order, m_parser.threads);
+    MomentAccumulator<dim_out> pooled(order);
+    for (const MomentAccumulator<dim_out>& replicate : m_replicates) {
+      pooled += replicate;
+    }
+    m_mca = MonteCarloApproximator<dim_out>(pooled);
+  }
+  else if (m_parser.antithetic) {
+    m_mca = MonteCarloApproximator<dim_out>(m_function->antithetic(
+      m_parser.n_samples, *m_distribution, m_pairs, m_parser.chunk, order, m_parser.threads));
+  }
+  else if (m_parser.control > 0) {
+    m_control = m_function->control(
+      m_parser.n_samples, *m_distribution, m_parser.control, m_parser.chunk, order, m_parser.threads);
+    m_mca = MonteCarloApproximator<dim_out>(m_control.moments());
+  }
+  else if (m_parser.stream) {
+    m_mca = MonteCarloApproximator<dim_out>(
+      m_function->accumulate(m_parser.n_samples, *m_distribution, m_parser.chunk, order, m_parser.threads));
+  }
+  else if (m_proposal) {
+    m_mca = m_function->mca(m_parser.n_samples, *m_proposal, *m_distribution, m_parser.threads);
+  }
+  else {
+    m_mca = m_function->mca(m_parser.n_samples, *m_distribution, m_parser.threads);
+  }
 }
 
 template <unsigned int dim_inp, unsigned int dim_out>
 Workflow<dim_inp, dim_out>::~Workflow() {
-  delete m_function;
   delete m_distribution;
+  delete m_proposal;
 }
 
 template <unsigned int dim_inp, unsigned int dim_out>
-void Workflow<dim_inp, dim_out>::launch() {
-  // Calculate the statistics
+std::map<std::string, Eigen::VectorXd> Workflow<dim_inp, dim_out>::statistics(MonteCarloApproximator<dim_out>& mca) const {
   std::map<std::string, Eigen::VectorXd> stats {
-    {"mean", m_mca.mean()},
-    {"variance", m_mca.var()},
-    {"std", m_mca.std()},
-    {"skewness", m_mca.skewness()},
-    {"kurtosis", m_mca.kurtosis()},
-    {"hyperskewness", m_mca.hyperskewness()},
-    {"hypertailedness", m_mca.hypertailedness()}
+    {"mean", mca.mean()},
+    {"variance", mca.var()},
+    {"std", mca.std()},
+    {"skewness", mca.skewness()},
+    {"kurtosis", mca.kurtosis()},
+    {"hyperskewness", mca.hyperskewness()},
+    {"hypertailedness", mca.hypertailedness()}
   };
   if (m_parser.order > 0) {
     stats.insert(
         {"moment ({" + std::to_string(m_parser.order) + "}, {" + m_parser.mode + "})",
-        m_mca.moment(m_parser.order, m_parser.mode)}
+        mca.moment(m_parser.order, m_parser.mode)}
     );
   }
+  return stats;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+std::map<std::string, Eigen::VectorXd> Workflow<dim_inp, dim_out>::replicate_statistics(
+  std::map<std::string, Eigen::VectorXd>& errors) const {
+  // Calculate the statistics of each replicate
+  std::vector<std::map<std::string, Eigen::VectorXd>> replicates;
+  for (const MomentAccumulator<dim_out>& accumulator : m_replicates) {
+    MonteCarloApproximator<dim_out> mca(accumulator);
+    replicates.push_back(statistics(mca));
+  }
+
+  // Average the replicates and calculate the standard errors from their spread
+  const double R = replicates.size();
+  std::map<std::string, Eigen::VectorXd> means;
+  errors.clear();
+  for (const auto& pair : replicates[0]) {
+    Eigen::VectorXd sum = Eigen::VectorXd::Zero(pair.second.size());
+    for (const auto& replicate : replicates) {
+      sum += replicate.at(pair.first);
+    }
+    Eigen::VectorXd mean = sum / R;
+    Eigen::VectorXd squares = Eigen::VectorXd::Zero(mean.size());
+    for (const auto& replicate : replicates) {
+      squares += (replicate.at(pair.first) - mean).cwiseAbs2();
+    }
+    means[pair.first] = mean;
+    errors[pair.first] = (squares / (R * (R - 1.))).cwiseSqrt();
+  }
+  return means;
+}
+
+template <unsigned int dim_inp, unsigned int dim_out>
+void Workflow<dim_inp, dim_out>::launch() {
+  // Calculate the statistics (the means of the replicates, if any)
+  std::map<std::string, Eigen::VectorXd> errors;
+  std::map<std::string, Eigen::VectorXd> stats = m_replicates.empty() ? statistics(m_mca) : replicate_statistics(errors);
+  // The CLT samples below also evaluate the function, so the domain errors are read beforehand
+  const std::uint64_t domain_errors = m_function->domain_errors();
+  bool check = m_analytic && !m_use_exact;
+  std::map<std::string, Eigen::VectorXd> exact;
+  if (check) {
+    exact = statistics(m_exact);
+  }
+
+  // Calculate the variance reduction of the antithetic variates
+  std::map<std::string, Eigen::VectorXd> antithetic;
+  if (m_pairs.count() > 1) {
+    antithetic["variance reduction"] = m_mca.var().array() / (2. * m_pairs.var().array());
+  }
+
+  // Calculate the variance reduction of the control variates
+  std::map<std::string, Eigen::VectorXd> control;
+  if (m_control.count() > 1) {
+    control["plain mean"] = m_control.plain_mean();
+    control["variance reduction"] = m_control.reduction();
+  }
+
+  // Calculate the effective sample size of importance sampling (without samples, there is no weight)
+  std::map<std::string, Eigen::VectorXd> importance;
+  if (m_mca.has_weights() && !m_mca.weights().empty()) {
+    const MomentAccumulator<dim_out>& accumulator = m_mca.accumulator();
+    const std::vector<double>& weights = m_mca.weights();
+    const double max_weight = *std::max_element(weights.begin(), weights.end());
+    importance["effective samples"] = Eigen::VectorXd::Constant(1, accumulator.ess());
+    importance["efficiency"] = Eigen::VectorXd::Constant(1, accumulator.ess() / accumulator.count());
+    importance["max weight"] = Eigen::VectorXd::Constant(1, max_weight / accumulator.weight());
+  }
 
   // Print the statistics to standard output
-  write_report(std::cout, stats);
+  std::string replicates = "STANDARD ERRORS (" + std::to_string(m_replicates.size()) + " REPLICATES)";
+  write_report(std::cout, stats, domain_errors);
+  if (!errors.empty()) {
+    write_section(std::cout, replicates, errors);
+  }
+  if (!antithetic.empty()) {
+    write_section(std::cout, "ANTITHETIC VARIATES", antithetic);
+  }
+  if (!control.empty()) {
+    write_section(std::cout, "CONTROL VARIATES", control);
+  }
+  if (!importance.empty()) {
+    write_section(std::cout, "IMPORTANCE SAMPLING", importance);
+  }
+  if (check) {
+    write_check(std::cout, stats, exact);
+  }
 
   // Generate clt convergence results
   if (m_parser.clt) {
@@ -226,11 +534,23 @@ void Workflow<dim_inp, dim_out>::launch() {
     write_line(std::cout, '-', w_line);
     std::cout << "CENTRAL LIMIT THEOREM" << std::endl;
     write_line(std::cout, '-', w_line);
-    for (int n = 10; n < 100; n += 40) {
-      auto errors = clt(n);
-      std::cout << std::left << std::setw(20) << "n = " + std::to_string(n) << std::endl;
-      std::cout << std::right << std::setw(20) << "err_rel_mean" << ": " << errors.first << std::endl;
-      std::cout << std::right << std::setw(20) << "err_rel_var" << ": " << errors.second << std::endl;
+    // Compare the block means with the reference statistics of the approximator
+    std::vector<unsigned int> sizes = {10, 50, 90};
+    auto means = clt(sizes);
+    Vector<dim_out> mean_the(m_mca.mean());
+    Vector<dim_out> var_the(m_mca.var());
+    for (std::size_t j = 0; j < sizes.size(); ++j) {
+      std::cout << std::left << std::setw(20) << "n = " + std::to_string(sizes[j]) << std::endl;
+      std::cout << std::right << std::setw(20) << "blocks" << ": " << means[j].count() << std::endl;
+      if (means[j].count() < 2) {
+        std::cout << std::right << std::setw(20) << "" << "  Not enough samples for this block size." << std::endl;
+        continue;
+      }
+      Vector<dim_out> mean_emp(means[j].mean());
+      Vector<dim_out> var_emp(means[j].var());
+      Vector<dim_out> var_the_n = var_the / sizes[j];
+      std::cout << std::right << std::setw(20) << "err_rel_mean" << ": " << (mean_the - mean_emp).abs() / mean_the << std::endl;
+      std::cout << std::right << std::setw(20) << "err_rel_var" << ": " << (var_the_n - var_emp).abs() / var_the_n << std::endl;
     }
     std::cout << std::endl;
   }
@@ -241,7 +561,22 @@ void Workflow<dim_inp, dim_out>::launch() {
     std::string reportfile = m_parser.output + "/" + "report.out";
     std::ofstream reportstream(reportfile);
     if (reportstream.is_open()) {
-      write_report(reportstream, stats);
+      write_report(reportstream, stats, domain_errors);
+      if (!errors.empty()) {
+        write_section(reportstream, replicates, errors);
+      }
+      if (!antithetic.empty()) {
+        write_section(reportstream, "ANTITHETIC VARIATES", antithetic);
+      }
+      if (!control.empty()) {
+        write_section(reportstream, "CONTROL VARIATES", control);
+      }
+      if (!importance.empty()) {
+        write_section(reportstream, "IMPORTANCE SAMPLING", importance);
+      }
+      if (check) {
+        write_check(reportstream, stats, exact);
+      }
       reportstream.close();
       std::cout << "Report is stored in \"" + reportfile + "\"." << std::endl;
     }
@@ -251,14 +586,28 @@ void Workflow<dim_inp, dim_out>::launch() {
 
     // Open a csv file in the output directory and export the samples
     std::string samplesfile = m_parser.output + "/" + "samples.csv";
-    std::ofstream samplesstream(samplesfile);
-    if (samplesstream.is_open()) {
-      write_csv(samplesstream, m_mca.data());
-      samplesstream.close();
-      std::cout << "Samples are exported to \"" + samplesfile + "\"." << std::endl;
+    if (!m_mca.has_data()) {
+      std::cout << (!m_replicates.empty() ? "Samples are not stored with replicates."
+        : m_parser.antithetic ? "Samples are not stored with antithetic variates."
+        : m_parser.control > 0 ? "Samples are not stored with control variates."
+        : m_parser.stream ? "Samples are not stored in the streaming mode."
+        : "Samples are not drawn for the exact moments.") << std::endl;
     }
     else {
-      std::cerr << "Error opening file: \"" << samplesfile << "\"." << std::endl;
+      std::ofstream samplesstream(samplesfile);
+      if (samplesstream.is_open()) {
+        if (m_mca.has_weights()) {
+          write_csv(samplesstream, m_mca.samples(), m_mca.weights());
+        }
+        else {
+          write_csv(samplesstream, m_mca.samples());
+        }
+        samplesstream.close();
+        std::cout << "Samples are exported to \"" + samplesfile + "\"." << std::endl;
+      }
+      else {
+        std::cerr << "Error opening file: \"" << samplesfile << "\"." << std::endl;
+      }
     }
 
     // TODO: Plot mca->samples and save it
@@ -270,7 +619,7 @@ void Workflow<dim_inp, dim_out>::launch() {
 
 template <unsigned int dim_inp, unsigned int dim_out>
 void Workflow<dim_inp, dim_out>::write_report(
-  std::ostream& stream, const std::map<std::string, Eigen::VectorXd>& stats) {
+  std::ostream& stream, const std::map<std::string, Eigen::VectorXd>& stats, std::uint64_t domain_errors) {
   // Set parameters
   int w_title = 20;
   int w_line = 80;
@@ -284,7 +633,26 @@ void Workflow<dim_inp, dim_out>::write_report(
   stream << std::left << std::setw(w_title) << "input dimension" << ": " << m_parser.dim_inp << std::endl;
   stream << std::left << std::setw(w_title) << "output dimension" << ": " << m_parser.dim_out << std::endl;
   stream << std::left << std::setw(w_title) << "srouce distribution" << ": " << m_parser.dist << std::endl;
+  stream << std::left << std::setw(w_title) << "moments" << ": "
+    << (m_use_exact ? "analytic" : "monte carlo") << std::endl;
   stream << std::left << std::setw(w_title) << "number of samples" << ": " << m_parser.n_samples << std::endl;
+  if (!m_replicates.empty()) {
+    stream << std::left << std::setw(w_title) << "replicates" << ": " << m_replicates.size() << std::endl;
+  }
+  if (m_parser.antithetic) {
+    stream << std::left << std::setw(w_title) << "antithetic pairs" << ": " << m_pairs.count() << std::endl;
+  }
+  if (m_parser.control > 0) {
+    stream << std::left << std::setw(w_title) << "control degree" << ": " << m_parser.control << std::endl;
+  }
+  if (m_proposal) {
+    stream << std::left << std::setw(w_title) << "proposal scale" << ": " << m_parser.proposal << std::endl;
+  }
+  if (m_parser.stream || !m_replicates.empty() || m_parser.antithetic || m_parser.control > 0) {
+    stream << std::left << std::setw(w_title) << "chunk size" << ": " << m_parser.chunk << std::endl;
+  }
+  stream << std::left << std::setw(w_title) << "number of threads" << ": " << m_parser.threads << std::endl;
+  stream << std::left << std::setw(w_title) << "domain errors" << ": " << domain_errors << std::endl;
   stream << std::left << std::setw(w_title) << "output directory" << ": " << m_parser.output << std::endl;
   stream << std::endl;
 
@@ -307,27 +675,96 @@ void Workflow<dim_inp, dim_out>::write_report(
   stream.flush();
 }
 
-// replace clt() with run()
-template<unsigned int dim_inp, unsigned int dim_out>
-std::pair<Vector<dim_out>, Vector<dim_out>> Workflow<dim_inp, dim_out>::clt(int n) {
+template <unsigned int dim_inp, unsigned int dim_out>
+void Workflow<dim_inp, dim_out>::write_section(std::ostream& stream, const std::string& title,
+  const std::map<std::string, Eigen::VectorXd>& values) {
+  // Set parameters
+  int w_title = 20;
+  int w_line = 80;
 
-  std::pair<Vector<dim_out>, Vector<dim_out>> relative_error;
+  // Set the numeric output settings
+  stream.setf(std::ios::scientific);
+  stream.setf(std::ios::showpos);
+  stream.precision(4);
 
-  // Get samples from the approximated mean distribution ($\mu_n$)
-  std::vector<Vector<dim_out>> means(m_parser.n_samples);
-  std::for_each(means.begin(), means.end(),
-    [this, n](auto& mean){mean = this->m_function->mean(n, *(this->m_distribution));});
+  // Write the values
+  write_line(stream, '-', w_line);
+  stream << title << std::endl;
+  write_line(stream, '-', w_line);
+  for (const auto& pair : values) {
+    stream << std::left << std::setw(w_title) << pair.first.c_str() << ": " << pair.second.transpose() << std::endl;
+  }
+  stream << std::endl;
+  stream.flush();
+}
 
-  // Get MC approximator from the means
-  MonteCarloApproximator<dim_out> mca(std::make_shared<std::vector<Vector<dim_out>>>(means));
+template <unsigned int dim_inp, unsigned int dim_out>
+void Workflow<dim_inp, dim_out>::write_check(std::ostream& stream, const std::map<std::string, Eigen::VectorXd>& stats,
+  const std::map<std::string, Eigen::VectorXd>& exact) {
+  // Set parameters
+  int w_title = 20;
+  int w_line = 80;
 
-  // Get the theoretical mean using a more accurate approximation
-  Vector<dim_out> mean_the = m_function->mean(m_parser.n_samples, *m_distribution);
-  relative_error.first = (mean_the - mca.mean()).abs() / mean_the;
+  // Set the numeric output settings
+  stream.setf(std::ios::scientific);
+  stream.setf(std::ios::showpos);
+  stream.precision(4);
 
-  // Get the theoretical variance using a more accurate approximation
-  Vector<dim_out> var_the = m_function->var(m_parser.n_samples, *m_distribution) / n;
-  relative_error.second = (var_the - mca.var()).abs() / var_the;
+  // Write the exact statistics and the absolute and relative errors of the approximations
+  write_line(stream, '-', w_line);
+  stream << "ANALYTIC CROSS-CHECK" << std::endl;
+  write_line(stream, '-', w_line);
+  for (const auto& pair : exact) {
+    const Eigen::VectorXd& value = pair.second;
+    Eigen::VectorXd error = (stats.at(pair.first) - value).cwiseAbs();
+    stream << std::left << std::setw(w_title) << pair.first.c_str() << ": " << value.reshaped(1, m_parser.dim_out) << std::endl;
+    stream << std::right << std::setw(w_title) << "err_abs" << ": " << error.reshaped(1, m_parser.dim_out) << std::endl;
+    stream << std::right << std::setw(w_title) << "err_rel" << ": "
+      << error.cwiseQuotient(value.cwiseAbs()).reshaped(1, m_parser.dim_out) << std::endl;
+  }
+  stream << std::endl;
+  stream.flush();
+}
 
-  return relative_error;
+template<unsigned int dim_inp, unsigned int dim_out>
+std::vector<MomentAccumulator<dim_out>> Workflow<dim_inp, dim_out>::clt(const std::vector<unsigned int>& sizes) {
+
+  // Round the chunk size up to a multiple of all the block sizes
+  std::size_t multiple = 1;
+  for (unsigned int size : sizes) {
+    multiple = std::lcm(multiple, std::max(size, 1u));
+  }
+  std::size_t chunk = ((m_parser.chunk + multiple - 1) / multiple) * multiple;
+
+  // Draw the samples from the stream which follows the ones of the replicates
+  const Philox& rng = m_distribution->rng();
+  Philox stream = rng.split(rng.stream() + std::max(1u, m_parser.replicates));
+
+  // Accumulate the block means of each thread
+  unsigned int threads = std::max(1u, m_parser.threads);
+  std::vector<std::vector<MomentAccumulator<dim_out>>> partial(
+    threads, std::vector<MomentAccumulator<dim_out>>(sizes.size(), MomentAccumulator<dim_out>(2)));
+  m_function->for_each_chunk(m_parser.n_samples, *m_distribution, stream, chunk, threads,
+    [&](unsigned int t, const double*, const double* outputs, std::size_t m) {
+      for (std::size_t j = 0; j < sizes.size(); ++j) {
+        for (std::size_t begin = 0; begin + sizes[j] <= m; begin += sizes[j]) {
+          Vector<dim_out> mean = 0.;
+          for (unsigned int d = 0; d < dim_out; ++d) {
+            for (std::size_t i = begin; i < begin + sizes[j]; ++i) {
+              mean[d] += outputs[d * m + i];
+            }
+            mean[d] /= sizes[j];
+          }
+          partial[t][j].add(mean);
+        }
+      }
+    });
+
+  // Merge the threads in order
+  for (unsigned int t = 1; t < threads; ++t) {
+    for (std::size_t j = 0; j < sizes.size(); ++j) {
+      partial[0][j] += partial[t][j];
+    }
+  }
+  return partial[0];
 }
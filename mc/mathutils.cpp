@@ -1,5 +1,12 @@
 #include "mathutils.hpp"
 
+#include <limits>
+#include <cstring>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 
 bool isequal(double a, double b) {
     if (abs(a - b) < DBL_EPSILON) {
@@ -28,7 +35,7 @@ std::vector<std::vector<double>> read_matrix(std::ifstream& fstream, int rows, i
     // Try reading the row and pushing it to the matrix
     try{
       std::vector<double> row = {std::istream_iterator<double>(linestream), std::istream_iterator<double>()};
-      if (row.size() != cols) {
+      if (row.size() != (std::size_t)cols) {
         throw InvalidInputException("Expected " + std::to_string(cols) + " columns, got " + std::to_string(row.size()) + ".");
       }
       mat[i] = row;
@@ -41,1038 +48,249 @@ std::vector<std::vector<double>> read_matrix(std::ifstream& fstream, int rows, i
   return mat;
 }
 
+/**
+ * @brief Evaluates the AS241 rational approximations.
+ * @param q The centered probability \f$ p - 0.5 \f$.
+ * @param r The tail probability \f$ \min(p, 1 - p) \f$, only used when \f$ |q| > 0.425 \f$.
+ * @return double The standard normal quantile.
+ */
+static inline double ppnd16(double q, double r) {
+  if (std::abs(q) <= 0.425) {
+    r = 0.180625 - q * q;
+    return q * (((((((2.5090809287301226727e+3 * r + 3.3430575583588128105e+4) * r
+      + 6.7265770927008700853e+4) * r + 4.5921953931549871457e+4) * r
+      + 1.3731693765509461125e+4) * r + 1.9715909503065514427e+3) * r
+      + 1.3314166789178437745e+2) * r + 3.3871328727963666080e+0)
+      / (((((((5.2264952788528545610e+3 * r + 2.8729085735721942674e+4) * r
+      + 3.9307895800092710610e+4) * r + 2.1213794301586595867e+4) * r
+      + 5.3941960214247511077e+3) * r + 6.8718700749205790830e+2) * r
+      + 4.2313330701600911252e+1) * r + 1.0);
+  }
+
+  double z;
+  r = std::sqrt(-std::log(r));
+  if (r <= 5.) {
+    r -= 1.6;
+    z = (((((((7.74545014278341407640e-4 * r + 2.27238449892691845833e-2) * r
+      + 2.41780725177450611770e-1) * r + 1.27045825245236838258e+0) * r
+      + 3.64784832476320460504e+0) * r + 5.76949722146069140550e+0) * r
+      + 4.63033784615654529590e+0) * r + 1.42343711074968357734e+0)
+      / (((((((1.05075007164441684324e-9 * r + 5.47593808499534494600e-4) * r
+      + 1.51986665636164571966e-2) * r + 1.48103976427480074590e-1) * r
+      + 6.89767334985100004550e-1) * r + 1.67638483018380384940e+0) * r
+      + 2.05319162663775882187e+0) * r + 1.0);
+  }
+  else {
+    r -= 5.;
+    z = (((((((2.01033439929228813265e-7 * r + 2.71155556874348757815e-5) * r
+      + 1.24266094738807843860e-3) * r + 2.65321895265761230930e-2) * r
+      + 2.96560571828504891230e-1) * r + 1.78482653991729133580e+0) * r
+      + 5.46378491116411436990e+0) * r + 6.65790464350110377720e+0)
+      / (((((((2.04426310338993978564e-15 * r + 1.42151175831644588870e-7) * r
+      + 1.84631831751005468180e-5) * r + 7.86869131145613259100e-4) * r
+      + 1.48753612908506148525e-2) * r + 1.36929880922735805310e-1) * r
+      + 5.99832206555887937690e-1) * r + 1.0);
+  }
+
+  return (q < 0.) ? -z : z;
+}
+
+double normal_quantile(double p) {
+  if (!(p >= 0. && p <= 1.)) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  if (p == 0. || p == 1.) {
+    return (p == 0.) ? -HUGE_VAL : HUGE_VAL;
+  }
+  double q = p - 0.5;
+  return ppnd16(q, (q < 0.) ? p : 1. - p);
+}
+
+void normal_quantile(const double* p, double* z, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) {
+    z[i] = normal_quantile(p[i]);
+  }
+}
+
 double erfinv(double v) {
-  if (v <= -1 || v >= +1) {
+  if (!(v > -1 && v < +1)) {
     std::string msg = "Cannot determine erfinv of " + std::to_string(v) + ".";
     throw InvalidInputException(msg);
   }
 
-  const std::map<double, double> ERFINV_CACHED {
-    {-1., -ERFINV_MAX},
-    {-0.997997997997998, -2.184914100111402},
-    {-0.995995995995996, -2.034944505904795},
-    {-0.993993993993994, -1.9427428645836293},
-    {-0.991991991991992, -1.875057668304139},
-    {-0.98998998998999, -1.821141723239352},
-    {-0.987987987987988, -1.7761046256096675},
-    {-0.985985985985986, -1.737293461196247},
-    {-0.983983983983984, -1.7031022997516432},
-    {-0.9819819819819819, -1.6724826501540264},
-    {-0.97997997997998, -1.6447108979563174},
-    {-0.977977977977978, -1.619265924931278},
-    {-0.975975975975976, -1.5957595708825718},
-    {-0.973973973973974, -1.5738946801696532},
-    {-0.9719719719719719, -1.5534385404325113},
-    {-0.96996996996997, -1.5342053858786309},
-    {-0.967967967967968, -1.516044482121948},
-    {-0.965965965965966, -1.4988317793083343},
-    {-0.963963963963964, -1.4824639207317467},
-    {-0.9619619619619619, -1.46685385002573},
-    {-0.95995995995996, -1.4519275298101737},
-    {-0.957957957957958, -1.4376214497616664},
-    {-0.955955955955956, -1.4238807060988299},
-    {-0.953953953953954, -1.4106575017426444},
-    {-0.9519519519519519, -1.3979099609311905},
-    {-0.94994994994995, -1.3856011821505718},
-    {-0.9479479479479479, -1.3736984739556921},
-    {-0.9459459459459459, -1.3621727327599775},
-    {-0.943943943943944, -1.3509979319906475},
-    {-0.9419419419419419, -1.3401506994501635},
-    {-0.93993993993994, -1.3296099651657514},
-    {-0.9379379379379379, -1.3193566660346148},
-    {-0.9359359359359359, -1.3093734965842507},
-    {-0.933933933933934, -1.2996446974439166},
-    {-0.9319319319319319, -1.290155874860998},
-    {-0.92992992992993, -1.2808938459342203},
-    {-0.9279279279279279, -1.271846505274998},
-    {-0.9259259259259259, -1.2630027096217715},
-    {-0.9239239239239239, -1.2543521775737605},
-    {-0.9219219219219219, -1.2458854021200585},
-    {-0.91991991991992, -1.237593574047231},
-    {-0.9179179179179179, -1.2294685146361781},
-    {-0.9159159159159159, -1.2215026163239986},
-    {-0.9139139139139139, -1.2136887902222333},
-    {-0.9119119119119119, -1.2060204195591928},
-    {-0.9099099099099099, -1.1984913182590078},
-    {-0.9079079079079079, -1.191095693989777},
-    {-0.9059059059059059, -1.1838281151124794},
-    {-0.9039039039039038, -1.1766834810450841},
-    {-0.9019019019019019, -1.1696569956255445},
-    {-0.8998998998998999, -1.1627441431155108},
-    {-0.8978978978978979, -1.1559406665356522},
-    {-0.8958958958958959, -1.149242548064982},
-    {-0.8938938938938938, -1.1426459912718114},
-    {-0.8918918918918919, -1.1361474049740106},
-    {-0.8898898898898899, -1.1297433885518924},
-    {-0.8878878878878879, -1.123430718559067},
-    {-0.8858858858858859, -1.1172063364955211},
-    {-0.8838838838838838, -1.1110673376234925},
-    {-0.8818818818818819, -1.105010960720841},
-    {-0.8798798798798799, -1.0990345786788154},
-    {-0.8778778778778779, -1.0931356898617852},
-    {-0.8758758758758759, -1.087311910155746},
-    {-0.8738738738738738, -1.0815609656405003},
-    {-0.8718718718718719, -1.0758806858275207},
-    {-0.8698698698698699, -1.0702689974116801},
-    {-0.8678678678678678, -1.0647239184905357},
-    {-0.8658658658658659, -1.0592435532096387},
-    {-0.8638638638638638, -1.0538260867965996},
-    {-0.8618618618618619, -1.0484697809504093},
-    {-0.8598598598598599, -1.0431729695558225},
-    {-0.8578578578578578, -1.0379340546955922},
-    {-0.8558558558558559, -1.0327515029359593},
-    {-0.8538538538538538, -1.0276238418631416},
-    {-0.8518518518518519, -1.0225496568506725},
-    {-0.8498498498498499, -1.0175275880392927},
-    {-0.8478478478478478, -1.0125563275127794},
-    {-0.8458458458458459, -1.0076346166545975},
-    {-0.8438438438438438, -1.002761243671599},
-    {-0.8418418418418419, -0.9979350412722153},
-    {-0.8398398398398399, -0.9931548844876695},
-    {-0.8378378378378378, -0.9884196886257337},
-    {-0.8358358358358359, -0.9837284073474227},
-    {-0.8338338338338338, -0.9790800308578386},
-    {-0.8318318318318318, -0.9744735842031009},
-    {-0.8298298298298299, -0.969908125665949},
-    {-0.8278278278278278, -0.9653827452532134},
-    {-0.8258258258258259, -0.960896563268889},
-    {-0.8238238238238238, -0.9564487289670347},
-    {-0.8218218218218218, -0.9520384192791863},
-    {-0.8198198198198199, -0.9476648376113626},
-    {-0.8178178178178178, -0.9433272127061353},
-    {-0.8158158158158157, -0.9390247975655649},
-    {-0.8138138138138138, -0.9347568684311255},
-    {-0.8118118118118118, -0.9305227238170144},
-    {-0.8098098098098099, -0.9263216835935286},
-    {-0.8078078078078078, -0.9221530881174035},
-    {-0.8058058058058057, -0.9180162974062506},
-    {-0.8038038038038038, -0.9139106903544266},
-    {-0.8018018018018018, -0.90983566398785},
-    {-0.7997997997997999, -0.9057906327554596},
-    {-0.7977977977977978, -0.9017750278551672},
-    {-0.7957957957957957, -0.8977882965922956},
-    {-0.7937937937937938, -0.8938299017686367},
-    {-0.7917917917917918, -0.8898993211003825},
-    {-0.7897897897897898, -0.8859960466633058},
-    {-0.7877877877877878, -0.8821195843636616},
-    {-0.7857857857857857, -0.878269453433387},
-    {-0.7837837837837838, -0.87444518594827},
-    {-0.7817817817817818, -0.8706463263678359},
-    {-0.7797797797797797, -0.8668724310957832},
-    {-0.7777777777777778, -0.8631230680598739},
-    {-0.7757757757757757, -0.8593978163102485},
-    {-0.7737737737737738, -0.8556962656352002},
-    {-0.7717717717717718, -0.8520180161935024},
-    {-0.7697697697697697, -0.8483626781624372},
-    {-0.7677677677677678, -0.8447298714007245},
-    {-0.7657657657657657, -0.8411192251255941},
-    {-0.7637637637637638, -0.8375303776032997},
-    {-0.7617617617617618, -0.8339629758523939},
-    {-0.7597597597597597, -0.8304166753591482},
-    {-0.7577577577577578, -0.8268911398045152},
-    {-0.7557557557557557, -0.8233860408020754},
-    {-0.7537537537537538, -0.8199010576464416},
-    {-0.7517517517517518, -0.8164358770716202},
-    {-0.7497497497497497, -0.81299019301886},
-    {-0.7477477477477478, -0.8095637064135418},
-    {-0.7457457457457457, -0.806156124950686},
-    {-0.7437437437437437, -0.8027671628886863},
-    {-0.7417417417417418, -0.7993965408508816},
-    {-0.7397397397397397, -0.796043985634622},
-    {-0.7377377377377378, -0.7927092300274814},
-    {-0.7357357357357357, -0.7893920126302988},
-    {-0.7337337337337337, -0.786092077686748},
-    {-0.7317317317317318, -0.7828091749191433},
-    {-0.7297297297297297, -0.7795430593702091},
-    {-0.7277277277277278, -0.7762934912505586},
-    {-0.7257257257257257, -0.7730602357916257},
-    {-0.7237237237237237, -0.769843063103829},
-    {-0.7217217217217218, -0.7666417480397328},
-    {-0.7197197197197197, -0.763456070062003},
-    {-0.7177177177177176, -0.7602858131159546},
-    {-0.7157157157157157, -0.7571307655064964},
-    {-0.7137137137137137, -0.7539907197792959},
-    {-0.7117117117117118, -0.750865472605988},
-    {-0.7097097097097097, -0.7477548246732644},
-    {-0.7077077077077076, -0.7446585805756846},
-    {-0.7057057057057057, -0.7415765487120626},
-    {-0.7037037037037037, -0.7385085411852826},
-    {-0.7017017017017018, -0.7354543737054079},
-    {-0.6996996996996997, -0.7324138654959579},
-    {-0.6976976976976976, -0.7293868392032248},
-    {-0.6956956956956957, -0.7263731208085116},
-    {-0.6936936936936937, -0.7233725395431816},
-    {-0.6916916916916918, -0.7203849278064095},
-    {-0.6896896896896897, -0.7174101210855328},
-    {-0.6876876876876876, -0.7144479578789023},
-    {-0.6856856856856857, -0.7114982796211399},
-    {-0.6836836836836837, -0.7085609306107132},
-    {-0.6816816816816818, -0.7056357579397413},
-    {-0.6796796796796797, -0.7027226114259476},
-    {-0.6776776776776776, -0.6998213435466839},
-    {-0.6756756756756757, -0.6969318093749465},
-    {-0.6736736736736737, -0.6940538665173154},
-    {-0.6716716716716717, -0.6911873750537463},
-    {-0.6696696696696697, -0.688332197479148},
-    {-0.6676676676676676, -0.6854881986466836},
-    {-0.6656656656656657, -0.6826552457127326},
-    {-0.6636636636636637, -0.6798332080834573},
-    {-0.6616616616616617, -0.6770219573629155},
-    {-0.6596596596596597, -0.6742213673026681},
-    {-0.6576576576576576, -0.6714313137528297},
-    {-0.6556556556556556, -0.668651674614508},
-    {-0.6536536536536537, -0.6658823297935929},
-    {-0.6516516516516517, -0.6631231611558416},
-    {-0.6496496496496497, -0.660374052483222},
-    {-0.6476476476476476, -0.6576348894314681},
-    {-0.6456456456456456, -0.6549055594888084},
-    {-0.6436436436436437, -0.6521859519358288},
-    {-0.6416416416416417, -0.6494759578064329},
-    {-0.6396396396396397, -0.6467754698498618},
-    {-0.6376376376376376, -0.6440843824937419},
-    {-0.6356356356356356, -0.6414025918081238},
-    {-0.6336336336336337, -0.6387299954704827},
-    {-0.6316316316316316, -0.6360664927316497},
-    {-0.6296296296296297, -0.6334119843826435},
-    {-0.6276276276276276, -0.6307663727223712},
-    {-0.6256256256256256, -0.6281295615261789},
-    {-0.6236236236236237, -0.6255014560152141},
-    {-0.6216216216216216, -0.6228819628265847},
-    {-0.6196196196196196, -0.6202709899842836},
-    {-0.6176176176176176, -0.6176684468708586},
-    {-0.6156156156156156, -0.6150742441998026},
-    {-0.6136136136136137, -0.6124882939886422},
-    {-0.6116116116116116, -0.6099105095327062},
-    {-0.6096096096096096, -0.6073408053795499},
-    {-0.6076076076076076, -0.6047790973040159},
-    {-0.6056056056056056, -0.6022253022839172},
-    {-0.6036036036036037, -0.5996793384763156},
-    {-0.6016016016016016, -0.5971411251943852},
-    {-0.5995995995995996, -0.594610582884841},
-    {-0.5975975975975976, -0.5920876331059138},
-    {-0.5955955955955956, -0.5895721985058607},
-    {-0.5935935935935936, -0.587064202801989},
-    {-0.5915915915915916, -0.5845635707601852},
-    {-0.5895895895895895, -0.5820702281749305},
-    {-0.5875875875875876, -0.5795841018497889},
-    {-0.5855855855855856, -0.5771051195783572},
-    {-0.5835835835835836, -0.5746332101256603},
-    {-0.5815815815815816, -0.5721683032099822},
-    {-0.5795795795795795, -0.5697103294851199},
-    {-0.5775775775775776, -0.5672592205230452},
-    {-0.5755755755755756, -0.5648149087969677},
-    {-0.5735735735735736, -0.5623773276647853},
-    {-0.5715715715715716, -0.5599464113529119},
-    {-0.5695695695695695, -0.5575220949404718},
-    {-0.5675675675675675, -0.5551043143438511},
-    {-0.5655655655655656, -0.5526930063015967},
-    {-0.5635635635635636, -0.5502881083596526},
-    {-0.5615615615615616, -0.5478895588569254},
-    {-0.5595595595595595, -0.5454972969111689},
-    {-0.5575575575575575, -0.5431112624051821},
-    {-0.5555555555555556, -0.5407313959733069},
-    {-0.5535535535535536, -0.5383576389882241},
-    {-0.5515515515515516, -0.5359899335480349},
-    {-0.5495495495495495, -0.5336282224636232},
-    {-0.5475475475475475, -0.5312724492462898},
-    {-0.5455455455455456, -0.5289225580956516},
-    {-0.5435435435435436, -0.5265784938878002},
-    {-0.5415415415415415, -0.5242402021637123},
-    {-0.5395395395395395, -0.5219076291179047},
-    {-0.5375375375375375, -0.5195807215873296},
-    {-0.5355355355355356, -0.5172594270405014},
-    {-0.5335335335335336, -0.5149436935668527},
-    {-0.5315315315315315, -0.5126334698663098},
-    {-0.5295295295295295, -0.5103287052390857},
-    {-0.5275275275275275, -0.5080293495756822},
-    {-0.5255255255255256, -0.5057353533470984},
-    {-0.5235235235235236, -0.5034466675952382},
-    {-0.5215215215215215, -0.5011632439235141},
-    {-0.5195195195195195, -0.4988850344876412},
-    {-0.5175175175175175, -0.4966119919866168},
-    {-0.5155155155155156, -0.4943440696538802},
-    {-0.5135135135135136, -0.49208122124865145},
-    {-0.5115115115115115, -0.48982340104744065},
-    {-0.5095095095095095, -0.48757056383572767},
-    {-0.5075075075075075, -0.485322664899804},
-    {-0.5055055055055055, -0.48307966001877656},
-    {-0.5035035035035035, -0.48084150545672755},
-    {-0.5015015015015015, -0.47860815795502776},
-    {-0.49949949949949946, -0.47637957472479825},
-    {-0.4974974974974975, -0.4741557134395187},
-    {-0.49549549549549554, -0.4719365322277775},
-    {-0.4934934934934935, -0.46972198966616147},
-    {-0.4914914914914915, -0.46751204477228103},
-    {-0.48948948948948945, -0.46530665699792784},
-    {-0.4874874874874875, -0.46310578622236276},
-    {-0.48548548548548554, -0.4609093927457295},
-    {-0.48348348348348347, -0.4587174372825931},
-    {-0.4814814814814815, -0.45652988095559854},
-    {-0.47947947947947944, -0.4543466852892476},
-    {-0.4774774774774775, -0.45216781220379165},
-    {-0.47547547547547553, -0.44999322400923686},
-    {-0.47347347347347346, -0.44782288339945997},
-    {-0.4714714714714715, -0.4456567534464324},
-    {-0.46946946946946944, -0.44349479759454896},
-    {-0.4674674674674675, -0.4413369796550604},
-    {-0.4654654654654655, -0.4391832638006064},
-    {-0.46346346346346345, -0.43703361455984746},
-    {-0.4614614614614615, -0.43488799681219353},
-    {-0.45945945945945943, -0.4327463757826266},
-    {-0.4574574574574575, -0.43060871703661513},
-    {-0.4554554554554555, -0.42847498647512006},
-    {-0.45345345345345345, -0.4263451503296879},
-    {-0.4514514514514515, -0.42421917515763147},
-    {-0.4494494494494494, -0.4220970278372937},
-    {-0.44744744744744747, -0.4199786755633958},
-    {-0.4454454454454454, -0.41786408584246515},
-    {-0.44344344344344344, -0.4157532264883438},
-    {-0.4414414414414415, -0.4136460656177725},
-    {-0.4394394394394394, -0.4115425716460533},
-    {-0.43743743743743746, -0.4094427132827848},
-    {-0.4354354354354354, -0.4073464595276697},
-    {-0.43343343343343343, -0.4052537796663961},
-    {-0.4314314314314315, -0.40316464326658547},
-    {-0.4294294294294294, -0.40107902017381164},
-    {-0.42742742742742745, -0.39899688050768517},
-    {-0.4254254254254254, -0.3969181946580034},
-    {-0.42342342342342343, -0.3948429332809656},
-    {-0.42142142142142147, -0.39277106729544986},
-    {-0.4194194194194194, -0.3907025678793522},
-    {-0.41741741741741745, -0.3886374064659867},
-    {-0.4154154154154154, -0.38657555474054234},
-    {-0.4134134134134134, -0.3845169846366014},
-    {-0.41141141141141147, -0.38246166833271095},
-    {-0.4094094094094094, -0.3804095782490127},
-    {-0.40740740740740744, -0.378360687043926},
-    {-0.4054054054054054, -0.37631496761088395},
-    {-0.4034034034034034, -0.3742723930751238},
-    {-0.40140140140140146, -0.3722329367905255},
-    {-0.3993993993993994, -0.370196572336504},
-    {-0.39739739739739743, -0.3681632735149484},
-    {-0.39539539539539537, -0.36613301434720996},
-    {-0.3933933933933934, -0.3641057690711388},
-    {-0.39139139139139134, -0.3620815121381647},
-    {-0.3893893893893894, -0.3600602182104261},
-    {-0.3873873873873874, -0.3580418621579413},
-    {-0.38538538538538536, -0.3560264190558252},
-    {-0.3833833833833834, -0.3540138641815486},
-    {-0.38138138138138133, -0.3520041730122386},
-    {-0.3793793793793794, -0.34999732122202215},
-    {-0.3773773773773774, -0.34799328467940854},
-    {-0.37537537537537535, -0.34599203944471185},
-    {-0.3733733733733734, -0.34399356176751406},
-    {-0.37137137137137133, -0.34199782808416357},
-    {-0.36936936936936937, -0.340004815015314},
-    {-0.3673673673673674, -0.3380144993634979},
-    {-0.36536536536536535, -0.3360268581107375},
-    {-0.3633633633633634, -0.3340418684161914},
-    {-0.3613613613613613, -0.3320595076138338},
-    {-0.35935935935935936, -0.33007975321017113},
-    {-0.3573573573573574, -0.3281025828819893},
-    {-0.35535535535535534, -0.32612797447413555},
-    {-0.3533533533533534, -0.324155905997332},
-    {-0.3513513513513513, -0.3221863556260205},
-    {-0.34934934934934936, -0.32021930169623986},
-    {-0.3473473473473474, -0.31825472270353145},
-    {-0.34534534534534533, -0.31629259730087683},
-    {-0.3433433433433434, -0.31433290429666416},
-    {-0.3413413413413413, -0.3123756226526825},
-    {-0.33933933933933935, -0.31042073148214594},
-    {-0.3373373373373374, -0.3084682100477445},
-    {-0.3353353353353353, -0.3065180377597228},
-    {-0.33333333333333337, -0.3045701941739857},
-    {-0.3313313313313313, -0.30262465899022944},
-    {-0.32932932932932935, -0.30068141205010046},
-    {-0.3273273273273274, -0.2987404333353771},
-    {-0.3253253253253253, -0.2968017029661784},
-    {-0.32332332332332336, -0.2948652011991969},
-    {-0.3213213213213213, -0.29293090842595404},
-    {-0.31931931931931934, -0.2909988051710822},
-    {-0.31731731731731727, -0.28906887209062615},
-    {-0.3153153153153153, -0.2871410899703712},
-    {-0.31331331331331336, -0.28521543972419044},
-    {-0.3113113113113113, -0.2832919023924161},
-    {-0.30930930930930933, -0.2813704591402323},
-    {-0.30730730730730726, -0.2794510912560874},
-    {-0.3053053053053053, -0.27753378015012997},
-    {-0.30330330330330335, -0.27561850735266247},
-    {-0.3013013013013013, -0.2737052545126169},
-    {-0.2992992992992993, -0.27179400339605},
-    {-0.29729729729729726, -0.2698847358846569},
-    {-0.2952952952952953, -0.26797743397430546},
-    {-0.29329329329329334, -0.2660720797735877},
-    {-0.2912912912912913, -0.2641686555023908},
-    {-0.2892892892892893, -0.2622671434904868},
-    {-0.28728728728728725, -0.2603675261761376},
-    {-0.2852852852852853, -0.25846978610472104},
-    {-0.28328328328328334, -0.2565739059273708},
-    {-0.28128128128128127, -0.25467986839963547},
-    {-0.2792792792792793, -0.25278765638015394},
-    {-0.27727727727727725, -0.2508972528293457},
-    {-0.2752752752752753, -0.24900864080811924},
-    {-0.27327327327327333, -0.24712180347659454},
-    {-0.27127127127127126, -0.24523672409284197},
-    {-0.2692692692692693, -0.2433533860116369},
-    {-0.26726726726726724, -0.24147177268322756},
-    {-0.2652652652652653, -0.2395918676521199},
-    {-0.2632632632632632, -0.23771365455587481},
-    {-0.26126126126126126, -0.23583711712392152},
-    {-0.2592592592592593, -0.23396223917638337},
-    {-0.25725725725725723, -0.23208900462291818},
-    {-0.2552552552552553, -0.2302173974615727},
-    {-0.2532532532532532, -0.22834740177764867},
-    {-0.25125125125125125, -0.2264790017425839},
-    {-0.2492492492492493, -0.2246121816128448},
-    {-0.24724724724724723, -0.222746925728832},
-    {-0.24524524524524527, -0.22088321851379933},
-    {-0.2432432432432432, -0.21902104447278276},
-    {-0.24124124124124124, -0.21716038819154423},
-    {-0.2392392392392393, -0.21530123433552475},
-    {-0.23723723723723722, -0.21344356764881056},
-    {-0.23523523523523526, -0.21158737295311086},
-    {-0.2332332332332332, -0.20973263514674526},
-    {-0.23123123123123124, -0.2078793392036442},
-    {-0.22922922922922928, -0.20602747017235878},
-    {-0.2272272272272272, -0.20417701317508175},
-    {-0.22522522522522526, -0.20232795340667958},
-    {-0.2232232232232232, -0.20048027613373354},
-    {-0.22122122122122123, -0.19863396669359237},
-    {-0.21921921921921927, -0.1967890104934337},
-    {-0.2172172172172172, -0.1949453930093359},
-    {-0.21521521521521525, -0.19310309978536003},
-    {-0.21321321321321318, -0.1912621164326398},
-    {-0.21121121121121122, -0.18942242862848244},
-    {-0.20920920920920927, -0.18758402211547792},
-    {-0.2072072072072072, -0.18574688270061693},
-    {-0.20520520520520524, -0.1839109962544188},
-    {-0.20320320320320318, -0.18207634871006662},
-    {-0.20120120120120122, -0.18024292606255232},
-    {-0.19919919919919926, -0.17841071436782927},
-    {-0.1971971971971972, -0.17657969974197324},
-    {-0.19519519519519524, -0.17474986836035244},
-    {-0.19319319319319317, -0.17292120645680367},
-    {-0.1911911911911912, -0.17109370032281843},
-    {-0.18918918918918914, -0.16926733630673518},
-    {-0.1871871871871872, -0.16744210081294003},
-    {-0.18518518518518523, -0.16561798030107452},
-    {-0.18318318318318316, -0.16379496128525056},
-    {-0.1811811811811812, -0.16197303033327365},
-    {-0.17917917917917914, -0.16015217406587132},
-    {-0.17717717717717718, -0.15833237915593043},
-    {-0.17517517517517522, -0.15651363232774},
-    {-0.17317317317317316, -0.15469592035624108},
-    {-0.1711711711711712, -0.15287923006628396},
-    {-0.16916916916916913, -0.15106354833189042},
-    {-0.16716716716716717, -0.14924886207552393},
-    {-0.16516516516516522, -0.14743515826736484},
-    {-0.16316316316316315, -0.1456224239245922},
-    {-0.1611611611611612, -0.14381064611067212},
-    {-0.15915915915915912, -0.14199981193465097},
-    {-0.15715715715715717, -0.14018990855045552},
-    {-0.1551551551551552, -0.13838092315619785},
-    {-0.15315315315315314, -0.1365728429934864},
-    {-0.1511511511511512, -0.13476565534674284},
-    {-0.14914914914914912, -0.1329593475425232},
-    {-0.14714714714714716, -0.13115390694884588},
-    {-0.1451451451451452, -0.12934932097452329},
-    {-0.14314314314314314, -0.1275455770684997},
-    {-0.14114114114114118, -0.12574266271919404},
-    {-0.1391391391391391, -0.12394056545384681},
-    {-0.13713713713713716, -0.12213927283787285},
-    {-0.1351351351351351, -0.12033877247421791},
-    {-0.13313313313313313, -0.11853905200272094},
-    {-0.13113113113113117, -0.11674009909947966},
-    {-0.1291291291291291, -0.11494190147622166},
-    {-0.12712712712712715, -0.1131444468796797},
-    {-0.12512512512512508, -0.11134772309097049},
-    {-0.12312312312312312, -0.10955171792497909},
-    {-0.12112112112112117, -0.10775641922974585},
-    {-0.1191191191191191, -0.10596181488585875},
-    {-0.11711711711711714, -0.10416789280584911},
-    {-0.11511511511511507, -0.10237464093359089},
-    {-0.11311311311311312, -0.10058204724370462},
-    {-0.11111111111111116, -0.09879009974096402},
-    {-0.10910910910910909, -0.09699878645970715},
-    {-0.10710710710710714, -0.09520809546325086},
-    {-0.10510510510510507, -0.09341801484330822},
-    {-0.10310310310310311, -0.09162853271941036},
-    {-0.10110110110110115, -0.08983963723833041},
-    {-0.09909909909909909, -0.08805131657351184},
-    {-0.09709709709709713, -0.08626355892449952},
-    {-0.09509509509509506, -0.08447635251637348},
-    {-0.0930930930930931, -0.08268968559918663},
-    {-0.09109109109109115, -0.08090354644740444},
-    {-0.08908908908908908, -0.07911792335934817},
-    {-0.08708708708708712, -0.07733280465664119},
-    {-0.08508508508508505, -0.07554817868365683},
-    {-0.0830830830830831, -0.07376403380697052},
-    {-0.08108108108108114, -0.07198035841481311},
-    {-0.07907907907907907, -0.07019714091652764},
-    {-0.07707707707707712, -0.06841436974202864},
-    {-0.07507507507507505, -0.06663203334126283},
-    {-0.07307307307307309, -0.06485012018367366},
-    {-0.07107107107107113, -0.06306861875766669},
-    {-0.06906906906906907, -0.06128751757007814},
-    {-0.06706706706706711, -0.05950680514564556},
-    {-0.06506506506506504, -0.05772647002647972},
-    {-0.06306306306306309, -0.0559465007715398},
-    {-0.06106106106106102, -0.054166885956109224},
-    {-0.05905905905905906, -0.052387614171274764},
-    {-0.0570570570570571, -0.05060867402340608},
-    {-0.055055055055055035, -0.048830054133638015},
-    {-0.05305305305305308, -0.04705174313735462},
-    {-0.05105105105105101, -0.04527372968367377},
-    {-0.049049049049049054, -0.04349600243493497},
-    {-0.0470470470470471, -0.0417185500661871},
-    {-0.04504504504504503, -0.03994136126467865},
-    {-0.04304304304304307, -0.03816442472934938},
-    {-0.041041041041041004, -0.03638772917032232},
-    {-0.03903903903903905, -0.034611263308398595},
-    {-0.03703703703703709, -0.03283501587455187},
-    {-0.03503503503503502, -0.031058975609425096},
-    {-0.033033033033033066, -0.029283131262828298},
-    {-0.031031031031030998, -0.027507471593236396},
-    {-0.02902902902902904, -0.02573198536728961},
-    {-0.027027027027027084, -0.02395666135929319},
-    {-0.025025025025025016, -0.02218148835071913},
-    {-0.02302302302302306, -0.02040645512970859},
-    {-0.02102102102102099, -0.018631550490574227},
-    {-0.019019019019019034, -0.01685676323330458},
-    {-0.017017017017017078, -0.015082082163067721},
-    {-0.01501501501501501, -0.013307496089716432},
-    {-0.013013013013013053, -0.011532993827293952},
-    {-0.011011011011010985, -0.009758564193539182},
-    {-0.009009009009009028, -0.007984196009393839},
-    {-0.00700700700700696, -0.0062098780985083354},
-    {-0.005005005005005003, -0.004435599286749611},
-    {-0.0030030030030030463, -0.0026613484017076936},
-    {-0.0010010010010009784, -0.0008871142722034603},
-    {0.0010010010010010895, 0.0008871142722035588},
-    {0.0030030030030030463, 0.0026613484017076936},
-    {0.005005005005005003, 0.004435599286749611},
-    {0.00700700700700696, 0.0062098780985083354},
-    {0.009009009009008917, 0.007984196009393742},
-    {0.011011011011011096, 0.009758564193539281},
-    {0.013013013013013053, 0.011532993827293952},
-    {0.01501501501501501, 0.013307496089716432},
-    {0.017017017017016967, 0.015082082163067622},
-    {0.019019019019018923, 0.016856763233304484},
-    {0.021021021021021102, 0.018631550490574324},
-    {0.02302302302302306, 0.02040645512970859},
-    {0.025025025025025016, 0.02218148835071913},
-    {0.027027027027026973, 0.023956661359293096},
-    {0.02902902902902893, 0.02573198536728951},
-    {0.03103103103103111, 0.027507471593236497},
-    {0.033033033033033066, 0.029283131262828298},
-    {0.03503503503503502, 0.031058975609425096},
-    {0.03703703703703698, 0.03283501587455177},
-    {0.039039039039038936, 0.0346112633083985},
-    {0.041041041041041115, 0.036387729170322416},
-    {0.04304304304304307, 0.03816442472934938},
-    {0.04504504504504503, 0.03994136126467865},
-    {0.047047047047046986, 0.04171855006618699},
-    {0.04904904904904894, 0.04349600243493488},
-    {0.05105105105105112, 0.04527372968367386},
-    {0.05305305305305308, 0.04705174313735462},
-    {0.055055055055055035, 0.048830054133638015},
-    {0.05705705705705699, 0.050608674023405985},
-    {0.05905905905905895, 0.05238761417127467},
-    {0.06106106106106113, 0.05416688595610933},
-    {0.06306306306306309, 0.0559465007715398},
-    {0.06506506506506504, 0.05772647002647972},
-    {0.067067067067067, 0.05950680514564547},
-    {0.06906906906906896, 0.06128751757007805},
-    {0.07107107107107113, 0.06306861875766669},
-    {0.07307307307307309, 0.06485012018367366},
-    {0.07507507507507505, 0.06663203334126283},
-    {0.077077077077077, 0.06841436974202854},
-    {0.07907907907907896, 0.07019714091652754},
-    {0.08108108108108114, 0.07198035841481311},
-    {0.0830830830830831, 0.07376403380697052},
-    {0.08508508508508505, 0.07554817868365683},
-    {0.08708708708708701, 0.0773328046566411},
-    {0.08908908908908897, 0.07911792335934807},
-    {0.09109109109109115, 0.08090354644740444},
-    {0.0930930930930931, 0.08268968559918663},
-    {0.09509509509509506, 0.08447635251637348},
-    {0.09709709709709702, 0.08626355892449944},
-    {0.0990990990990992, 0.08805131657351194},
-    {0.10110110110110115, 0.08983963723833041},
-    {0.10310310310310311, 0.09162853271941036},
-    {0.10510510510510507, 0.09341801484330822},
-    {0.10710710710710702, 0.09520809546325076},
-    {0.1091091091091092, 0.09699878645970723},
-    {0.11111111111111116, 0.09879009974096402},
-    {0.11311311311311312, 0.10058204724370462},
-    {0.11511511511511507, 0.10237464093359089},
-    {0.11711711711711703, 0.10416789280584901},
-    {0.11911911911911921, 0.10596181488585885},
-    {0.12112112112112117, 0.10775641922974585},
-    {0.12312312312312312, 0.10955171792497909},
-    {0.12512512512512508, 0.11134772309097049},
-    {0.12712712712712704, 0.1131444468796796},
-    {0.12912912912912922, 0.11494190147622176},
-    {0.13113113113113117, 0.11674009909947966},
-    {0.13313313313313313, 0.11853905200272094},
-    {0.1351351351351351, 0.12033877247421791},
-    {0.13713713713713704, 0.12213927283787275},
-    {0.13913913913913922, 0.1239405654538469},
-    {0.14114114114114118, 0.12574266271919404},
-    {0.14314314314314314, 0.1275455770684997},
-    {0.1451451451451451, 0.12934932097452317},
-    {0.14714714714714705, 0.1311539069488458},
-    {0.14914914914914923, 0.1329593475425233},
-    {0.1511511511511512, 0.13476565534674284},
-    {0.15315315315315314, 0.1365728429934864},
-    {0.1551551551551551, 0.13838092315619774},
-    {0.15715715715715706, 0.14018990855045543},
-    {0.15915915915915924, 0.14199981193465108},
-    {0.1611611611611612, 0.14381064611067212},
-    {0.16316316316316315, 0.1456224239245922},
-    {0.1651651651651651, 0.14743515826736472},
-    {0.16716716716716706, 0.14924886207552385},
-    {0.16916916916916924, 0.1510635483318905},
-    {0.1711711711711712, 0.15287923006628396},
-    {0.17317317317317316, 0.15469592035624108},
-    {0.1751751751751751, 0.15651363232773993},
-    {0.17717717717717707, 0.15833237915593038},
-    {0.17917917917917925, 0.1601521740658714},
-    {0.1811811811811812, 0.16197303033327365},
-    {0.18318318318318316, 0.16379496128525056},
-    {0.18518518518518512, 0.1656179803010744},
-    {0.18718718718718708, 0.16744210081293992},
-    {0.18918918918918926, 0.16926733630673527},
-    {0.1911911911911912, 0.17109370032281843},
-    {0.19319319319319317, 0.17292120645680367},
-    {0.19519519519519513, 0.17474986836035233},
-    {0.19719719719719708, 0.17657969974197318},
-    {0.19919919919919926, 0.17841071436782927},
-    {0.20120120120120122, 0.18024292606255232},
-    {0.20320320320320318, 0.18207634871006662},
-    {0.20520520520520513, 0.18391099625441876},
-    {0.2072072072072071, 0.18574688270061682},
-    {0.20920920920920927, 0.18758402211547792},
-    {0.21121121121121122, 0.18942242862848244},
-    {0.21321321321321318, 0.1912621164326398},
-    {0.21521521521521514, 0.19310309978535994},
-    {0.21721721721721732, 0.19494539300933605},
-    {0.21921921921921927, 0.1967890104934337},
-    {0.22122122122122123, 0.19863396669359237},
-    {0.2232232232232232, 0.20048027613373354},
-    {0.22522522522522515, 0.20232795340667947},
-    {0.22722722722722732, 0.20417701317508186},
-    {0.22922922922922928, 0.20602747017235878},
-    {0.23123123123123124, 0.2078793392036442},
-    {0.2332332332332332, 0.20973263514674526},
-    {0.23523523523523515, 0.21158737295311078},
-    {0.23723723723723733, 0.21344356764881073},
-    {0.2392392392392393, 0.21530123433552475},
-    {0.24124124124124124, 0.21716038819154423},
-    {0.2432432432432432, 0.21902104447278276},
-    {0.24524524524524516, 0.2208832185137992},
-    {0.24724724724724734, 0.22274692572883217},
-    {0.2492492492492493, 0.2246121816128448},
-    {0.25125125125125125, 0.2264790017425839},
-    {0.2532532532532532, 0.22834740177764867},
-    {0.25525525525525516, 0.23021739746157263},
-    {0.25725725725725734, 0.2320890046229183},
-    {0.2592592592592593, 0.23396223917638337},
-    {0.26126126126126126, 0.23583711712392152},
-    {0.2632632632632632, 0.23771365455587481},
-    {0.26526526526526517, 0.23959186765211976},
-    {0.26726726726726735, 0.24147177268322767},
-    {0.2692692692692693, 0.2433533860116369},
-    {0.27127127127127126, 0.24523672409284197},
-    {0.2732732732732732, 0.24712180347659443},
-    {0.2752752752752752, 0.24900864080811913},
-    {0.27727727727727736, 0.25089725282934583},
-    {0.2792792792792793, 0.25278765638015394},
-    {0.28128128128128127, 0.25467986839963547},
-    {0.2832832832832832, 0.25657390592737067},
-    {0.2852852852852852, 0.25846978610472093},
-    {0.28728728728728736, 0.26036752617613773},
-    {0.2892892892892893, 0.2622671434904868},
-    {0.2912912912912913, 0.2641686555023908},
-    {0.29329329329329323, 0.2660720797735876},
-    {0.2952952952952952, 0.26797743397430535},
-    {0.29729729729729737, 0.26988473588465706},
-    {0.2992992992992993, 0.27179400339605},
-    {0.3013013013013013, 0.2737052545126169},
-    {0.30330330330330324, 0.2756185073526624},
-    {0.3053053053053052, 0.2775337801501299},
-    {0.3073073073073074, 0.2794510912560876},
-    {0.30930930930930933, 0.2813704591402323},
-    {0.3113113113113113, 0.2832919023924161},
-    {0.31331331331331325, 0.28521543972419033},
-    {0.3153153153153152, 0.2871410899703711},
-    {0.3173173173173174, 0.2890688720906263},
-    {0.31931931931931934, 0.2909988051710822},
-    {0.3213213213213213, 0.29293090842595404},
-    {0.32332332332332325, 0.2948652011991968},
-    {0.3253253253253252, 0.2968017029661783},
-    {0.3273273273273274, 0.2987404333353771},
-    {0.32932932932932935, 0.30068141205010046},
-    {0.3313313313313313, 0.30262465899022944},
-    {0.33333333333333326, 0.30457019417398556},
-    {0.3353353353353352, 0.3065180377597227},
-    {0.3373373373373374, 0.3084682100477445},
-    {0.33933933933933935, 0.31042073148214594},
-    {0.3413413413413413, 0.3123756226526825},
-    {0.34334334334334327, 0.31433290429666405},
-    {0.3453453453453452, 0.31629259730087667},
-    {0.3473473473473474, 0.31825472270353145},
-    {0.34934934934934936, 0.32021930169623986},
-    {0.3513513513513513, 0.3221863556260205},
-    {0.35335335335335327, 0.3241559059973319},
-    {0.35535535535535545, 0.3261279744741356},
-    {0.3573573573573574, 0.3281025828819893},
-    {0.35935935935935936, 0.33007975321017113},
-    {0.3613613613613613, 0.3320595076138338},
-    {0.3633633633633633, 0.3340418684161913},
-    {0.36536536536536546, 0.33602685811073774},
-    {0.3673673673673674, 0.3380144993634979},
-    {0.36936936936936937, 0.340004815015314},
-    {0.37137137137137133, 0.34199782808416357},
-    {0.3733733733733733, 0.343993561767514},
-    {0.37537537537537546, 0.34599203944471196},
-    {0.3773773773773774, 0.34799328467940854},
-    {0.3793793793793794, 0.34999732122202215},
-    {0.38138138138138133, 0.3520041730122386},
-    {0.3833833833833833, 0.3540138641815485},
-    {0.38538538538538547, 0.3560264190558253},
-    {0.3873873873873874, 0.3580418621579413},
-    {0.3893893893893894, 0.3600602182104261},
-    {0.39139139139139134, 0.3620815121381647},
-    {0.3933933933933933, 0.3641057690711387},
-    {0.3953953953953955, 0.36613301434721013},
-    {0.39739739739739743, 0.3681632735149484},
-    {0.3993993993993994, 0.370196572336504},
-    {0.40140140140140135, 0.3722329367905253},
-    {0.4034034034034033, 0.37427239307512367},
-    {0.4054054054054055, 0.3763149676108841},
-    {0.40740740740740744, 0.378360687043926},
-    {0.4094094094094094, 0.3804095782490127},
-    {0.41141141141141135, 0.3824616683327108},
-    {0.4134134134134133, 0.3845169846366012},
-    {0.4154154154154155, 0.38657555474054245},
-    {0.41741741741741745, 0.3886374064659867},
-    {0.4194194194194194, 0.3907025678793522},
-    {0.42142142142142136, 0.39277106729544964},
-    {0.4234234234234233, 0.39484293328096554},
-    {0.4254254254254255, 0.3969181946580035},
-    {0.42742742742742745, 0.39899688050768517},
-    {0.4294294294294294, 0.40107902017381164},
-    {0.43143143143143137, 0.4031646432665853},
-    {0.4334334334334333, 0.405253779666396},
-    {0.4354354354354355, 0.4073464595276698},
-    {0.43743743743743746, 0.4094427132827848},
-    {0.4394394394394394, 0.4115425716460533},
-    {0.4414414414414414, 0.41364606561777234},
-    {0.44344344344344333, 0.4157532264883436},
-    {0.4454454454454455, 0.4178640858424653},
-    {0.44744744744744747, 0.4199786755633958},
-    {0.4494494494494494, 0.4220970278372937},
-    {0.4514514514514514, 0.4242191751576314},
-    {0.45345345345345334, 0.42634515032968784},
-    {0.4554554554554555, 0.42847498647512006},
-    {0.4574574574574575, 0.43060871703661513},
-    {0.45945945945945943, 0.4327463757826266},
-    {0.4614614614614614, 0.4348879968121935},
-    {0.46346346346346334, 0.4370336145598473},
-    {0.4654654654654655, 0.4391832638006064},
-    {0.4674674674674675, 0.4413369796550604},
-    {0.46946946946946944, 0.44349479759454896},
-    {0.4714714714714714, 0.44565675344643235},
-    {0.47347347347347357, 0.4478228833994601},
-    {0.47547547547547553, 0.44999322400923686},
-    {0.4774774774774775, 0.45216781220379165},
-    {0.47947947947947944, 0.4543466852892476},
-    {0.4814814814814814, 0.45652988095559843},
-    {0.4834834834834836, 0.45871743728259323},
-    {0.48548548548548554, 0.4609093927457295},
-    {0.4874874874874875, 0.46310578622236276},
-    {0.48948948948948945, 0.46530665699792784},
-    {0.4914914914914914, 0.4675120447722809},
-    {0.4934934934934936, 0.4697219896661616},
-    {0.49549549549549554, 0.4719365322277775},
-    {0.4974974974974975, 0.4741557134395187},
-    {0.49949949949949946, 0.47637957472479825},
-    {0.5015015015015014, 0.4786081579550277},
-    {0.5035035035035036, 0.4808415054567277},
-    {0.5055055055055055, 0.48307966001877656},
-    {0.5075075075075075, 0.485322664899804},
-    {0.5095095095095095, 0.48757056383572767},
-    {0.5115115115115114, 0.4898234010474405},
-    {0.5135135135135136, 0.49208122124865145},
-    {0.5155155155155156, 0.4943440696538802},
-    {0.5175175175175175, 0.4966119919866168},
-    {0.5195195195195195, 0.4988850344876412},
-    {0.5215215215215214, 0.5011632439235139},
-    {0.5235235235235236, 0.5034466675952382},
-    {0.5255255255255256, 0.5057353533470984},
-    {0.5275275275275275, 0.5080293495756822},
-    {0.5295295295295295, 0.5103287052390857},
-    {0.5315315315315314, 0.5126334698663098},
-    {0.5335335335335336, 0.5149436935668527},
-    {0.5355355355355356, 0.5172594270405014},
-    {0.5375375375375375, 0.5195807215873296},
-    {0.5395395395395395, 0.5219076291179047},
-    {0.5415415415415414, 0.5242402021637123},
-    {0.5435435435435436, 0.5265784938878002},
-    {0.5455455455455456, 0.5289225580956516},
-    {0.5475475475475475, 0.5312724492462898},
-    {0.5495495495495495, 0.5336282224636232},
-    {0.5515515515515514, 0.5359899335480347},
-    {0.5535535535535536, 0.5383576389882241},
-    {0.5555555555555556, 0.5407313959733069},
-    {0.5575575575575575, 0.5431112624051821},
-    {0.5595595595595595, 0.5454972969111689},
-    {0.5615615615615615, 0.5478895588569251},
-    {0.5635635635635636, 0.5502881083596526},
-    {0.5655655655655656, 0.5526930063015967},
-    {0.5675675675675675, 0.5551043143438511},
-    {0.5695695695695695, 0.5575220949404718},
-    {0.5715715715715715, 0.5599464113529118},
-    {0.5735735735735736, 0.5623773276647853},
-    {0.5755755755755756, 0.5648149087969677},
-    {0.5775775775775776, 0.5672592205230452},
-    {0.5795795795795795, 0.5697103294851199},
-    {0.5815815815815815, 0.5721683032099822},
-    {0.5835835835835836, 0.5746332101256603},
-    {0.5855855855855856, 0.5771051195783572},
-    {0.5875875875875876, 0.5795841018497889},
-    {0.5895895895895895, 0.5820702281749305},
-    {0.5915915915915915, 0.5845635707601852},
-    {0.5935935935935936, 0.587064202801989},
-    {0.5955955955955956, 0.5895721985058607},
-    {0.5975975975975976, 0.5920876331059138},
-    {0.5995995995995995, 0.5946105828848409},
-    {0.6016016016016015, 0.5971411251943851},
-    {0.6036036036036037, 0.5996793384763156},
-    {0.6056056056056056, 0.6022253022839172},
-    {0.6076076076076076, 0.6047790973040159},
-    {0.6096096096096095, 0.6073408053795496},
-    {0.6116116116116117, 0.6099105095327064},
-    {0.6136136136136137, 0.6124882939886422},
-    {0.6156156156156156, 0.6150742441998026},
-    {0.6176176176176176, 0.6176684468708586},
-    {0.6196196196196195, 0.6202709899842835},
-    {0.6216216216216217, 0.6228819628265848},
-    {0.6236236236236237, 0.6255014560152141},
-    {0.6256256256256256, 0.6281295615261789},
-    {0.6276276276276276, 0.6307663727223712},
-    {0.6296296296296295, 0.6334119843826432},
-    {0.6316316316316317, 0.63606649273165},
-    {0.6336336336336337, 0.6387299954704827},
-    {0.6356356356356356, 0.6414025918081238},
-    {0.6376376376376376, 0.6440843824937419},
-    {0.6396396396396395, 0.6467754698498617},
-    {0.6416416416416417, 0.6494759578064329},
-    {0.6436436436436437, 0.6521859519358288},
-    {0.6456456456456456, 0.6549055594888084},
-    {0.6476476476476476, 0.6576348894314681},
-    {0.6496496496496496, 0.6603740524832218},
-    {0.6516516516516517, 0.6631231611558416},
-    {0.6536536536536537, 0.6658823297935929},
-    {0.6556556556556556, 0.668651674614508},
-    {0.6576576576576576, 0.6714313137528297},
-    {0.6596596596596596, 0.674221367302668},
-    {0.6616616616616617, 0.6770219573629155},
-    {0.6636636636636637, 0.6798332080834573},
-    {0.6656656656656657, 0.6826552457127326},
-    {0.6676676676676676, 0.6854881986466836},
-    {0.6696696696696696, 0.6883321974791479},
-    {0.6716716716716717, 0.6911873750537463},
-    {0.6736736736736737, 0.6940538665173154},
-    {0.6756756756756757, 0.6969318093749465},
-    {0.6776776776776776, 0.6998213435466839},
-    {0.6796796796796796, 0.7027226114259475},
-    {0.6816816816816818, 0.7056357579397413},
-    {0.6836836836836837, 0.7085609306107132},
-    {0.6856856856856857, 0.7114982796211399},
-    {0.6876876876876876, 0.7144479578789023},
-    {0.6896896896896896, 0.7174101210855328},
-    {0.6916916916916918, 0.7203849278064095},
-    {0.6936936936936937, 0.7233725395431816},
-    {0.6956956956956957, 0.7263731208085116},
-    {0.6976976976976976, 0.7293868392032248},
-    {0.6996996996996996, 0.7324138654959578},
-    {0.7017017017017018, 0.7354543737054079},
-    {0.7037037037037037, 0.7385085411852826},
-    {0.7057057057057057, 0.7415765487120626},
-    {0.7077077077077076, 0.7446585805756846},
-    {0.7097097097097096, 0.7477548246732639},
-    {0.7117117117117118, 0.750865472605988},
-    {0.7137137137137137, 0.7539907197792959},
-    {0.7157157157157157, 0.7571307655064964},
-    {0.7177177177177176, 0.7602858131159546},
-    {0.7197197197197196, 0.7634560700620029},
-    {0.7217217217217218, 0.7666417480397328},
-    {0.7237237237237237, 0.769843063103829},
-    {0.7257257257257257, 0.7730602357916257},
-    {0.7277277277277276, 0.7762934912505584},
-    {0.7297297297297298, 0.7795430593702094},
-    {0.7317317317317318, 0.7828091749191433},
-    {0.7337337337337337, 0.786092077686748},
-    {0.7357357357357357, 0.7893920126302988},
-    {0.7377377377377377, 0.7927092300274812},
-    {0.7397397397397398, 0.7960439856346222},
-    {0.7417417417417418, 0.7993965408508816},
-    {0.7437437437437437, 0.8027671628886863},
-    {0.7457457457457457, 0.806156124950686},
-    {0.7477477477477477, 0.8095637064135416},
-    {0.7497497497497498, 0.8129901930188602},
-    {0.7517517517517518, 0.8164358770716202},
-    {0.7537537537537538, 0.8199010576464416},
-    {0.7557557557557557, 0.8233860408020754},
-    {0.7577577577577577, 0.8268911398045152},
-    {0.7597597597597598, 0.8304166753591483},
-    {0.7617617617617618, 0.8339629758523939},
-    {0.7637637637637638, 0.8375303776032997},
-    {0.7657657657657657, 0.8411192251255941},
-    {0.7677677677677677, 0.8447298714007243},
-    {0.7697697697697699, 0.8483626781624374},
-    {0.7717717717717718, 0.8520180161935024},
-    {0.7737737737737738, 0.8556962656352002},
-    {0.7757757757757757, 0.8593978163102485},
-    {0.7777777777777777, 0.8631230680598738},
-    {0.7797797797797799, 0.8668724310957834},
-    {0.7817817817817818, 0.8706463263678359},
-    {0.7837837837837838, 0.87444518594827},
-    {0.7857857857857857, 0.878269453433387},
-    {0.7877877877877877, 0.8821195843636612},
-    {0.7897897897897899, 0.8859960466633061},
-    {0.7917917917917918, 0.8898993211003825},
-    {0.7937937937937938, 0.8938299017686367},
-    {0.7957957957957957, 0.8977882965922956},
-    {0.7977977977977977, 0.9017750278551669},
-    {0.7997997997997999, 0.9057906327554596},
-    {0.8018018018018018, 0.90983566398785},
-    {0.8038038038038038, 0.9139106903544266},
-    {0.8058058058058057, 0.9180162974062506},
-    {0.8078078078078077, 0.922153088117403},
-    {0.8098098098098099, 0.9263216835935286},
-    {0.8118118118118118, 0.9305227238170144},
-    {0.8138138138138138, 0.9347568684311255},
-    {0.8158158158158157, 0.9390247975655649},
-    {0.8178178178178177, 0.943327212706135},
-    {0.8198198198198199, 0.9476648376113626},
-    {0.8218218218218218, 0.9520384192791863},
-    {0.8238238238238238, 0.9564487289670347},
-    {0.8258258258258258, 0.9608965632688887},
-    {0.8278278278278277, 0.9653827452532131},
-    {0.8298298298298299, 0.969908125665949},
-    {0.8318318318318318, 0.9744735842031009},
-    {0.8338338338338338, 0.9790800308578386},
-    {0.8358358358358358, 0.9837284073474225},
-    {0.8378378378378377, 0.9884196886257336},
-    {0.8398398398398399, 0.9931548844876695},
-    {0.8418418418418419, 0.9979350412722153},
-    {0.8438438438438438, 1.002761243671599},
-    {0.8458458458458458, 1.0076346166545973},
-    {0.8478478478478477, 1.0125563275127791},
-    {0.8498498498498499, 1.0175275880392927},
-    {0.8518518518518519, 1.0225496568506725},
-    {0.8538538538538538, 1.0276238418631416},
-    {0.8558558558558558, 1.0327515029359593},
-    {0.8578578578578577, 1.037934054695592},
-    {0.8598598598598599, 1.0431729695558225},
-    {0.8618618618618619, 1.0484697809504093},
-    {0.8638638638638638, 1.0538260867965996},
-    {0.8658658658658658, 1.059243553209638},
-    {0.867867867867868, 1.064723918490536},
-    {0.8698698698698699, 1.0702689974116801},
-    {0.8718718718718719, 1.0758806858275207},
-    {0.8738738738738738, 1.0815609656405003},
-    {0.8758758758758758, 1.0873119101557456},
-    {0.877877877877878, 1.0931356898617857},
-    {0.8798798798798799, 1.0990345786788154},
-    {0.8818818818818819, 1.105010960720841},
-    {0.8838838838838838, 1.1110673376234925},
-    {0.8858858858858858, 1.1172063364955207},
-    {0.887887887887888, 1.1234307185590673},
-    {0.8898898898898899, 1.1297433885518924},
-    {0.8918918918918919, 1.1361474049740106},
-    {0.8938938938938938, 1.1426459912718114},
-    {0.8958958958958958, 1.1492425480649817},
-    {0.897897897897898, 1.1559406665356526},
-    {0.8998998998998999, 1.1627441431155108},
-    {0.9019019019019019, 1.1696569956255445},
-    {0.9039039039039038, 1.1766834810450841},
-    {0.9059059059059058, 1.1838281151124794},
-    {0.907907907907908, 1.1910956939897774},
-    {0.9099099099099099, 1.1984913182590078},
-    {0.9119119119119119, 1.2060204195591928},
-    {0.9139139139139139, 1.2136887902222333},
-    {0.9159159159159158, 1.221502616323998},
-    {0.917917917917918, 1.2294685146361783},
-    {0.91991991991992, 1.237593574047231},
-    {0.9219219219219219, 1.2458854021200585},
-    {0.9239239239239239, 1.2543521775737605},
-    {0.9259259259259258, 1.2630027096217713},
-    {0.927927927927928, 1.2718465052749983},
-    {0.92992992992993, 1.2808938459342203},
-    {0.9319319319319319, 1.290155874860998},
-    {0.9339339339339339, 1.2996446974439162},
-    {0.9359359359359358, 1.3093734965842498},
-    {0.937937937937938, 1.3193566660346157},
-    {0.93993993993994, 1.3296099651657514},
-    {0.9419419419419419, 1.3401506994501635},
-    {0.9439439439439439, 1.3509979319906467},
-    {0.9459459459459458, 1.362172732759977},
-    {0.947947947947948, 1.373698473955693},
-    {0.94994994994995, 1.3856011821505718},
-    {0.9519519519519519, 1.3979099609311905},
-    {0.9539539539539539, 1.4106575017426437},
-    {0.9559559559559558, 1.4238807060988297},
-    {0.957957957957958, 1.4376214497616664},
-    {0.95995995995996, 1.4519275298101737},
-    {0.9619619619619619, 1.46685385002573},
-    {0.9639639639639639, 1.4824639207317458},
-    {0.9659659659659658, 1.4988317793083332},
-    {0.967967967967968, 1.516044482121948},
-    {0.96996996996997, 1.5342053858786309},
-    {0.9719719719719719, 1.5534385404325113},
-    {0.9739739739739739, 1.5738946801696516},
-    {0.9759759759759759, 1.5957595708825707},
-    {0.977977977977978, 1.619265924931278},
-    {0.97997997997998, 1.6447108979563174},
-    {0.9819819819819819, 1.6724826501540264},
-    {0.9839839839839839, 1.7031022997516412},
-    {0.9859859859859861, 1.7372934611962487},
-    {0.987987987987988, 1.7761046256096675},
-    {0.98998998998999, 1.821141723239352},
-    {0.991991991991992, 1.875057668304139},
-    {0.9939939939939939, 1.9427428645836247},
-    {0.9959959959959961, 2.0349445059048006},
-    {0.997997997997998, 2.184914100111402},
-    {1., ERFINV_MAX}
-  };
+  // Pass q = v / 2 and 1 - p = (1 - |v|) / 2 directly to avoid cancellation
+  return ppnd16(v / 2., (1. - std::abs(v)) / 2.) / M_SQRT2;
+}
 
-  // Set the closest smaller cached values
-  double v_lower = -1.;
-  double z_lower = -ERFINV_MAX;
-  for (std::pair<double, double> p : ERFINV_CACHED){
-    double& v_cached = p.first;
-    double& z_cached = p.second;
-    if (isequal(v_cached, v)) {
-      return z_cached;
+std::vector<double> polynomial_product(const std::vector<double>& a, const std::vector<double>& b) {
+  if (a.empty() || b.empty()) {
+    return std::vector<double>();
+  }
+  std::vector<double> c(a.size() + b.size() - 1, 0.);
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    for (std::size_t j = 0; j < b.size(); ++j) {
+      c[i + j] += a[i] * b[j];
     }
-    if ((v_cached < v) && (v_cached > v_lower)) {
-        v_lower = v_cached;
-        z_lower = z_cached;
+  }
+  return c;
+}
+
+std::vector<double> polynomial_shift(const std::vector<double>& p, double x0) {
+  // The k-th synthetic division by (x - x0) leaves the k-th Taylor coefficient in q[k]
+  std::vector<double> q(p);
+  const std::size_t n = q.size();
+  for (std::size_t k = 0; k + 1 < n; ++k) {
+    for (std::size_t j = n - 1; j > k; --j) {
+      q[j - 1] += x0 * q[j];
     }
   }
+  return q;
+}
+
+void horner(const double* coeffs, std::size_t order, const double* x, double* y, std::size_t n) {
+  std::size_t i = 0;
 
-  // Increment the lower bound until reaching the input
-  while (z_lower < DBL_MAX){
-    z_lower+=ERFINV_TOL;
-    v_lower = erf(z_lower);
-    if (v_lower > v) {
-        break;
+  // Two independent vectors per iteration hide the latency of the dependent FMAs
+#if defined(__AVX512F__)
+  for (; i + 16 <= n; i += 16) {
+    __m512d x0 = _mm512_loadu_pd(x + i);
+    __m512d x1 = _mm512_loadu_pd(x + i + 8);
+    __m512d p0 = _mm512_set1_pd(coeffs[order]);
+    __m512d p1 = p0;
+    for (std::size_t k = order; k-- > 0;) {
+      __m512d c = _mm512_set1_pd(coeffs[k]);
+      p0 = _mm512_fmadd_pd(p0, x0, c);
+      p1 = _mm512_fmadd_pd(p1, x1, c);
     }
+    _mm512_storeu_pd(y + i, _mm512_add_pd(_mm512_loadu_pd(y + i), p0));
+    _mm512_storeu_pd(y + i + 8, _mm512_add_pd(_mm512_loadu_pd(y + i + 8), p1));
   }
+#endif
+#if defined(__AVX2__) && defined(__FMA__)
+  for (; i + 8 <= n; i += 8) {
+    __m256d x0 = _mm256_loadu_pd(x + i);
+    __m256d x1 = _mm256_loadu_pd(x + i + 4);
+    __m256d p0 = _mm256_set1_pd(coeffs[order]);
+    __m256d p1 = p0;
+    for (std::size_t k = order; k-- > 0;) {
+      __m256d c = _mm256_set1_pd(coeffs[k]);
+      p0 = _mm256_fmadd_pd(p0, x0, c);
+      p1 = _mm256_fmadd_pd(p1, x1, c);
+    }
+    _mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_loadu_pd(y + i), p0));
+    _mm256_storeu_pd(y + i + 4, _mm256_add_pd(_mm256_loadu_pd(y + i + 4), p1));
+  }
+#endif
+
+  // Scalar fallback and remainder
+  for (; i < n; ++i) {
+    double p = coeffs[order];
+    for (std::size_t k = order; k-- > 0;) {
+      p = p * x[i] + coeffs[k];
+    }
+    y[i] += p;
+  }
+}
+
+/// @brief Reinterpret the bits of a double as an integer.
+static inline std::uint64_t to_bits(double x) {
+  std::uint64_t b;
+  std::memcpy(&b, &x, sizeof(b));
+  return b;
+}
+
+/// @brief Reinterpret the bits of an integer as a double.
+static inline double from_bits(std::uint64_t b) {
+  double x;
+  std::memcpy(&x, &b, sizeof(x));
+  return x;
+}
+
+void exp_batch(const double* x, double* y, std::size_t n) {
+  // Rounding constant (1.5 * 2^52) and the two parts of ln(2)
+  const double shift = 6755399441055744.;
+  const double ln2_hi = 6.93147180369123816490e-01;
+  const double ln2_lo = 1.90821492927058770002e-10;
+
+  for (std::size_t i = 0; i < n; ++i) {
+    // Clamp so that the scaling factors below stay finite (the result already overflows or underflows)
+    double v = x[i];
+    double c = (v > 710.) ? 710. : ((v < -746.) ? -746. : v);
+
+    // Reduce the argument: c = k ln(2) + r
+    double t = c * M_LOG2E + shift;
+    double kd = t - shift;
+    std::int64_t k = (std::int64_t)(to_bits(t) - to_bits(shift));
+    double r = (c - kd * ln2_hi) - kd * ln2_lo;
 
-  return z_lower;
+    // Taylor polynomial of exp(r) with |r| <= ln(2) / 2
+    double p = 1. / 6227020800.;
+    p = p * r + 1. / 479001600.;
+    p = p * r + 1. / 39916800.;
+    p = p * r + 1. / 3628800.;
+    p = p * r + 1. / 362880.;
+    p = p * r + 1. / 40320.;
+    p = p * r + 1. / 5040.;
+    p = p * r + 1. / 720.;
+    p = p * r + 1. / 120.;
+    p = p * r + 1. / 24.;
+    p = p * r + 1. / 6.;
+    p = p * r + 0.5;
+    p = p * r + 1.;
+    p = p * r + 1.;
+
+    // Scale by 2^k in two steps so that subnormal results and overflows are exact
+    std::int64_t k1 = (std::int64_t)((std::uint64_t)(k + 2048) >> 1) - 1024;
+    std::int64_t k2 = k - k1;
+    double s1 = from_bits((std::uint64_t)(k1 + 1023) << 52);
+    double s2 = from_bits((std::uint64_t)(k2 + 1023) << 52);
+    double e = p * s1 * s2;
+
+    // Propagate NaN
+    y[i] = (v == v) ? e : v;
+  }
+}
+
+void log_batch(const double* x, double* y, std::size_t n) {
+  const double ln2_hi = 6.93147180369123816490e-01;
+  const double ln2_lo = 1.90821492927058770002e-10;
+  const std::uint64_t mantissa = 0x000FFFFFFFFFFFFFull;
+  const std::uint64_t one = 0x3FF0000000000000ull;
+
+  for (std::size_t i = 0; i < n; ++i) {
+    double v = x[i];
+
+    // Scale the subnormal numbers to normal ones
+    bool subnormal = v < DBL_MIN;
+    double u = subnormal ? v * 4503599627370496. : v;
+    double offset = subnormal ? -52. : 0.;
+
+    // Decompose the argument: u = 2^e m with m in [sqrt(1/2), sqrt(2))
+    std::uint64_t b = to_bits(u);
+    double e = (from_bits(((b >> 52) & 0x7FF) | 0x4330000000000000ull) - 4503599627370496.) - 1023. + offset;
+    double m = from_bits((b & mantissa) | one);
+    bool large = m > M_SQRT2;
+    m = large ? 0.5 * m : m;
+    e = large ? e + 1. : e;
+
+    // Series of 2 atanh(s) with s^2 <= 0.0295
+    double s = (m - 1.) / (m + 1.);
+    double z = s * s;
+    double p = 2. / 23.;
+    p = p * z + 2. / 21.;
+    p = p * z + 2. / 19.;
+    p = p * z + 2. / 17.;
+    p = p * z + 2. / 15.;
+    p = p * z + 2. / 13.;
+    p = p * z + 2. / 11.;
+    p = p * z + 2. / 9.;
+    p = p * z + 2. / 7.;
+    p = p * z + 2. / 5.;
+    p = p * z + 2. / 3.;
+    double l = e * ln2_hi + ((s * z * p + e * ln2_lo) + 2. * s);
+
+    // Special values
+    double special = (v == 0.) ? -HUGE_VAL : ((v == HUGE_VAL) ? HUGE_VAL : std::numeric_limits<double>::quiet_NaN());
+    y[i] = (v > 0. && v < HUGE_VAL) ? l : special;
+  }
 }
@@ -5,11 +5,13 @@
 
 #include <cmath>
 #include <cfloat>
-#include <map>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <iterator>
 
 
 /**
@@ -33,25 +35,95 @@ bool isequal(double a, double b);
  */
 std::vector<std::vector<double>> read_matrix(std::ifstream& fstream, int rows, int cols);
 
-/// @brief The accuracy of the inverse error function output.
-#define ERFINV_TOL 1e-05
+/**
+ * @brief Quantile function (inverse CDF) of the standard normal distribution.
+ * This is the algorithm AS241 (PPND16) of Wichura (1988), which evaluates a rational
+ * approximation in one of three regions of \f$ p \f$. The cost is fixed (at most one
+ * logarithm and one square root) and the relative accuracy is about \f$ 10^{-16} \f$.
+ *
+ * The limits are returned for \f$ p = 0 \f$ and \f$ p = 1 \f$ (\f$ \mp \infty \f$),
+ * and NaN is returned outside of \f$ [0, 1] \f$.
+ *
+ * @param p The probability \f$ p \in (0, 1) \f$.
+ * @return double The value \f$ z \f$ so that \f$ \Phi(z) = p \f$.
+ */
+double normal_quantile(double p);
+
+/**
+ * @brief Quantile function of the standard normal distribution applied to an array.
+ * The same kernel as the scalar version is applied to each element, without any allocation.
+ * The input and the output arrays may be the same (in-place transform).
+ * @param p Pointer to the probabilities.
+ * @param z Pointer to the output array.
+ * @param n The number of elements.
+ */
+void normal_quantile(const double* p, double* z, std::size_t n);
+
+/**
+ * @brief Adds the values of a polynomial at an array of points to an output array.
+ * The polynomial \f$ p(x) = \sum_{k=0}^{K} c_k x^k \f$ is evaluated with Horner's scheme,
+ * which is backward stable for any order. Several points are evaluated at once in SIMD lanes
+ * (AVX-512 or AVX2 with FMA when the code is compiled for them) and the remaining points
+ * are evaluated one by one.
+ * @param coeffs Pointer to the \f$ K + 1 \f$ coefficients \f$ c_0, \dots, c_K \f$.
+ * @param order The order \f$ K \f$ of the polynomial.
+ * @param x Pointer to the points.
+ * @param y Pointer to the output array (the values are added to it).
+ * @param n The number of points.
+ */
+void horner(const double* coeffs, std::size_t order, const double* x, double* y, std::size_t n);
 
-/// @brief The maximum returned value by the inverse error function when approaching -1 or +1.
-#define ERFINV_MAX 10.
+/**
+ * @brief Multiplies two polynomials.
+ * The coefficients are stored in increasing order of the powers, and empty vectors are zero polynomials.
+ * @param a The coefficients of the first polynomial.
+ * @param b The coefficients of the second polynomial.
+ * @return std::vector<double> The coefficients of the product.
+ */
+std::vector<double> polynomial_product(const std::vector<double>& a, const std::vector<double>& b);
+
+/**
+ * @brief Shifts the variable of a polynomial.
+ * The coefficients of \f$ q(w) = p(x_0 + w) \f$ are computed with repeated synthetic divisions
+ * (Taylor shift) in \f$ O(K^2) \f$ operations.
+ * @param p The coefficients of the polynomial \f$ p \f$ (in increasing order of the powers).
+ * @param x0 The shift \f$ x_0 \f$.
+ * @return std::vector<double> The coefficients of \f$ q \f$.
+ */
+std::vector<double> polynomial_shift(const std::vector<double>& p, double x0);
+
+/**
+ * @brief Exponential function applied to an array.
+ * The argument is reduced to \f$ x = k \ln 2 + r \f$ with \f$ |r| \le \ln(2) / 2 \f$, and
+ * \f$ e^r \f$ is evaluated with a polynomial of order 13. The loop has no branches so that the
+ * compiler can vectorize it, and the error is at most a few ULP (units in the last place).
+ * Overflows give \f$ +\infty \f$, underflows give subnormal numbers or zero, and NaN is propagated.
+ * The input and the output arrays may be the same.
+ * @param x Pointer to the arguments.
+ * @param y Pointer to the output array.
+ * @param n The number of elements.
+ */
+void exp_batch(const double* x, double* y, std::size_t n);
+
+/**
+ * @brief Natural logarithm applied to an array.
+ * The argument is decomposed as \f$ x = 2^e m \f$ with \f$ \sqrt{1/2} \le m < \sqrt{2} \f$, and
+ * \f$ \log(m) = 2\, {atanh}(s) \f$ with \f$ s = (m - 1) / (m + 1) \f$ is evaluated with a polynomial in
+ * \f$ s^2 \f$. The loop has no branches so that the compiler can vectorize it, and the error is at most
+ * a few ULP. The special values are the same as std::log (\f$ -\infty \f$ for 0, NaN for negative values).
+ * The input and the output arrays may be the same.
+ * @param x Pointer to the arguments.
+ * @param y Pointer to the output array.
+ * @param n The number of elements.
+ */
+void log_batch(const double* x, double* y, std::size_t n);
 
 /**
  * @brief Inverse error function.
- * This is a naive implementation of the inverse error function.
- * 1000 pairs of input/output values of the error function are cached.
- * The function loops over them to find the closest value to the input,
- * and then increments the cached value and calculates the error function
- * using the standard math library to finally reach the input value.
- *
- * The current tolerance (increment step) is set to 1e-05. Decreasing the tolerance makes the calls slower.
- * However, the speed can be maintained if the number of the cached pairs are increased correspondingly.
- *
- * More advanced implementations or available in the
- * [Boost library](https://www.boost.org/doc/libs/1_59_0/boost/math/special_functions/detail/erf_inv.hpp).
+ * The inverse error function is evaluated through the normal quantile function
+ * using the identity \f$ {erfinv}(v) = \Phi^{-1}((1 + v) / 2) / \sqrt{2} \f$.
+ * The argument is split so that no precision is lost close to 0 and close to \f$ \pm 1 \f$.
+ * If the input is not in \f$ (-1, +1) \f$, an InvalidInputException exception is thrown.
  *
  * @param v The input \f$ v \in (-1, +1) \f$.
  * @return double The output (\f$ z \in R \f$) of the inverse error function so that \f$ {erf}(z) = v \f$.
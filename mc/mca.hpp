@@ -2,14 +2,28 @@
 #define MC_SAMPLER_HPP
 
 #include "distributions.hpp"
+#include "accumulator.hpp"
+#include "samples.hpp"
 #include "vector.hpp"
 
 #include <Eigen/Core>
 
 #include <functional>
+#include <algorithm>
+#include <memory>
 #include <string>
 
 
+#ifndef MCA_DEFAULT_ORDER
+/// @brief The default order of the accumulated moments (hypertailedness).
+#define MCA_DEFAULT_ORDER 6u
+#endif
+
+#ifndef MCA_CHUNK_SIZE
+/// @brief The default number of samples in each chunk of the streaming approximations.
+#define MCA_CHUNK_SIZE 65536
+#endif
+
 /**
  * @brief Class for calculating Monte Carlo Approximations.
  * This class estimates the statistical moments from a set of samples
@@ -34,6 +48,14 @@
  *
  * The moments of vectorial distributions are calculated similarly in each dimension.
  *
+ * The samples can be weighted, e.g., by the likelihood ratios \f$ w_i = p(x_i) / q(x_i) \f$ of samples
+ * drawn from a proposal distribution \f$ q \f$ instead of \f$ p \f$ (importance sampling). The sums
+ * above are then weighted and normalized by \f$ \sum_i w_i \f$ instead of \f$ N \f$.
+ *
+ * All the moments are read from a MomentAccumulator which is filled in a single pass
+ * over the samples the first time a moment is requested. The accumulator is only rebuilt
+ * if a moment with a higher order than the accumulated ones is requested.
+ *
  * @tparam dim The dimension of the samples.
  */
 template <unsigned int dim = 1>
@@ -43,14 +65,56 @@ public:
   /// @brief Construct a MonteCarloApproximator object.
   MonteCarloApproximator() = default;
 
-  /// @brief Construct a MonteCarloApproximator object from a set of samples.
+  /// @brief Construct a MonteCarloApproximator object from a block of samples, which is shared.
+  MonteCarloApproximator(std::shared_ptr<SampleBlock<dim>> samples);
+
+  /// @brief Construct a MonteCarloApproximator object from a set of samples, which are copied to a block.
   MonteCarloApproximator(std::shared_ptr<std::vector<Vector<dim>>> samples);
 
+  /**
+   * @brief Construct a MonteCarloApproximator object from accumulated moments.
+   * The samples are not available, and only the moments up to the order of the accumulator
+   * can be calculated. Accumulators of different sets of samples (e.g., from several threads)
+   * can be merged before building the approximator.
+   * @param accumulator The accumulated moments.
+   */
+  MonteCarloApproximator(const MomentAccumulator<dim>& accumulator);
+
+  /// @brief Construct a MonteCarloApproximator object from a block of samples and their accumulated moments.
+  MonteCarloApproximator(std::shared_ptr<SampleBlock<dim>> samples, const MomentAccumulator<dim>& accumulator);
+
+  /// @brief Construct a MonteCarloApproximator object from a set of samples and their accumulated moments.
+  MonteCarloApproximator(std::shared_ptr<std::vector<Vector<dim>>> samples, const MomentAccumulator<dim>& accumulator);
+
+  /**
+   * @brief Construct a MonteCarloApproximator object from a block of weighted samples and their accumulated moments.
+   * @param samples The samples.
+   * @param weights The weight of each sample.
+   * @param accumulator The accumulated weighted moments (see MomentAccumulator::add).
+   */
+  MonteCarloApproximator(std::shared_ptr<SampleBlock<dim>> samples, std::shared_ptr<std::vector<double>> weights,
+    const MomentAccumulator<dim>& accumulator);
+
   /// @brief Destroy the object.
   ~MonteCarloApproximator();
 
-  /// @brief Return the underlying data.
-  std::vector<Vector<dim>>& data();
+  /// @brief Return the block of samples.
+  const SampleBlock<dim>& samples() const;
+
+  /// @brief Return a copy of the samples as an array of vectors.
+  std::vector<Vector<dim>> data() const;
+
+  /// @brief Return true if the samples are stored.
+  bool has_data() const;
+
+  /// @brief Return the weights of the samples.
+  const std::vector<double>& weights() const;
+
+  /// @brief Return true if the samples are weighted.
+  bool has_weights() const;
+
+  /// @brief Return the accumulated moments of the samples.
+  const MomentAccumulator<dim>& accumulator();
 
   /**
    * @brief Calculate an approximated moment of the samples.
@@ -84,11 +148,17 @@ public:
   Eigen::VectorXd hypertailedness();
 
 private:
-  /// @brief Calculate the moment in one dimension.
-  double moment_dim(unsigned int order, std::string mode, const Eigen::VectorXd& samples_dim);
+  /// @brief Return an accumulator of the samples with at least the given order.
+  const MomentAccumulator<dim>& accumulator(unsigned int order);
 
   /// @brief The samples.
-  std::shared_ptr<std::vector<Vector<dim>>> m_samples;
+  std::shared_ptr<SampleBlock<dim>> m_samples;
+
+  /// @brief The weights of the samples (null without weights).
+  std::shared_ptr<std::vector<double>> m_weights;
+
+  /// @brief The accumulated moments of the samples.
+  std::shared_ptr<MomentAccumulator<dim>> m_accumulator;
 };
 
 #include "mca.tpp"
@@ -2,37 +2,98 @@
 
 
 template<unsigned int dim>
-MonteCarloApproximator<dim>::MonteCarloApproximator(std::shared_ptr<std::vector<Vector<dim>>> samples)
+MonteCarloApproximator<dim>::MonteCarloApproximator(std::shared_ptr<SampleBlock<dim>> samples)
   : m_samples(samples) {}
 
+template<unsigned int dim>
+MonteCarloApproximator<dim>::MonteCarloApproximator(std::shared_ptr<std::vector<Vector<dim>>> samples)
+  : m_samples(std::make_shared<SampleBlock<dim>>(*samples)) {}
+
+template<unsigned int dim>
+MonteCarloApproximator<dim>::MonteCarloApproximator(const MomentAccumulator<dim>& accumulator)
+  : m_accumulator(std::make_shared<MomentAccumulator<dim>>(accumulator)) {}
+
+template<unsigned int dim>
+MonteCarloApproximator<dim>::MonteCarloApproximator(
+  std::shared_ptr<SampleBlock<dim>> samples, const MomentAccumulator<dim>& accumulator)
+  : m_samples(samples), m_accumulator(std::make_shared<MomentAccumulator<dim>>(accumulator)) {}
+
+template<unsigned int dim>
+MonteCarloApproximator<dim>::MonteCarloApproximator(
+  std::shared_ptr<std::vector<Vector<dim>>> samples, const MomentAccumulator<dim>& accumulator)
+  : m_samples(std::make_shared<SampleBlock<dim>>(*samples)),
+    m_accumulator(std::make_shared<MomentAccumulator<dim>>(accumulator)) {}
+
+template<unsigned int dim>
+MonteCarloApproximator<dim>::MonteCarloApproximator(std::shared_ptr<SampleBlock<dim>> samples,
+  std::shared_ptr<std::vector<double>> weights, const MomentAccumulator<dim>& accumulator)
+  : m_samples(samples), m_weights(weights), m_accumulator(std::make_shared<MomentAccumulator<dim>>(accumulator))
+{
+  if (m_samples && m_weights && m_weights->size() != m_samples->size()) {
+    throw InvalidInputException("The number of the weights must be the number of the samples.");
+  }
+}
+
 template<unsigned int dim>
 MonteCarloApproximator<dim>::~MonteCarloApproximator() {}
 
 template<unsigned int dim>
-std::vector<Vector<dim>>& MonteCarloApproximator<dim>::data() {
+const SampleBlock<dim>& MonteCarloApproximator<dim>::samples() const {
+  if (!m_samples) {
+    throw InvalidInputException("The samples are not stored in this approximator.");
+  }
   return *m_samples;
 }
 
 template<unsigned int dim>
-double MonteCarloApproximator<dim>::moment_dim(unsigned int k, std::string mode, const Eigen::VectorXd& samples_dim) {
+std::vector<Vector<dim>> MonteCarloApproximator<dim>::data() const {
+  return samples().to_vectors();
+}
 
-  if (mode == "raw"){
-    return samples_dim.array().pow(k).mean();
-  }
-  else if (mode == "central"){
-    double mean = moment_dim(1, "raw", samples_dim);
-    return (samples_dim.array() - mean).array().pow(k).mean();
-  }
-  else if (mode == "standardized"){
-    double std = sqrt(moment_dim(2, "central", samples_dim));
-    double central = moment_dim(k, "central", samples_dim);
-    return central / pow(std, k);
+template<unsigned int dim>
+bool MonteCarloApproximator<dim>::has_data() const {
+  return (bool)m_samples;
+}
+
+template<unsigned int dim>
+const std::vector<double>& MonteCarloApproximator<dim>::weights() const {
+  if (!m_weights) {
+    throw InvalidInputException("The samples of this approximator are not weighted.");
   }
-  else {
-    throw std::exception();
+  return *m_weights;
+}
+
+template<unsigned int dim>
+bool MonteCarloApproximator<dim>::has_weights() const {
+  return (bool)m_weights;
+}
+
+template<unsigned int dim>
+const MomentAccumulator<dim>& MonteCarloApproximator<dim>::accumulator() {
+  if (m_accumulator) {
+    return *m_accumulator;
   }
+  return accumulator(MCA_DEFAULT_ORDER);
+}
 
-};
+template<unsigned int dim>
+const MomentAccumulator<dim>& MonteCarloApproximator<dim>::accumulator(unsigned int order) {
+  // Accumulate all the samples in one pass
+  if (!m_accumulator || m_accumulator->order() < order) {
+    if (!m_samples) {
+      std::string msg = "The moments of order " + std::to_string(order) + " are not accumulated.";
+      throw InvalidInputException(msg);
+    }
+    m_accumulator = std::make_shared<MomentAccumulator<dim>>(std::max(order, MCA_DEFAULT_ORDER));
+    if (m_weights) {
+      m_accumulator->add(*m_samples, m_weights->data());
+    }
+    else {
+      m_accumulator->add(*m_samples);
+    }
+  }
+  return *m_accumulator;
+}
 
 template<unsigned int dim>
 Eigen::VectorXd MonteCarloApproximator<dim>::moment(std::vector<unsigned int> &orders, std::string mode) {
@@ -41,16 +102,14 @@ Eigen::VectorXd MonteCarloApproximator<dim>::moment(std::vector<unsigned int> &o
     throw InvalidInputException(msg);
   }
 
-  // Build mapped matrix from the samples
-  Eigen::MatrixXd samples(m_samples->size(), dim);
-  for (int i=0; i < m_samples->size(); ++i){
-      samples.row(i) = Eigen::Matrix<double, dim, 1>::Map(&m_samples->at(i)[0]);
-  }
+  // Get the accumulated moments
+  unsigned int order = *std::max_element(orders.begin(), orders.end());
+  const MomentAccumulator<dim>& acc = accumulator(order);
 
   // Calculate moment for each dimension
   Eigen::VectorXd moment(dim);
   for (int i = 0; i < dim; ++i){
-      moment[i] = moment_dim(orders[i], mode, samples.col(i));
+      moment[i] = acc.moment(i, orders[i], mode);
   }
 
   return moment;
@@ -0,0 +1,6 @@
+#include "parallel.hpp"
+
+
+unsigned int default_threads() {
+  return std::max(std::thread::hardware_concurrency(), 1u);
+}
@@ -0,0 +1,36 @@
+#ifndef MC_PARALLEL_HPP
+#define MC_PARALLEL_HPP
+
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <exception>
+
+
+/// @brief Return the default number of threads (the hardware concurrency, at least one).
+unsigned int default_threads();
+
+/**
+ * @brief Run a task on the parts of the range [0, n) in parallel.
+ * The range is split in as many contiguous parts as threads, with sizes that are multiples of align
+ * (except for the last non-empty part) and that differ by at most align. The part t is processed by
+ * f(t, begin, end) in its own thread, and parts may be empty.
+ *
+ * The partition only depends on n, threads, and align. Hence tasks which write their results to
+ * per-part slots (e.g., partial accumulators) give deterministic results once the slots are
+ * reduced in order. An exception thrown by a task is rethrown in the calling thread after all
+ * the threads are joined.
+ *
+ * @tparam F The type of the task.
+ * @param n The size of the range.
+ * @param threads The number of threads (and parts).
+ * @param f The task, called as f(unsigned int t, std::uint64_t begin, std::uint64_t end).
+ * @param align The granularity of the parts.
+ */
+template <typename F>
+void parallel_for(std::uint64_t n, unsigned int threads, const F& f, std::uint64_t align = 1);
+
+#include "parallel.tpp"
+
+#endif
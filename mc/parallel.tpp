@@ -0,0 +1,44 @@
+#include "parallel.hpp"
+
+
+template <typename F>
+void parallel_for(std::uint64_t n, unsigned int threads, const F& f, std::uint64_t align) {
+  threads = std::max(threads, 1u);
+  align = std::max<std::uint64_t>(align, 1);
+  const std::uint64_t units = (n + align - 1) / align;
+
+  // Bounds of the part t
+  auto bound = [=](unsigned int t) {
+    return std::min(n, (units * t / threads) * align);
+  };
+
+  // Run in the calling thread
+  if (threads == 1) {
+    f(0u, std::uint64_t(0), n);
+    return;
+  }
+
+  std::vector<std::thread> workers;
+  std::vector<std::exception_ptr> errors(threads);
+  workers.reserve(threads);
+  for (unsigned int t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t]() {
+      try {
+        f(t, bound(t), bound(t + 1));
+      }
+      catch (...) {
+        errors[t] = std::current_exception();
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  // Rethrow the first error
+  for (auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
@@ -0,0 +1,222 @@
+#include "qmc.hpp"
+
+#include <limits>
+
+
+/// @brief Scale for converting QMC_BITS bits to a double in (0, 1).
+#define QMC_TO_DOUBLE (1. / 9007199254740992.)
+
+namespace {
+
+/// @brief Primitive polynomial and initial direction numbers of a coordinate of the Sobol sequence.
+struct SobolParameters
+{
+  /// @brief The degree of the polynomial.
+  unsigned int s;
+  /// @brief The inner coefficients of the polynomial.
+  unsigned int a;
+  /// @brief The initial direction numbers (odd, m_k < 2^k).
+  unsigned int m[7];
+};
+
+/// @brief The parameters of the coordinates 2 to QMC_MAX_DIM (new-joe-kuo-6.21201).
+const SobolParameters SOBOL_PARAMETERS[QMC_MAX_DIM - 1] = {
+  {1, 0, {1}},
+  {2, 1, {1, 3}},
+  {3, 1, {1, 3, 1}},
+  {3, 2, {1, 1, 1}},
+  {4, 1, {1, 1, 3, 3}},
+  {4, 4, {1, 3, 5, 13}},
+  {5, 2, {1, 1, 5, 5, 17}},
+  {5, 4, {1, 1, 5, 5, 5}},
+  {5, 7, {1, 1, 7, 11, 19}},
+  {5, 11, {1, 1, 5, 1, 1}},
+  {5, 13, {1, 1, 1, 3, 11}},
+  {5, 14, {1, 3, 5, 5, 31}},
+  {6, 1, {1, 3, 3, 9, 7, 49}},
+  {6, 13, {1, 1, 1, 15, 21, 21}},
+  {6, 16, {1, 3, 1, 13, 27, 49}},
+  {6, 19, {1, 1, 1, 15, 7, 5}},
+  {6, 22, {1, 3, 1, 15, 13, 25}},
+  {6, 25, {1, 1, 5, 5, 19, 61}},
+  {7, 1, {1, 3, 7, 11, 23, 15, 103}},
+  {7, 4, {1, 3, 7, 13, 13, 15, 69}}
+};
+
+/// @brief The first QMC_MAX_DIM primes.
+const unsigned int PRIMES[QMC_MAX_DIM] = {
+  2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61, 67, 71, 73
+};
+
+} // namespace
+
+
+QuasiRandomSequence::QuasiRandomSequence(unsigned int dims, bool randomized)
+  : m_dims(dims), m_randomized(randomized) {
+  if (dims == 0 || dims > QMC_MAX_DIM) {
+    throw InvalidInputException("The dimension of a quasi-random sequence must be between 1 and "
+      + std::to_string(QMC_MAX_DIM) + ".");
+  }
+}
+
+QuasiRandomSequence::~QuasiRandomSequence() {}
+
+unsigned int QuasiRandomSequence::dims() const {
+  return m_dims;
+}
+
+bool QuasiRandomSequence::randomized() const {
+  return m_randomized;
+}
+
+std::vector<std::uint64_t> QuasiRandomSequence::shifts(std::uint64_t key) const {
+  Philox rng(key);
+  std::vector<std::uint64_t> shift(m_dims);
+  for (unsigned int d = 0; d < m_dims; ++d) {
+    shift[d] = rng.next() >> (64 - QMC_BITS);
+  }
+  return shift;
+}
+
+SobolSequence::SobolSequence(unsigned int dims, bool randomized)
+  : QuasiRandomSequence(dims, randomized), m_directions(dims * QMC_BITS) {
+  // The first coordinate is the van der Corput sequence in base 2
+  for (unsigned int k = 0; k < QMC_BITS; ++k) {
+    m_directions[k] = std::uint64_t(1) << (QMC_BITS - 1 - k);
+  }
+
+  // The other coordinates follow the recurrence of their primitive polynomial
+  for (unsigned int d = 1; d < dims; ++d) {
+    const SobolParameters& p = SOBOL_PARAMETERS[d - 1];
+    std::uint64_t* v = m_directions.data() + d * QMC_BITS;
+    for (unsigned int k = 0; k < QMC_BITS; ++k) {
+      if (k < p.s) {
+        v[k] = std::uint64_t(p.m[k]) << (QMC_BITS - 1 - k);
+        continue;
+      }
+      v[k] = v[k - p.s] ^ (v[k - p.s] >> p.s);
+      for (unsigned int j = 1; j < p.s; ++j) {
+        if ((p.a >> (p.s - 1 - j)) & 1u) {
+          v[k] ^= v[k - j];
+        }
+      }
+    }
+  }
+}
+
+std::string SobolSequence::name() const {
+  return m_randomized ? "shifted sobol" : "sobol";
+}
+
+std::vector<std::uint64_t> SobolSequence::integer_point(std::uint64_t i) const {
+  if (i >> QMC_BITS) {
+    throw InvalidInputException("The index of a Sobol point must be smaller than 2^" + std::to_string(QMC_BITS) + ".");
+  }
+  std::vector<std::uint64_t> x(m_dims, 0);
+  const std::uint64_t gray = i ^ (i >> 1);
+  for (unsigned int k = 0; k < QMC_BITS; ++k) {
+    if ((gray >> k) & 1u) {
+      for (unsigned int d = 0; d < m_dims; ++d) {
+        x[d] ^= m_directions[d * QMC_BITS + k];
+      }
+    }
+  }
+  return x;
+}
+
+void SobolSequence::points(std::uint64_t first, std::size_t n, double* out, std::size_t ld, std::uint64_t key) const {
+  if (n == 0) {
+    return;
+  }
+
+  // Compute the first point directly, and the next ones from the changed bit of the Gray code
+  std::uint64_t i = m_randomized ? first : first + 1;
+  std::vector<std::uint64_t> x = integer_point(i);
+  const std::vector<std::uint64_t> shift = m_randomized ? shifts(key) : std::vector<std::uint64_t>(m_dims, 0);
+  if ((i + n - 1) >> QMC_BITS) {
+    throw InvalidInputException("The index of a Sobol point must be smaller than 2^" + std::to_string(QMC_BITS) + ".");
+  }
+  for (std::size_t j = 0; j < n; ++j, ++i) {
+    if (j > 0) {
+      // Gray(i) and Gray(i - 1) differ by the lowest set bit of i
+      unsigned int k = 0;
+      while (!((i >> k) & 1u)) ++k;
+      for (unsigned int d = 0; d < m_dims; ++d) {
+        x[d] ^= m_directions[d * QMC_BITS + k];
+      }
+    }
+    for (unsigned int d = 0; d < m_dims; ++d) {
+      out[d * ld + j] = ((x[d] ^ shift[d]) + 0.5) * QMC_TO_DOUBLE;
+    }
+  }
+}
+
+HaltonSequence::HaltonSequence(unsigned int dims, bool randomized)
+  : QuasiRandomSequence(dims, randomized), m_bases(PRIMES, PRIMES + dims) {}
+
+std::string HaltonSequence::name() const {
+  return m_randomized ? "rotated halton" : "halton";
+}
+
+void HaltonSequence::points(std::uint64_t first, std::size_t n, double* out, std::size_t ld, std::uint64_t key) const {
+  if (n == 0) {
+    return;
+  }
+  const std::vector<std::uint64_t> shift = m_randomized ? shifts(key) : std::vector<std::uint64_t>(m_dims, 0);
+
+  for (unsigned int d = 0; d < m_dims; ++d) {
+    // The radical inverse is N / p^K, where N mirrors the K digits of the index in base p
+    const std::uint64_t p = m_bases[d];
+    unsigned int K = 0;
+    std::uint64_t scale = 1;
+    while (scale <= std::numeric_limits<std::uint64_t>::max() / p) {
+      scale *= p;
+      ++K;
+    }
+    std::vector<std::uint64_t> digits(K, 0);
+    std::vector<std::uint64_t> weights(K);
+    std::uint64_t w = scale;
+    for (unsigned int k = 0; k < K; ++k) {
+      w /= p;
+      weights[k] = w;
+    }
+
+    // Digits of the first index
+    std::uint64_t i = m_randomized ? first : first + 1;
+    std::uint64_t N = 0;
+    for (unsigned int k = 0; k < K && i > 0; ++k, i /= p) {
+      digits[k] = i % p;
+      N += digits[k] * weights[k];
+    }
+    if (i > 0) {
+      throw InvalidInputException("The index of a Halton point is too large.");
+    }
+
+    double* x = out + d * ld;
+    const double inv_scale = 1. / (double)scale;
+    const double rotation = m_randomized ? (shift[d] + 0.5) * QMC_TO_DOUBLE : 0.;
+    for (std::size_t j = 0; j < n; ++j) {
+      if (j > 0) {
+        // Increment the index with carries (N is updated modulo 2^64 and stays below p^K)
+        unsigned int k = 0;
+        while (k < K && digits[k] == p - 1) {
+          digits[k] = 0;
+          N -= (p - 1) * weights[k];
+          ++k;
+        }
+        if (k == K) {
+          throw InvalidInputException("The index of a Halton point is too large.");
+        }
+        ++digits[k];
+        N += weights[k];
+      }
+      x[j] = (double)N * inv_scale;
+      if (m_randomized) {
+        // Rotate modulo one, and stay inside of (0, 1)
+        x[j] += rotation;
+        if (x[j] >= 1.) x[j] -= 1.;
+        if (x[j] <= 0.) x[j] = 0.5 * QMC_TO_DOUBLE;
+      }
+    }
+  }
+}
@@ -0,0 +1,134 @@
+#ifndef MC_QMC_HPP
+#define MC_QMC_HPP
+
+#include "exceptions.hpp"
+#include "random.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+/// @brief Number of bits of the coordinates of the quasi-random points (the resolution of a double).
+#define QMC_BITS 53
+
+/// @brief Highest dimension of the Sobol and Halton sequences.
+#define QMC_MAX_DIM 21
+
+
+/**
+ * @brief Abstract class for a low-discrepancy (quasi-random) sequence of points in \f$ (0, 1)^s \f$.
+ * The points are indexed, and any range of indices can be generated directly, so that workers
+ * can generate disjoint ranges of the sequence in any order (skip-ahead).
+ *
+ * A distribution which uses a sequence (see Distribution::sequence) maps the points to its samples
+ * instead of the pseudo-random numbers, e.g., with the quantile function for normal samples. Smooth
+ * functions of quasi-random samples are integrated with an error close to \f$ O(\log(n)^s / n) \f$
+ * instead of \f$ O(1 / \sqrt{n}) \f$.
+ *
+ * A randomized sequence transforms its points with a random key, so that the points of each key are
+ * uniformly distributed and keep the structure of the sequence (randomized quasi-Monte Carlo). The
+ * estimates of independent keys (replicates) give error bars from their spread.
+ */
+class QuasiRandomSequence
+{
+public:
+  /**
+   * @brief Construct a sequence.
+   * @param dims The dimension of the points (at most QMC_MAX_DIM).
+   * @param randomized Whether the points are randomized with the key.
+   */
+  QuasiRandomSequence(unsigned int dims, bool randomized = false);
+
+  virtual ~QuasiRandomSequence();
+
+  /// @brief Return the dimension of the points.
+  unsigned int dims() const;
+
+  /// @brief Return whether the points are randomized with the key.
+  bool randomized() const;
+
+  /// @brief Return the name of the sequence.
+  virtual std::string name() const = 0;
+
+  /**
+   * @brief Generate the points with indices in [first, first + n).
+   * Each coordinate of the points is stored contiguously: coordinate `d` of
+   * point `first + i` is written to `out[d * ld + i]`.
+   * @param first The index of the first point.
+   * @param n The number of the points.
+   * @param out Pointer to the points.
+   * @param ld The distance between the coordinates of a point (leading dimension).
+   * @param key The key of the randomization (ignored if the sequence is not randomized).
+   */
+  virtual void points(std::uint64_t first, std::size_t n, double* out, std::size_t ld, std::uint64_t key = 0) const = 0;
+
+protected:
+  /// @brief Return the random shifts of the coordinates for a key (QMC_BITS bits).
+  std::vector<std::uint64_t> shifts(std::uint64_t key) const;
+
+  /// @brief The dimension of the points.
+  unsigned int m_dims;
+  /// @brief Whether the points are randomized.
+  bool m_randomized;
+};
+
+/**
+ * @brief Sobol sequence with the direction numbers of Joe and Kuo (2008).
+ * The coordinates have QMC_BITS bits. Point \f$ i \f$ is the XOR of the direction numbers of the
+ * bits of the Gray code \f$ i \oplus (i >> 1) \f$, so the first point of a range is computed directly
+ * and each following point only differs from the previous one by one direction number
+ * (Antonov and Saleev, 1979). The points are shifted by half of the resolution as the pseudo-random
+ * numbers (see Philox::uniform), and the first point (the origin) is skipped since it is mapped to
+ * infinite values by quantile functions: the index \f$ i \f$ gives the Sobol point \f$ i + 1 \f$.
+ *
+ * The randomized sequence applies a random digital shift: the integer coordinates are XORed with
+ * random bits which only depend on the key. The shifted points keep the stratification of the
+ * Sobol points, so the origin is not skipped (the index \f$ i \f$ gives the shifted point \f$ i \f$).
+ */
+class SobolSequence:
+  public QuasiRandomSequence
+{
+public:
+  /// @brief Construct a Sobol sequence in dimension dims (with a random digital shift if randomized).
+  SobolSequence(unsigned int dims, bool randomized = false);
+
+  std::string name() const override;
+
+  void points(std::uint64_t first, std::size_t n, double* out, std::size_t ld, std::uint64_t key = 0) const override;
+
+  /// @brief Return the integer coordinates (QMC_BITS bits) of the Sobol point i (the origin is point 0).
+  std::vector<std::uint64_t> integer_point(std::uint64_t i) const;
+
+private:
+  /// @brief The direction numbers, where `m_directions[d * QMC_BITS + k]` is the k-th number of coordinate d.
+  std::vector<std::uint64_t> m_directions;
+};
+
+/**
+ * @brief Halton sequence, whose coordinate d is the radical inverse of the index in the d-th prime base.
+ * The radical inverse of consecutive indices is updated incrementally (as a counter in base p
+ * whose digits are mirrored), so the cost per point is constant on average. The index
+ * \f$ i \f$ gives the Halton point \f$ i + 1 \f$ (the origin is skipped).
+ *
+ * The randomized sequence applies a random rotation modulo one (Cranley and Patterson, 1976)
+ * to each coordinate, which only depends on the key, and does not skip the origin.
+ */
+class HaltonSequence:
+  public QuasiRandomSequence
+{
+public:
+  /// @brief Construct a Halton sequence in dimension dims (with a random rotation if randomized).
+  HaltonSequence(unsigned int dims, bool randomized = false);
+
+  std::string name() const override;
+
+  void points(std::uint64_t first, std::size_t n, double* out, std::size_t ld, std::uint64_t key = 0) const override;
+
+private:
+  /// @brief The prime base of each coordinate.
+  std::vector<unsigned int> m_bases;
+};
+
+#endif
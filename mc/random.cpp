@@ -0,0 +1,161 @@
+#include "random.hpp"
+#include "exceptions.hpp"
+
+#include <limits>
+#include <string>
+
+
+/// @brief Multiplier of the first pair of words.
+#define PHILOX_M0 0xD2511F53u
+/// @brief Multiplier of the second pair of words.
+#define PHILOX_M1 0xCD9E8D57u
+/// @brief Key increment of the first word (golden ratio).
+#define PHILOX_W0 0x9E3779B9u
+/// @brief Key increment of the second word (sqrt(3) - 1).
+#define PHILOX_W1 0xBB67AE85u
+
+/// @brief Number of blocks generated at once by the batch generator.
+#define PHILOX_LANES 8
+
+/// @brief Scale for converting 53 random bits to a double in (0, 1).
+#define PHILOX_TO_DOUBLE (1. / 9007199254740992.)
+
+
+Philox::Philox(std::uint64_t seed, std::uint64_t stream) {
+  this->seed(seed, stream);
+}
+
+void Philox::seed(std::uint64_t seed, std::uint64_t stream) {
+  m_seed = seed;
+  m_stream = stream;
+  m_position = 0;
+  m_buffer_counter = std::numeric_limits<std::uint64_t>::max();
+}
+
+Philox Philox::split(std::uint64_t stream) const {
+  return Philox(m_seed, stream);
+}
+
+Philox Philox::substream(std::uint64_t k) const {
+  if ((m_stream >> 32) != 0 || (k >> 32) != 0) {
+    throw InvalidInputException("The stream (" + std::to_string(m_stream) + ") and the substream ("
+      + std::to_string(k) + ") must be smaller than 2^32.");
+  }
+  return Philox(m_seed, (m_stream << 32) + k);
+}
+
+void Philox::discard(std::uint64_t n) {
+  m_position += n;
+}
+
+std::uint64_t Philox::seed() const {
+  return m_seed;
+}
+
+std::uint64_t Philox::stream() const {
+  return m_stream;
+}
+
+std::uint64_t Philox::position() const {
+  return m_position;
+}
+
+std::array<std::uint32_t, 4> Philox::block(
+  const std::array<std::uint32_t, 4>& ctr, const std::array<std::uint32_t, 2>& key) {
+  std::array<std::uint32_t, 4> x = ctr;
+  std::uint32_t k0 = key[0];
+  std::uint32_t k1 = key[1];
+
+  for (int round = 0; round < 10; ++round) {
+    std::uint64_t p0 = (std::uint64_t)PHILOX_M0 * x[0];
+    std::uint64_t p1 = (std::uint64_t)PHILOX_M1 * x[2];
+    x = {
+      (std::uint32_t)(p1 >> 32) ^ x[1] ^ k0,
+      (std::uint32_t)p1,
+      (std::uint32_t)(p0 >> 32) ^ x[3] ^ k1,
+      (std::uint32_t)p0
+    };
+    k0 += PHILOX_W0;
+    k1 += PHILOX_W1;
+  }
+
+  return x;
+}
+
+void Philox::refill() {
+  std::uint64_t counter = m_position / 2;
+  std::array<std::uint32_t, 4> x = block(
+    {(std::uint32_t)counter, (std::uint32_t)(counter >> 32), (std::uint32_t)m_stream, (std::uint32_t)(m_stream >> 32)},
+    {(std::uint32_t)m_seed, (std::uint32_t)(m_seed >> 32)}
+  );
+  m_buffer[0] = ((std::uint64_t)x[1] << 32) | x[0];
+  m_buffer[1] = ((std::uint64_t)x[3] << 32) | x[2];
+  m_buffer_counter = counter;
+}
+
+std::uint64_t Philox::next() {
+  if (m_position / 2 != m_buffer_counter) {
+    refill();
+  }
+  return m_buffer[m_position++ % 2];
+}
+
+double Philox::uniform() {
+  return ((next() >> 11) + 0.5) * PHILOX_TO_DOUBLE;
+}
+
+void Philox::uniform(double* out, std::size_t n) {
+  std::size_t i = 0;
+
+  // Align the position with the beginning of a block
+  if (n > 0 && m_position % 2 == 1) {
+    out[i++] = uniform();
+  }
+
+  // Generate full blocks without touching the buffer
+  const std::array<std::uint32_t, 2> key = {(std::uint32_t)m_seed, (std::uint32_t)(m_seed >> 32)};
+  const std::uint32_t s0 = (std::uint32_t)m_stream;
+  const std::uint32_t s1 = (std::uint32_t)(m_stream >> 32);
+  std::uint64_t counter = m_position / 2;
+
+  // Encrypt PHILOX_LANES counters at once so that the rounds can be vectorized
+  for (; i + 2 * PHILOX_LANES <= n; i += 2 * PHILOX_LANES, counter += PHILOX_LANES) {
+    std::uint32_t x0[PHILOX_LANES], x1[PHILOX_LANES], x2[PHILOX_LANES], x3[PHILOX_LANES];
+    for (int l = 0; l < PHILOX_LANES; ++l) {
+      x0[l] = (std::uint32_t)(counter + l);
+      x1[l] = (std::uint32_t)((counter + l) >> 32);
+      x2[l] = s0;
+      x3[l] = s1;
+    }
+    std::uint32_t k0 = key[0];
+    std::uint32_t k1 = key[1];
+    for (int round = 0; round < 10; ++round) {
+      for (int l = 0; l < PHILOX_LANES; ++l) {
+        std::uint64_t p0 = (std::uint64_t)PHILOX_M0 * x0[l];
+        std::uint64_t p1 = (std::uint64_t)PHILOX_M1 * x2[l];
+        x0[l] = (std::uint32_t)(p1 >> 32) ^ x1[l] ^ k0;
+        x1[l] = (std::uint32_t)p1;
+        x2[l] = (std::uint32_t)(p0 >> 32) ^ x3[l] ^ k1;
+        x3[l] = (std::uint32_t)p0;
+      }
+      k0 += PHILOX_W0;
+      k1 += PHILOX_W1;
+    }
+    for (int l = 0; l < PHILOX_LANES; ++l) {
+      out[i + 2 * l] = (((((std::uint64_t)x1[l] << 32) | x0[l]) >> 11) + 0.5) * PHILOX_TO_DOUBLE;
+      out[i + 2 * l + 1] = (((((std::uint64_t)x3[l] << 32) | x2[l]) >> 11) + 0.5) * PHILOX_TO_DOUBLE;
+    }
+  }
+
+  for (; i + 2 <= n; i += 2, ++counter) {
+    std::array<std::uint32_t, 4> x = block({(std::uint32_t)counter, (std::uint32_t)(counter >> 32), s0, s1}, key);
+    out[i] = (((((std::uint64_t)x[1] << 32) | x[0]) >> 11) + 0.5) * PHILOX_TO_DOUBLE;
+    out[i + 1] = (((((std::uint64_t)x[3] << 32) | x[2]) >> 11) + 0.5) * PHILOX_TO_DOUBLE;
+  }
+  m_position = 2 * counter;
+
+  // Draw the remaining number from the buffer
+  if (i < n) {
+    out[i++] = uniform();
+  }
+}
@@ -0,0 +1,105 @@
+#ifndef MC_RANDOM_HPP
+#define MC_RANDOM_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+
+#ifndef RAND_SEED
+/// @brief Seed for random number generation.
+#define RAND_SEED 42
+#endif
+
+
+/**
+ * @brief Counter-based pseudo-random number generator (Philox4x32-10).
+ * The generator of Salmon et al. (2011) encrypts a 128-bit counter with a 64-bit key
+ * in 10 rounds. Each encrypted counter gives two 64-bit random numbers.
+ *
+ * The key is the seed and the upper half of the counter is a stream identifier.
+ * The lower half of the counter is the position in the stream.
+ * Therefore, the state is only a few integers and:
+ *
+ * - Jumping ahead in a stream (Philox::discard) is done in constant time.
+ * - Streams with different identifiers (Philox::split) are independent.
+ *   Parallel workers can draw from disjoint streams which only depend on the seed
+ *   and on the stream identifier, and not on the number of workers.
+ */
+class Philox
+{
+public:
+  /**
+   * @brief Construct a generator at the beginning of a stream.
+   * @param seed The seed (key) of the generator.
+   * @param stream The identifier of the stream.
+   */
+  Philox(std::uint64_t seed = RAND_SEED, std::uint64_t stream = 0);
+
+  /// @brief Reset the generator to the beginning of a stream.
+  void seed(std::uint64_t seed, std::uint64_t stream = 0);
+
+  /// @brief Return a generator with the same seed at the beginning of another stream.
+  Philox split(std::uint64_t stream) const;
+
+  /**
+   * @brief Return the generator of the k-th substream of the current stream.
+   * Substreams are used for splitting a large number of samples in chunks which
+   * can be generated in any order. The substreams of stream \f$ s \f$ have the identifiers
+   * \f$ 2^{32} s + k \f$, so the substreams of different streams do not overlap. An InvalidInputException
+   * exception is thrown if the stream or the index does not fit in 32 bits.
+   * @param k The index of the substream (smaller than \f$ 2^{32} \f$).
+   * @return Philox The generator at the beginning of the substream.
+   */
+  Philox substream(std::uint64_t k) const;
+
+  /// @brief Skip the next n random numbers of the stream in constant time.
+  void discard(std::uint64_t n);
+
+  /// @brief Return the seed of the generator.
+  std::uint64_t seed() const;
+  /// @brief Return the identifier of the stream.
+  std::uint64_t stream() const;
+  /// @brief Return the number of random numbers drawn from the stream.
+  std::uint64_t position() const;
+
+  /// @brief Draw a 64-bit random integer.
+  std::uint64_t next();
+
+  /// @brief Draw a double with 53 random bits from the open interval (0, 1).
+  double uniform();
+
+  /**
+   * @brief Draw n doubles from the open interval (0, 1).
+   * The output is the same as n successive calls of Philox::uniform().
+   * @param out Pointer to the output array.
+   * @param n The number of random numbers.
+   */
+  void uniform(double* out, std::size_t n);
+
+  /**
+   * @brief Encrypt a counter with a key (one block of the Philox4x32-10 generator).
+   * @param ctr The counter.
+   * @param key The key.
+   * @return std::array<std::uint32_t, 4> The random block.
+   */
+  static std::array<std::uint32_t, 4> block(
+    const std::array<std::uint32_t, 4>& ctr, const std::array<std::uint32_t, 2>& key);
+
+private:
+  /// @brief Generate the block containing the current position.
+  void refill();
+
+  /// @brief The key of the generator.
+  std::uint64_t m_seed;
+  /// @brief The stream identifier (upper half of the counter).
+  std::uint64_t m_stream;
+  /// @brief The number of random numbers drawn from the stream.
+  std::uint64_t m_position;
+  /// @brief The last generated block.
+  std::array<std::uint64_t, 2> m_buffer;
+  /// @brief The counter of the last generated block.
+  std::uint64_t m_buffer_counter;
+};
+
+#endif
@@ -0,0 +1,158 @@
+#include "samples.hpp"
+
+#include <algorithm>
+#include <limits>
+
+
+BufferPool::Buffer::Buffer()
+  : m_pool(nullptr), m_data(nullptr), m_capacity(0) {}
+
+BufferPool::Buffer::Buffer(BufferPool* pool, double* data, std::size_t capacity)
+  : m_pool(pool), m_data(data), m_capacity(capacity) {}
+
+BufferPool::Buffer::Buffer(Buffer&& other) noexcept
+  : m_pool(other.m_pool), m_data(other.m_data), m_capacity(other.m_capacity) {
+  other.m_data = nullptr;
+  other.m_capacity = 0;
+}
+
+BufferPool::Buffer& BufferPool::Buffer::operator=(Buffer&& other) noexcept {
+  if (this != &other) {
+    reset();
+    m_pool = other.m_pool;
+    m_data = other.m_data;
+    m_capacity = other.m_capacity;
+    other.m_data = nullptr;
+    other.m_capacity = 0;
+  }
+  return *this;
+}
+
+BufferPool::Buffer::~Buffer() {
+  reset();
+}
+
+double* BufferPool::Buffer::data() const {
+  return m_data;
+}
+
+std::size_t BufferPool::Buffer::capacity() const {
+  return m_capacity;
+}
+
+void BufferPool::Buffer::reset() {
+  if (m_data) {
+    if (m_pool) {
+      m_pool->release(m_data, m_capacity);
+    }
+    else {
+      AlignedAllocator<double, SAMPLE_ALIGNMENT>().deallocate(m_data, m_capacity);
+    }
+  }
+  m_data = nullptr;
+  m_capacity = 0;
+}
+
+BufferPool::BufferPool()
+  : m_owned(0), m_allocations(0), m_elements(0), m_limit(std::numeric_limits<std::size_t>::max()) {}
+
+BufferPool::~BufferPool() {
+  clear();
+}
+
+BufferPool::Buffer BufferPool::acquire(std::size_t n) {
+  {
+    // Take the smallest available buffer which is large enough
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::size_t best = m_free.size();
+    for (std::size_t k = 0; k < m_free.size(); ++k) {
+      if (m_free[k].first >= n && (best == m_free.size() || m_free[k].first < m_free[best].first)) {
+        best = k;
+      }
+    }
+    if (best < m_free.size()) {
+      std::pair<std::size_t, double*> buffer = m_free[best];
+      m_free[best] = m_free.back();
+      m_free.pop_back();
+      m_elements -= buffer.first;
+      return Buffer(this, buffer.second, buffer.first);
+    }
+  }
+
+  Buffer buffer = allocate(n);
+  std::lock_guard<std::mutex> lock(m_mutex);
+  // Keep room in the free list to give the buffer back without allocating
+  m_free.reserve(m_owned + 1);
+  ++m_owned;
+  ++m_allocations;
+  buffer.m_pool = this;
+  return buffer;
+}
+
+BufferPool::Buffer BufferPool::allocate(std::size_t n) {
+  // Round up to whole cache lines
+  const std::size_t line = SAMPLE_ALIGNMENT / sizeof(double);
+  std::size_t capacity = std::max<std::size_t>(((n + line - 1) / line) * line, line);
+  return Buffer(nullptr, AlignedAllocator<double, SAMPLE_ALIGNMENT>().allocate(capacity), capacity);
+}
+
+void BufferPool::clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (const std::pair<std::size_t, double*>& buffer : m_free) {
+    AlignedAllocator<double, SAMPLE_ALIGNMENT>().deallocate(buffer.second, buffer.first);
+  }
+  m_owned -= m_free.size();
+  m_free.clear();
+  m_elements = 0;
+}
+
+void BufferPool::trim(std::size_t n) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  trim_locked(n);
+}
+
+void BufferPool::set_limit(std::size_t n) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_limit = n;
+  trim_locked(n);
+}
+
+std::size_t BufferPool::limit() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_limit;
+}
+
+std::size_t BufferPool::allocations() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_allocations;
+}
+
+std::size_t BufferPool::available() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_free.size();
+}
+
+BufferPool& BufferPool::shared() {
+  static BufferPool pool;
+  return pool;
+}
+
+void BufferPool::release(double* data, std::size_t capacity) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_free.emplace_back(capacity, data);
+  m_elements += capacity;
+  if (m_elements > m_limit) {
+    trim_locked(m_limit);
+  }
+}
+
+void BufferPool::trim_locked(std::size_t n) {
+  while (m_elements > n) {
+    auto largest = std::max_element(m_free.begin(), m_free.end());
+    AlignedAllocator<double, SAMPLE_ALIGNMENT>().deallocate(largest->second, largest->first);
+    m_elements -= largest->first;
+    *largest = m_free.back();
+    m_free.pop_back();
+    --m_owned;
+  }
+}
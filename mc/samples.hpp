@@ -0,0 +1,251 @@
+#ifndef MC_SAMPLES_HPP
+#define MC_SAMPLES_HPP
+
+#include "vector.hpp"
+#include "exceptions.hpp"
+
+#include <Eigen/Core>
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+#ifndef SAMPLE_ALIGNMENT
+/// @brief Alignment of the columns of the blocks of samples in bytes (one cache line).
+#define SAMPLE_ALIGNMENT 64
+#endif
+
+/**
+ * @brief Allocator of arrays aligned to a given number of bytes.
+ * @tparam T The type of the elements.
+ * @tparam alignment The alignment in bytes.
+ */
+template <typename T, std::size_t alignment>
+struct AlignedAllocator
+{
+  typedef T value_type;
+
+  /// @brief The allocator of another type with the same alignment.
+  template <typename U>
+  struct rebind
+  {
+    typedef AlignedAllocator<U, alignment> other;
+  };
+
+  AlignedAllocator() = default;
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, alignment>&) {}
+
+  /// @brief Allocate an aligned array of n elements.
+  T* allocate(std::size_t n);
+  /// @brief Free an array of n elements (with the sized deallocation function).
+  void deallocate(T* p, std::size_t n);
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, alignment>&) const { return true; }
+  template <typename U>
+  bool operator!=(const AlignedAllocator<U, alignment>&) const { return false; }
+};
+
+/**
+ * @brief Pool of aligned buffers of doubles which are recycled across estimates.
+ * The buffers are leased with BufferPool::acquire and given back to the pool when their lease is
+ * destroyed, instead of being freed. A request is served by the smallest available buffer which is
+ * large enough, so repeated estimates of the same sizes (e.g., replicates, chunks, or the blocks of
+ * a benchmark) only allocate memory until the pool holds as many buffers as they lease at the same time
+ * (which can depend on the scheduling of the threads). The available buffers are freed by
+ * BufferPool::clear, BufferPool::trim, when they exceed the limit of the pool (see BufferPool::set_limit),
+ * and by the destructor of the pool, which must outlive its leases.
+ *
+ * The pool is shared by the threads (its free list is protected by a mutex which is only locked to
+ * lease and give back buffers). The worker threads of parallel_for only live for one call, so a
+ * cache per thread would not survive between estimates. The functions draw their sample blocks and
+ * scratch buffers from BufferPool::shared.
+ */
+class BufferPool
+{
+public:
+  /// @brief A lease of an aligned buffer, which gives the buffer back when it is destroyed (move-only).
+  class Buffer
+  {
+  public:
+    /// @brief Construct an empty buffer.
+    Buffer();
+    Buffer(Buffer&& other) noexcept;
+    Buffer& operator=(Buffer&& other) noexcept;
+    Buffer(const Buffer&) = delete;
+    Buffer& operator=(const Buffer&) = delete;
+    /// @brief Give the buffer back to its pool (or free it if it has no pool).
+    ~Buffer();
+
+    /// @brief Return a pointer to the first element (aligned to SAMPLE_ALIGNMENT bytes).
+    double* data() const;
+    /// @brief Return the number of elements of the buffer.
+    std::size_t capacity() const;
+    /// @brief Give the buffer back now and make the lease empty.
+    void reset();
+
+  private:
+    friend class BufferPool;
+    Buffer(BufferPool* pool, double* data, std::size_t capacity);
+
+    /// @brief The pool which the buffer is given back to (none for buffers owned by the lease).
+    BufferPool* m_pool;
+    /// @brief The elements.
+    double* m_data;
+    /// @brief The number of elements.
+    std::size_t m_capacity;
+  };
+
+  BufferPool();
+  BufferPool(const BufferPool&) = delete;
+  BufferPool& operator=(const BufferPool&) = delete;
+  /// @brief Free the available buffers.
+  ~BufferPool();
+
+  /// @brief Lease a buffer of at least n elements, which is recycled if possible.
+  Buffer acquire(std::size_t n);
+
+  /// @brief Allocate a buffer of n elements which is freed with its lease (outside of any pool).
+  static Buffer allocate(std::size_t n);
+
+  /// @brief Free the available buffers (the leased buffers are still given back later).
+  void clear();
+
+  /**
+   * @brief Free the largest available buffers until at most n elements are available.
+   * @param n The number of available elements which are kept.
+   */
+  void trim(std::size_t n);
+
+  /**
+   * @brief Cap the number of available elements (unlimited by default).
+   * The available buffers are trimmed to the limit, and the buffers which are given back beyond
+   * the limit are freed (see BufferPool::trim).
+   * @param n The largest number of available elements.
+   */
+  void set_limit(std::size_t n);
+  /// @brief Return the largest number of available elements.
+  std::size_t limit() const;
+
+  /// @brief Return the number of buffers allocated by the pool so far (including the freed ones).
+  std::size_t allocations() const;
+  /// @brief Return the number of available buffers.
+  std::size_t available() const;
+
+  /// @brief Return the pool shared by the library.
+  static BufferPool& shared();
+
+private:
+  /// @brief Give a buffer back.
+  void release(double* data, std::size_t capacity);
+  /// @brief Free the largest available buffers until at most n elements are available (with the lock held).
+  void trim_locked(std::size_t n);
+
+  /// @brief The lock of the free list.
+  mutable std::mutex m_mutex;
+  /// @brief The available buffers (capacity and elements).
+  std::vector<std::pair<std::size_t, double*>> m_free;
+  /// @brief The number of buffers of the pool (leased or available).
+  std::size_t m_owned;
+  /// @brief The number of allocations.
+  std::size_t m_allocations;
+  /// @brief The number of available elements.
+  std::size_t m_elements;
+  /// @brief The largest number of available elements.
+  std::size_t m_limit;
+};
+
+/**
+ * @brief Block of samples stored coordinate by coordinate (structure of arrays).
+ * Coordinate `d` of sample `i` is stored at `data()[d * ld() + i]`. The leading dimension is the
+ * number of samples rounded up to a whole number of cache lines, so that each column starts on
+ * a cache line. The columns are the contiguous coordinate streams read by the batch kernels of
+ * the functions (see Function::operator()) and by the accumulators (see MomentAccumulator::add),
+ * and they are viewed without copies as an Eigen matrix with one column per coordinate.
+ *
+ * The blocks are the common container of the samples of the distributions, of the outputs of the
+ * functions, and of the Monte Carlo approximators. Arrays of Vector objects are converted with
+ * the constructor and with SampleBlock::to_vectors.
+ *
+ * The columns are stored in a buffer which is either owned by the block or leased from a
+ * BufferPool, in which case it is recycled by the pool when the block is destroyed.
+ * @tparam dim The dimension of the samples.
+ */
+template <unsigned int dim>
+class SampleBlock
+{
+public:
+  /// @brief The Eigen matrix of the samples (one row per sample, one column per coordinate).
+  typedef Eigen::Matrix<double, Eigen::Dynamic, dim> Matrix;
+  /// @brief A view of the samples as an Eigen matrix.
+  typedef Eigen::Map<Matrix, Eigen::Aligned64, Eigen::OuterStride<>> MatrixMap;
+  /// @brief A constant view of the samples as an Eigen matrix.
+  typedef Eigen::Map<const Matrix, Eigen::Aligned64, Eigen::OuterStride<>> ConstMatrixMap;
+
+  /// @brief Construct a block of n uninitialized samples.
+  SampleBlock(std::size_t n = 0);
+
+  /// @brief Construct a block of n uninitialized samples whose columns are leased from a pool.
+  SampleBlock(std::size_t n, BufferPool& pool);
+
+  /// @brief Construct a block from an array of vectors.
+  SampleBlock(const std::vector<Vector<dim>>& samples);
+
+  /// @brief Copy a block (the copy leases its columns from the same pool, if any).
+  SampleBlock(const SampleBlock& other);
+  SampleBlock(SampleBlock&&) = default;
+  SampleBlock& operator=(const SampleBlock& other);
+  SampleBlock& operator=(SampleBlock&&) = default;
+
+  /// @brief Change the number of samples (the samples are not preserved, and the buffer is only
+  /// replaced when it is too small).
+  void resize(std::size_t n);
+
+  /// @brief Return the number of samples.
+  std::size_t size() const;
+  /// @brief Return the distance between the coordinates of a sample (leading dimension).
+  std::size_t ld() const;
+
+  /// @brief Return a pointer to the first coordinate of the first sample.
+  double* data();
+  /// @brief Return a pointer to the first coordinate of the first sample.
+  const double* data() const;
+
+  /// @brief Return a pointer to the contiguous values of coordinate d.
+  double* column(unsigned int d);
+  /// @brief Return a pointer to the contiguous values of coordinate d.
+  const double* column(unsigned int d) const;
+
+  /// @brief Return sample i as a vector.
+  Vector<dim> operator[](std::size_t i) const;
+  /// @brief Set sample i to a vector.
+  void set(std::size_t i, const Vector<dim>& x);
+
+  /// @brief Return a view of the samples as an Eigen matrix (e.g., `block.matrix().colwise().mean()`).
+  MatrixMap matrix();
+  /// @brief Return a constant view of the samples as an Eigen matrix.
+  ConstMatrixMap matrix() const;
+
+  /// @brief Convert the samples to an array of vectors.
+  std::vector<Vector<dim>> to_vectors() const;
+
+private:
+  /// @brief The number of samples.
+  std::size_t m_size;
+  /// @brief The leading dimension.
+  std::size_t m_ld;
+  /// @brief The pool of the columns (none if the block owns its columns).
+  BufferPool* m_pool;
+  /// @brief The aligned columns.
+  BufferPool::Buffer m_buffer;
+};
+
+#include "samples.tpp"
+
+#endif
@@ -0,0 +1,123 @@
+#include "samples.hpp"
+
+
+template <typename T, std::size_t alignment>
+T* AlignedAllocator<T, alignment>::allocate(std::size_t n) {
+  return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignment)));
+}
+
+template <typename T, std::size_t alignment>
+void AlignedAllocator<T, alignment>::deallocate(T* p, std::size_t n) {
+  ::operator delete(p, n * sizeof(T), std::align_val_t(alignment));
+}
+
+template <unsigned int dim>
+SampleBlock<dim>::SampleBlock(std::size_t n)
+  : m_size(0), m_ld(0), m_pool(nullptr) {
+  resize(n);
+}
+
+template <unsigned int dim>
+SampleBlock<dim>::SampleBlock(std::size_t n, BufferPool& pool)
+  : m_size(0), m_ld(0), m_pool(&pool) {
+  resize(n);
+}
+
+template <unsigned int dim>
+SampleBlock<dim>::SampleBlock(const std::vector<Vector<dim>>& samples)
+  : SampleBlock<dim>(samples.size()) {
+  for (std::size_t i = 0; i < m_size; ++i) {
+    set(i, samples[i]);
+  }
+}
+
+template <unsigned int dim>
+SampleBlock<dim>::SampleBlock(const SampleBlock<dim>& other)
+  : m_size(0), m_ld(0), m_pool(other.m_pool) {
+  *this = other;
+}
+
+template <unsigned int dim>
+SampleBlock<dim>& SampleBlock<dim>::operator=(const SampleBlock<dim>& other) {
+  if (this != &other) {
+    resize(other.m_size);
+    std::copy(other.data(), other.data() + dim * m_ld, data());
+  }
+  return *this;
+}
+
+template <unsigned int dim>
+void SampleBlock<dim>::resize(std::size_t n) {
+  const std::size_t line = SAMPLE_ALIGNMENT / sizeof(double);
+  m_size = n;
+  m_ld = ((n + line - 1) / line) * line;
+  if (m_buffer.capacity() < dim * m_ld) {
+    m_buffer.reset();
+    m_buffer = m_pool ? m_pool->acquire(dim * m_ld) : BufferPool::allocate(dim * m_ld);
+  }
+}
+
+template <unsigned int dim>
+std::size_t SampleBlock<dim>::size() const {
+  return m_size;
+}
+
+template <unsigned int dim>
+std::size_t SampleBlock<dim>::ld() const {
+  return m_ld;
+}
+
+template <unsigned int dim>
+double* SampleBlock<dim>::data() {
+  return m_buffer.data();
+}
+
+template <unsigned int dim>
+const double* SampleBlock<dim>::data() const {
+  return m_buffer.data();
+}
+
+template <unsigned int dim>
+double* SampleBlock<dim>::column(unsigned int d) {
+  return m_buffer.data() + d * m_ld;
+}
+
+template <unsigned int dim>
+const double* SampleBlock<dim>::column(unsigned int d) const {
+  return m_buffer.data() + d * m_ld;
+}
+
+template <unsigned int dim>
+Vector<dim> SampleBlock<dim>::operator[](std::size_t i) const {
+  Vector<dim> x;
+  for (unsigned int d = 0; d < dim; ++d) {
+    x[d] = m_buffer.data()[d * m_ld + i];
+  }
+  return x;
+}
+
+template <unsigned int dim>
+void SampleBlock<dim>::set(std::size_t i, const Vector<dim>& x) {
+  for (unsigned int d = 0; d < dim; ++d) {
+    m_buffer.data()[d * m_ld + i] = x[d];
+  }
+}
+
+template <unsigned int dim>
+typename SampleBlock<dim>::MatrixMap SampleBlock<dim>::matrix() {
+  return MatrixMap(m_buffer.data(), m_size, dim, Eigen::OuterStride<>(m_ld));
+}
+
+template <unsigned int dim>
+typename SampleBlock<dim>::ConstMatrixMap SampleBlock<dim>::matrix() const {
+  return ConstMatrixMap(m_buffer.data(), m_size, dim, Eigen::OuterStride<>(m_ld));
+}
+
+template <unsigned int dim>
+std::vector<Vector<dim>> SampleBlock<dim>::to_vectors() const {
+  std::vector<Vector<dim>> samples(m_size);
+  for (std::size_t i = 0; i < m_size; ++i) {
+    samples[i] = (*this)[i];
+  }
+  return samples;
+}
@@ -8,6 +8,183 @@
 #include <iostream>
 #include <cmath>
 #include <vector>
+#include <cstddef>
+
+/**
+ * @brief Storage parameters of a Vector<dim>.
+ * Vectors of 2 and 4 doubles are aligned to their size, so that a whole vector is loaded
+ * in one SSE2 or AVX register, and the element-wise operations are compiled to a few
+ * packet instructions by Eigen. The other dimensions keep the alignment of a double.
+ * In all cases, the size of a vector is `dim * sizeof(double)` (no padding in arrays of vectors).
+ * @tparam dim Dimension of the vector.
+ */
+template <unsigned int dim>
+struct VectorStorage
+{
+  /// @brief The alignment of the elements in bytes.
+  static constexpr std::size_t alignment = (dim == 2 || dim == 4) ? dim * sizeof(double) : alignof(double);
+  /// @brief The alignment of the elements for the Eigen maps.
+  static constexpr int map_alignment = (dim == 2) ? Eigen::Aligned16 : (dim == 4) ? Eigen::Aligned32 : Eigen::Unaligned;
+};
+
+template <unsigned int dim> class Vector;
+
+/// @brief Sum of two operands.
+struct OperationSum
+{
+  static double apply(double a, double b);
+};
+
+/// @brief Difference of two operands.
+struct OperationSub
+{
+  static double apply(double a, double b);
+};
+
+/// @brief Product of two operands.
+struct OperationMul
+{
+  static double apply(double a, double b);
+};
+
+/// @brief Quotient of two operands.
+struct OperationDiv
+{
+  static double apply(double a, double b);
+};
+
+/// @brief Power of an operand by another one.
+struct OperationPow
+{
+  static double apply(double a, double b);
+};
+
+/// @brief Opposite of an operand.
+struct OperationNeg
+{
+  static double apply(double a);
+};
+
+/// @brief Absolute value of an operand.
+struct OperationAbs
+{
+  static double apply(double a);
+};
+
+/// @brief Exponential of an operand.
+struct OperationExp
+{
+  static double apply(double a);
+};
+
+/// @brief Logarithm of an operand.
+struct OperationLog
+{
+  static double apply(double a);
+};
+
+template <typename Op, typename E, unsigned int dim> class VectorUnary;
+template <typename Op, typename L, typename R, unsigned int dim> class VectorBinary;
+template <unsigned int dim> class VectorScalar;
+
+/**
+ * @brief Base class of the lazy element-wise expressions of vectors (CRTP).
+ * The arithmetic operators of vectors do not compute their result, but return a small object
+ * which stores the operands (by value, so that an expression never refers to a destroyed temporary)
+ * and computes one element of the result on demand. The type of an expression is built at compile time,
+ * e.g., `(u - v).abs() / u` has the type
+ * `VectorBinary<OperationDiv, VectorUnary<OperationAbs, VectorBinary<OperationSub, Vector, Vector>>, Vector>`.
+ * The whole expression is evaluated in a single loop over the elements when it is assigned to a Vector,
+ * without any temporary vector.
+ * @tparam Derived The type of the expression.
+ * @tparam dim Dimension of the vectors.
+ */
+template <typename Derived, unsigned int dim>
+class VectorExpression
+{
+public:
+  /// @brief Return the expression as its derived type.
+  const Derived& derived() const;
+
+  /// @brief Compute an element of the expression.
+  double operator[](unsigned int idx) const;
+
+  /// @brief Negation operator
+  VectorUnary<OperationNeg, Derived, dim> operator-() const;
+  /// @brief Gets absoulte values of all the elements of the expression
+  VectorUnary<OperationAbs, Derived, dim> abs() const;
+  /// @brief Gets element-wise exponential of the expression
+  VectorUnary<OperationExp, Derived, dim> exp() const;
+  /// @brief Gets element-wise logarithm of the expression
+  VectorUnary<OperationLog, Derived, dim> log() const;
+  /// @brief Operator for element-wise power by a scalar
+  VectorBinary<OperationPow, Derived, VectorScalar<dim>, dim> operator^(const double& s) const;
+
+  /// @brief Perform a dot-product of the expression with another expression
+  template <typename E>
+  double dot(const VectorExpression<E, dim>& v) const;
+};
+
+/**
+ * @brief Scalar operand of a vector expression, with the same value for all the elements.
+ * @tparam dim Dimension of the vectors.
+ */
+template <unsigned int dim>
+class VectorScalar : public VectorExpression<VectorScalar<dim>, dim>
+{
+public:
+  /// @brief Construct a scalar operand.
+  VectorScalar(double s);
+  /// @brief Return the scalar.
+  double operator[](unsigned int idx) const;
+
+private:
+  /// @brief The scalar.
+  double m_value;
+};
+
+/**
+ * @brief Element-wise function of an expression.
+ * @tparam Op The function (e.g., OperationAbs).
+ * @tparam E The type of the operand.
+ * @tparam dim Dimension of the vectors.
+ */
+template <typename Op, typename E, unsigned int dim>
+class VectorUnary : public VectorExpression<VectorUnary<Op, E, dim>, dim>
+{
+public:
+  /// @brief Construct the function of an operand.
+  VectorUnary(const E& operand);
+  /// @brief Compute an element of the function.
+  double operator[](unsigned int idx) const;
+
+private:
+  /// @brief The operand.
+  E m_operand;
+};
+
+/**
+ * @brief Element-wise operation between two expressions (or an expression and a scalar).
+ * @tparam Op The operation (e.g., OperationSum).
+ * @tparam L The type of the left operand.
+ * @tparam R The type of the right operand.
+ * @tparam dim Dimension of the vectors.
+ */
+template <typename Op, typename L, typename R, unsigned int dim>
+class VectorBinary : public VectorExpression<VectorBinary<Op, L, R, dim>, dim>
+{
+public:
+  /// @brief Construct the operation between two operands.
+  VectorBinary(const L& left, const R& right);
+  /// @brief Compute an element of the operation.
+  double operator[](unsigned int idx) const;
+
+private:
+  /// @brief The left operand.
+  L m_left;
+  /// @brief The right operand.
+  R m_right;
+};
 
 /**
  * @brief Vector of doubles with fixed dimension
@@ -15,14 +192,21 @@
  * The data is stored in a fixed-size double arary.
  * Element-wise arithmetic operators with other vectors or scalars are possible.
  * Constructing from a standard vector is also possible.
+ *
+ * The copy and move operations are the default ones, so the vectors are trivially copyable
+ * (e.g., arrays of vectors are copied with memcpy). The arithmetic operators build lazy expressions
+ * (see VectorExpression) which are evaluated element by element when they are assigned to a vector,
+ * in a loop which the compiler vectorizes on the aligned elements (see VectorStorage). The operations
+ * which do not build an expression (the assignments with a vector or a scalar, and dot) are evaluated
+ * on fixed-size Eigen arrays mapped on the elements.
  * @tparam dim Dimension of the vector. Defaults to 1.
  */
 template <unsigned int dim = 1>
-class Vector
+class Vector : public VectorExpression<Vector<dim>, dim>
 {
 public:
-  /// Construct a new Vector object from a scalar.
-  Vector();
+  /// Construct a new Vector object with uninitialized elements.
+  Vector() = default;
   /**
    * @brief Construct a new Vector object.
    * Initializes all the elements with a scalar.
@@ -36,13 +220,10 @@ public:
    * @param v Initializer vector.
    */
   Vector(const std::vector<double>& v);
-  /**
-   * @brief Construct a new Vector object from another vector.
-   * Initializes all the elements with the elements of the initializer.
-   * The dimension of the vector must match with the size of the initializer.
-   * @param v Initializer vector.
-   */
-  Vector(const Vector<dim>& v);
+  /// @brief Copy a Vector object.
+  Vector(const Vector<dim>& v) = default;
+  /// @brief Move a Vector object.
+  Vector(Vector<dim>&& v) = default;
   /**
    * @brief Construct a new Vector object from a vector from Eigen.
    * Initializes all the elements with the elements of the initializer.
@@ -50,11 +231,22 @@ public:
    * @param v Initializer vector.
    */
   Vector(const Eigen::VectorXd& v);
+  /**
+   * @brief Construct a new Vector object by evaluating an expression.
+   * @param e The expression, evaluated in a single loop over the elements.
+   */
+  template <typename E>
+  Vector(const VectorExpression<E, dim>& e);
   /// @brief Destroy the Vector object
-  ~Vector();
+  ~Vector() = default;
 
   /// @brief Assign the elements of the vector to another vector.
-  Vector<dim>& operator=(const Vector<dim>& v);
+  Vector<dim>& operator=(const Vector<dim>& v) = default;
+  /// @brief Move the elements of another vector to the vector.
+  Vector<dim>& operator=(Vector<dim>&& v) = default;
+  /// @brief Assign the elements of the vector to the evaluation of an expression.
+  template <typename E>
+  Vector<dim>& operator=(const VectorExpression<E, dim>& e);
   /// @brief Assign the elements of the vector to a scalar.
   Vector<dim>& operator=(const double& s);
   /// @brief Assign the elements of the vector to a standard vector.
@@ -65,47 +257,27 @@ public:
   /// @brief Access operator for accessing an element as a rvalue reference
   const double& operator[](unsigned int idx) const;
 
-  /// @brief Negation operator
-  Vector<dim> operator-() const;
-
-  /// @brief Gets absoulte values of all the elements of the vector
-  /// @return A vector with absolute values of the original vector
-  Vector<dim> abs() const;
-  /// @brief Gets element-wise exponential of the vector
-  /// @return A vector with exponential values of the original vector
-  Vector<dim> exp() const;
-  /// @brief Gets element-wise logarithm of the vector
-  /// @return A vector with logarithm values of the original vector
-  Vector<dim> log() const;
-
-  /// @brief Operator for summation with another vector
-  Vector<dim> operator+(const Vector<dim>&) const;
-  /// @brief Operator for subtraction by another vector
-  Vector<dim> operator-(const Vector<dim>&) const;
-  /// @brief Operator for multiplication by another vector
-  Vector<dim> operator*(const Vector<dim>&) const;
-  /// @brief Operator for division by another vector
-  Vector<dim> operator/(const Vector<dim>&) const;
-
-  /// @brief Operator for assign-summation with another vector
-  Vector<dim>& operator+=(const Vector<dim>&);
-  /// @brief Operator for assign-subtraction by another vector
-  Vector<dim>& operator-=(const Vector<dim>&);
-  /// @brief Operator for assign-multiplication by another vector
-  Vector<dim>& operator*=(const Vector<dim>&);
-  /// @brief Operator for assign-division by another vector
-  Vector<dim>& operator/=(const Vector<dim>&);
-
-  /// @brief Operator for element-wise summation with a scalar
-  Vector<dim> operator+(const double&);
-  /// @brief Operator for element-wise subtraction by a scalar
-  Vector<dim> operator-(const double&);
-  /// @brief Operator for element-wise multiplication by a scalar
-  Vector<dim> operator*(const double&);
-  /// @brief Operator for element-wise division by a scalar
-  Vector<dim> operator/(const double&);
-  /// @brief Operator for element-wise power by a scalar
-  Vector<dim> operator^(const double&);
+  /// @brief Operator for element-wise assign-summation with another vector
+  Vector<dim>& operator+=(const Vector<dim>& v);
+  /// @brief Operator for element-wise assign-subtraction by another vector
+  Vector<dim>& operator-=(const Vector<dim>& v);
+  /// @brief Operator for element-wise assign-multiplication by another vector
+  Vector<dim>& operator*=(const Vector<dim>& v);
+  /// @brief Operator for element-wise assign-division by another vector
+  Vector<dim>& operator/=(const Vector<dim>& v);
+
+  /// @brief Operator for assign-summation with an expression
+  template <typename E>
+  Vector<dim>& operator+=(const VectorExpression<E, dim>& e);
+  /// @brief Operator for assign-subtraction by an expression
+  template <typename E>
+  Vector<dim>& operator-=(const VectorExpression<E, dim>& e);
+  /// @brief Operator for assign-multiplication by an expression
+  template <typename E>
+  Vector<dim>& operator*=(const VectorExpression<E, dim>& e);
+  /// @brief Operator for assign-division by an expression
+  template <typename E>
+  Vector<dim>& operator/=(const VectorExpression<E, dim>& e);
 
   /// @brief Operator for element-wise assign-summation with a scalar
   Vector<dim>& operator+=(const double&);
@@ -126,10 +298,69 @@ public:
   std::vector<double> to_std_vector() const;
 
 private:
+  /// @brief Fixed-size Eigen array of the elements.
+  typedef Eigen::Array<double, dim, 1> Array;
+  /// @brief Map of the elements as an Eigen array.
+  typedef Eigen::Map<Array, VectorStorage<dim>::map_alignment> ArrayMap;
+  /// @brief Map of the constant elements as an Eigen array.
+  typedef Eigen::Map<const Array, VectorStorage<dim>::map_alignment> ConstArrayMap;
+
+  /// @brief Return the elements as an Eigen array.
+  ArrayMap array();
+  /// @brief Return the constant elements as an Eigen array.
+  ConstArrayMap array() const;
+
+  /// @brief Evaluate an expression into the elements with an assignment operation (e.g., OperationSum for +=).
+  template <typename Op, typename E>
+  void update(const VectorExpression<E, dim>& e);
+
   /// @brief Array for storing the elements of the vector.
-  double m_elements[dim];
+  alignas(VectorStorage<dim>::alignment) double m_elements[dim];
 };
 
+/// @brief Operator for element-wise summation of two expressions
+template <typename L, typename R, unsigned int dim>
+VectorBinary<OperationSum, L, R, dim> operator+(const VectorExpression<L, dim>& l, const VectorExpression<R, dim>& r);
+/// @brief Operator for element-wise subtraction of two expressions
+template <typename L, typename R, unsigned int dim>
+VectorBinary<OperationSub, L, R, dim> operator-(const VectorExpression<L, dim>& l, const VectorExpression<R, dim>& r);
+/// @brief Operator for element-wise multiplication of two expressions
+template <typename L, typename R, unsigned int dim>
+VectorBinary<OperationMul, L, R, dim> operator*(const VectorExpression<L, dim>& l, const VectorExpression<R, dim>& r);
+/// @brief Operator for element-wise division of two expressions
+template <typename L, typename R, unsigned int dim>
+VectorBinary<OperationDiv, L, R, dim> operator/(const VectorExpression<L, dim>& l, const VectorExpression<R, dim>& r);
+
+/// @brief Operator for element-wise summation with a scalar
+template <typename L, unsigned int dim>
+VectorBinary<OperationSum, L, VectorScalar<dim>, dim> operator+(const VectorExpression<L, dim>& l, const double& s);
+/// @brief Operator for element-wise subtraction by a scalar
+template <typename L, unsigned int dim>
+VectorBinary<OperationSub, L, VectorScalar<dim>, dim> operator-(const VectorExpression<L, dim>& l, const double& s);
+/// @brief Operator for element-wise multiplication by a scalar
+template <typename L, unsigned int dim>
+VectorBinary<OperationMul, L, VectorScalar<dim>, dim> operator*(const VectorExpression<L, dim>& l, const double& s);
+/// @brief Operator for element-wise division by a scalar
+template <typename L, unsigned int dim>
+VectorBinary<OperationDiv, L, VectorScalar<dim>, dim> operator/(const VectorExpression<L, dim>& l, const double& s);
+
+/// @brief External summation operator with a scalar
+template <typename R, unsigned int dim>
+VectorBinary<OperationSum, VectorScalar<dim>, R, dim> operator+(const double& s, const VectorExpression<R, dim>& r);
+/// @brief External subtraction operator with a scalar (the scalar minus each element)
+template <typename R, unsigned int dim>
+VectorBinary<OperationSub, VectorScalar<dim>, R, dim> operator-(const double& s, const VectorExpression<R, dim>& r);
+/// @brief External multiplication operator with a scalar
+template <typename R, unsigned int dim>
+VectorBinary<OperationMul, VectorScalar<dim>, R, dim> operator*(const double& s, const VectorExpression<R, dim>& r);
+/// @brief External division operator with a scalar (the scalar divided by each element)
+template <typename R, unsigned int dim>
+VectorBinary<OperationDiv, VectorScalar<dim>, R, dim> operator/(const double& s, const VectorExpression<R, dim>& r);
+
+/// @brief Display operator, which evaluates an expression
+template <typename E, unsigned int dim>
+std::ostream& operator<<(std::ostream& stream, const VectorExpression<E, dim>& v);
+
 #include "vector.tpp"
 
 #endif
@@ -1,18 +1,122 @@
 #include "vector.hpp"
 
-// Constructors and destructor
+// Operations
+
+inline double OperationSum::apply(double a, double b) {
+  return a + b;
+}
+
+inline double OperationSub::apply(double a, double b) {
+  return a - b;
+}
+
+inline double OperationMul::apply(double a, double b) {
+  return a * b;
+}
+
+inline double OperationDiv::apply(double a, double b) {
+  return a / b;
+}
+
+inline double OperationPow::apply(double a, double b) {
+  return std::pow(a, b);
+}
+
+inline double OperationNeg::apply(double a) {
+  return -a;
+}
+
+inline double OperationAbs::apply(double a) {
+  return std::abs(a);
+}
+
+inline double OperationExp::apply(double a) {
+  return std::exp(a);
+}
+
+inline double OperationLog::apply(double a) {
+  return std::log(a);
+}
+
+// Expressions
+
+template <typename Derived, unsigned int dim>
+const Derived& VectorExpression<Derived, dim>::derived() const {
+  return static_cast<const Derived&>(*this);
+}
+
+template <typename Derived, unsigned int dim>
+double VectorExpression<Derived, dim>::operator[](unsigned int idx) const {
+  return derived()[idx];
+}
+
+template <typename Derived, unsigned int dim>
+VectorUnary<OperationNeg, Derived, dim> VectorExpression<Derived, dim>::operator-() const {
+  return VectorUnary<OperationNeg, Derived, dim>(derived());
+}
+
+template <typename Derived, unsigned int dim>
+VectorUnary<OperationAbs, Derived, dim> VectorExpression<Derived, dim>::abs() const {
+  return VectorUnary<OperationAbs, Derived, dim>(derived());
+}
+
+template <typename Derived, unsigned int dim>
+VectorUnary<OperationExp, Derived, dim> VectorExpression<Derived, dim>::exp() const {
+  return VectorUnary<OperationExp, Derived, dim>(derived());
+}
+
+template <typename Derived, unsigned int dim>
+VectorUnary<OperationLog, Derived, dim> VectorExpression<Derived, dim>::log() const {
+  return VectorUnary<OperationLog, Derived, dim>(derived());
+}
+
+template <typename Derived, unsigned int dim>
+VectorBinary<OperationPow, Derived, VectorScalar<dim>, dim> VectorExpression<Derived, dim>::operator^(const double& s) const {
+  return VectorBinary<OperationPow, Derived, VectorScalar<dim>, dim>(derived(), VectorScalar<dim>(s));
+}
+
+template <typename Derived, unsigned int dim>
+template <typename E>
+double VectorExpression<Derived, dim>::dot(const VectorExpression<E, dim>& v) const {
+  double product = 0;
+  for(unsigned int i=0; i<dim; ++i) {
+    product += derived()[i] * v.derived()[i];
+  }
+  return product;
+}
 
 template <unsigned int dim>
-Vector<dim>::Vector() {}
+VectorScalar<dim>::VectorScalar(double s)
+  : m_value(s) {}
 
 template <unsigned int dim>
-Vector<dim>::~Vector() {}
+double VectorScalar<dim>::operator[](unsigned int) const {
+  return m_value;
+}
+
+template <typename Op, typename E, unsigned int dim>
+VectorUnary<Op, E, dim>::VectorUnary(const E& operand)
+  : m_operand(operand) {}
+
+template <typename Op, typename E, unsigned int dim>
+double VectorUnary<Op, E, dim>::operator[](unsigned int idx) const {
+  return Op::apply(m_operand[idx]);
+}
+
+template <typename Op, typename L, typename R, unsigned int dim>
+VectorBinary<Op, L, R, dim>::VectorBinary(const L& left, const R& right)
+  : m_left(left), m_right(right) {}
+
+template <typename Op, typename L, typename R, unsigned int dim>
+double VectorBinary<Op, L, R, dim>::operator[](unsigned int idx) const {
+  return Op::apply(m_left[idx], m_right[idx]);
+}
+
+// Constructors
 
 template <unsigned int dim>
 Vector<dim>::Vector(const double& s) {
-  for(unsigned int i=0; i<dim; ++i) {
-    m_elements[i] = s;
-  }
+  array().setConstant(s);
 }
 
 template <unsigned int dim>
@@ -27,13 +131,6 @@ Vector<dim>::Vector(const std::vector<double>& v) {
   }
 }
 
-template <unsigned int dim>
-Vector<dim>::Vector(const Vector<dim>& v) {
-  for(unsigned int i=0; i<dim; ++i) {
-    m_elements[i] = v[i];
-  }
-}
-
 template <unsigned int dim>
 Vector<dim>::Vector(const Eigen::VectorXd& v) {
   if (v.size() != dim) {
@@ -46,21 +143,31 @@ Vector<dim>::Vector(const Eigen::VectorXd& v) {
   }
 }
 
+template <unsigned int dim>
+template <typename E>
+Vector<dim>::Vector(const VectorExpression<E, dim>& e) {
+  const E& expression = e.derived();
+  for(unsigned int i=0; i<dim; ++i) {
+    m_elements[i] = expression[i];
+  }
+}
+
 // Assignment operators
 
 template <unsigned int dim>
-Vector<dim>& Vector<dim>::operator=(const Vector<dim>& v) {
+template <typename E>
+Vector<dim>& Vector<dim>::operator=(const VectorExpression<E, dim>& e) {
+  // The elements are computed one after the other, which is safe for element-wise expressions of the vector itself
+  const E& expression = e.derived();
   for(unsigned int i=0; i<dim; ++i) {
-    m_elements[i] = v[i];
+    m_elements[i] = expression[i];
   }
   return *this;
 }
 
 template <unsigned int dim>
 Vector<dim>& Vector<dim>::operator=(const double& s) {
-  for(unsigned int i=0; i<dim; ++i) {
-    m_elements[i] = s;
-  }
+  array().setConstant(s);
   return *this;
 }
 
@@ -89,224 +196,107 @@ const double& Vector<dim>::operator[](unsigned int idx) const {
   return m_elements[idx];
 }
 
-// Opposite operator
-
-template <unsigned int dim>
-Vector<dim> Vector<dim>::operator-() const{
-  Vector<dim> u(*this);
-  for (int idx = 0; idx < dim; ++idx){
-    u[idx] *= -1;
-  }
-  return u;
-}
-
-// Absolute function
-
-template <unsigned int dim>
-Vector<dim> Vector<dim>::abs() const{
-  Vector<dim> u(*this);
-  for (int idx = 0; idx < dim; ++idx){
-    u[idx] = std::abs(u[idx]);
-  }
-  return u;
-}
-
-// Exponential function (element-wise)
+// Eigen maps
 
 template <unsigned int dim>
-Vector<dim> Vector<dim>::exp() const{
-  Vector<dim> u(*this);
-  for (int idx = 0; idx < dim; ++idx){
-    u[idx] = std::exp(u[idx]);
-  }
-  return u;
+typename Vector<dim>::ArrayMap Vector<dim>::array() {
+  return ArrayMap(m_elements);
 }
 
-// Logarithm function (element-wise)
-
 template <unsigned int dim>
-Vector<dim> Vector<dim>::log() const{
-  Vector<dim> u(*this);
-  bool warn = false;
-  for (int idx = 0; idx < dim; ++idx){
-    if (u[idx] <= 0) {
-      warn = true;
-    }
-    u[idx] = std::log(u[idx]);
-  }
-  if (warn) {
-    std::cout << "Warning: Logarithm of a non-positive value does not exist (v = [" << *this << "])" << std::endl;
-  }
-  return u;
+typename Vector<dim>::ConstArrayMap Vector<dim>::array() const {
+  return ConstArrayMap(m_elements);
 }
 
-// Arithmetic vector operators
-
-template <unsigned int dim>
-Vector<dim> Vector<dim>::operator+(const Vector<dim>& v) const{
-  Vector<dim> u(*this);
-  for (int idx = 0; idx < dim; ++idx){
-    u[idx] += v[idx];
-  }
-  return u;
-}
-
-template <unsigned int dim>
-Vector<dim> Vector<dim>::operator-(const Vector<dim>& v) const{
-  Vector<dim> u(*this);
-  for (int idx = 0; idx < dim; ++idx){
-    u[idx] -= v[idx];
-  }
-  return u;
-}
+// Arithmetic reassignment operators
 
 template <unsigned int dim>
-Vector<dim> Vector<dim>::operator*(const Vector<dim>& v) const{
-  Vector<dim> u(*this);
-  for (int idx = 0; idx < dim; ++idx){
-    u[idx] *= v[idx];
+template <typename Op, typename E>
+void Vector<dim>::update(const VectorExpression<E, dim>& e) {
+  const E& expression = e.derived();
+  for(unsigned int i=0; i<dim; ++i) {
+    m_elements[i] = Op::apply(m_elements[i], expression[i]);
   }
-  return u;
 }
 
-template <unsigned int dim>
-Vector<dim> Vector<dim>::operator/(const Vector<dim>& v) const{
-  Vector<dim> u(*this);
-  for (int idx = 0; idx < dim; ++idx){
-    u[idx] /= v[idx];
-  }
-  return u;
-}
-
-// Arithmetic reassignment operators
-
 template <unsigned int dim>
 Vector<dim>& Vector<dim>::operator+=(const Vector<dim>& v) {
-  for(unsigned int i=0; i<dim; ++i) {
-    m_elements[i] += v[i];
-  }
+  array() += v.array();
   return *this;
 }
 
 template <unsigned int dim>
 Vector<dim>& Vector<dim>::operator-=(const Vector<dim>& v) {
-  for(unsigned int i=0; i<dim; ++i) {
-    m_elements[i] -= v[i];
-  }
+  array() -= v.array();
   return *this;
 }
 
 template <unsigned int dim>
 Vector<dim>& Vector<dim>::operator*=(const Vector<dim>& v) {
-  for(unsigned int i=0; i<dim; ++i) {
-    m_elements[i] *= v[i];
-  }
+  array() *= v.array();
   return *this;
 }
 
 template <unsigned int dim>
 Vector<dim>& Vector<dim>::operator/=(const Vector<dim>& v) {
-  for(unsigned int i=0; i<dim; ++i) {
-    m_elements[i] /= v[i];
-  }
+  array() /= v.array();
   return *this;
 }
 
-// Arithmetic scalar operators
-
 template <unsigned int dim>
-Vector<dim> Vector<dim>::operator+(const double& s) {
-  Vector<dim> u(*this);
-  for (int idx = 0; idx < dim; ++idx){
-    u[idx] += s;
-  }
-  return u;
-}
-
-template <unsigned int dim>
-Vector<dim> Vector<dim>::operator-(const double& s) {
-  Vector<dim> u(*this);
-  for (int idx = 0; idx < dim; ++idx){
-    u[idx] -= s;
-  }
-  return u;
+template <typename E>
+Vector<dim>& Vector<dim>::operator+=(const VectorExpression<E, dim>& e) {
+  update<OperationSum>(e);
+  return *this;
 }
 
 template <unsigned int dim>
-Vector<dim> Vector<dim>::operator*(const double& s) {
-  Vector<dim> u(*this);
-  for (int idx = 0; idx < dim; ++idx){
-    u[idx] *= s;
-  }
-  return u;
+template <typename E>
+Vector<dim>& Vector<dim>::operator-=(const VectorExpression<E, dim>& e) {
+  update<OperationSub>(e);
+  return *this;
 }
 
 template <unsigned int dim>
-Vector<dim> Vector<dim>::operator/(const double& s) {
-  Vector<dim> u(*this);
-  for (int idx = 0; idx < dim; ++idx){
-    u[idx] /= s;
-  }
-  return u;
+template <typename E>
+Vector<dim>& Vector<dim>::operator*=(const VectorExpression<E, dim>& e) {
+  update<OperationMul>(e);
+  return *this;
 }
 
 template <unsigned int dim>
-Vector<dim> Vector<dim>::operator^(const double& s) {
-  Vector<dim> u(*this);
-  for(unsigned int i=0; i<dim; ++i) {
-    u[i] = pow(u[i], s);
-  }
-  return u;
+template <typename E>
+Vector<dim>& Vector<dim>::operator/=(const VectorExpression<E, dim>& e) {
+  update<OperationDiv>(e);
+  return *this;
 }
 
 // Arithmetic reassignment operators with scalars
 
 template <unsigned int dim>
 Vector<dim>& Vector<dim>::operator+=(const double& s) {
-  for(unsigned int i=0; i<dim; ++i) {
-    m_elements[i] += s;
-  }
+  array() += s;
   return *this;
 }
 
 template <unsigned int dim>
 Vector<dim>& Vector<dim>::operator-=(const double& s) {
-  for(unsigned int i=0; i<dim; ++i) {
-    m_elements[i] -= s;
-  }
+  array() -= s;
   return *this;
 }
 
 template <unsigned int dim>
 Vector<dim>& Vector<dim>::operator*=(const double& s) {
-  for(unsigned int i=0; i<dim; ++i) {
-    m_elements[i] *= s;
-  }
+  array() *= s;
   return *this;
 }
 
 template <unsigned int dim>
 Vector<dim>& Vector<dim>::operator/=(const double& s) {
-  for(unsigned int i=0; i<dim; ++i) {
-    m_elements[i] /= s;
-  }
+  array() /= s;
   return *this;
 }
 
-// Display operator
-
-template<unsigned int dim>
-std::ostream& operator<<(std::ostream& stream, const Vector<dim>& v) {
-    for (int idx = 0; idx < dim; ++idx){
-        stream << v[idx];
-        if (idx < dim - 1){
-            stream << ", ";
-        }
-   }
-
-   return stream;
-}
-
 // Conversion methods
 
 template <unsigned int dim>
@@ -326,51 +316,86 @@ std::vector<double> Vector<dim>::to_std_vector() const {
 
 template <unsigned int dim>
 double Vector<dim>::dot(const Vector<dim>& v) const {
-  double product = 0;
-  for(unsigned int i=0; i<dim; ++i) {
-    product += v[i] * m_elements[i];
-  }
-  return product;
+  return (array() * v.array()).sum();
+}
+
+// Arithmetic operators of expressions
+
+template <typename L, typename R, unsigned int dim>
+VectorBinary<OperationSum, L, R, dim> operator+(const VectorExpression<L, dim>& l, const VectorExpression<R, dim>& r) {
+  return VectorBinary<OperationSum, L, R, dim>(l.derived(), r.derived());
+}
+
+template <typename L, typename R, unsigned int dim>
+VectorBinary<OperationSub, L, R, dim> operator-(const VectorExpression<L, dim>& l, const VectorExpression<R, dim>& r) {
+  return VectorBinary<OperationSub, L, R, dim>(l.derived(), r.derived());
+}
+
+template <typename L, typename R, unsigned int dim>
+VectorBinary<OperationMul, L, R, dim> operator*(const VectorExpression<L, dim>& l, const VectorExpression<R, dim>& r) {
+  return VectorBinary<OperationMul, L, R, dim>(l.derived(), r.derived());
+}
+
+template <typename L, typename R, unsigned int dim>
+VectorBinary<OperationDiv, L, R, dim> operator/(const VectorExpression<L, dim>& l, const VectorExpression<R, dim>& r) {
+  return VectorBinary<OperationDiv, L, R, dim>(l.derived(), r.derived());
+}
+
+// Arithmetic scalar operators
+
+template <typename L, unsigned int dim>
+VectorBinary<OperationSum, L, VectorScalar<dim>, dim> operator+(const VectorExpression<L, dim>& l, const double& s) {
+  return VectorBinary<OperationSum, L, VectorScalar<dim>, dim>(l.derived(), VectorScalar<dim>(s));
+}
+
+template <typename L, unsigned int dim>
+VectorBinary<OperationSub, L, VectorScalar<dim>, dim> operator-(const VectorExpression<L, dim>& l, const double& s) {
+  return VectorBinary<OperationSub, L, VectorScalar<dim>, dim>(l.derived(), VectorScalar<dim>(s));
+}
+
+template <typename L, unsigned int dim>
+VectorBinary<OperationMul, L, VectorScalar<dim>, dim> operator*(const VectorExpression<L, dim>& l, const double& s) {
+  return VectorBinary<OperationMul, L, VectorScalar<dim>, dim>(l.derived(), VectorScalar<dim>(s));
+}
+
+template <typename L, unsigned int dim>
+VectorBinary<OperationDiv, L, VectorScalar<dim>, dim> operator/(const VectorExpression<L, dim>& l, const double& s) {
+  return VectorBinary<OperationDiv, L, VectorScalar<dim>, dim>(l.derived(), VectorScalar<dim>(s));
 }
 
 // External arithmetic scalar operators
 
-/// @brief External summation operator with a scalar
-template <unsigned int dim>
-Vector<dim> operator+(const double& s, const Vector<dim>& u) {
-  Vector<dim> v(u);
-  for(unsigned int i=0; i<dim; ++i) {
-    v[i] += s;
-  }
-  return v;
+template <typename R, unsigned int dim>
+VectorBinary<OperationSum, VectorScalar<dim>, R, dim> operator+(const double& s, const VectorExpression<R, dim>& r) {
+  return VectorBinary<OperationSum, VectorScalar<dim>, R, dim>(VectorScalar<dim>(s), r.derived());
 }
 
-/// @brief External subtraction operator with a scalar
-template <unsigned int dim>
-Vector<dim> operator-(const double& s, const Vector<dim>& u) {
-  Vector<dim> v(u);
-  for(unsigned int i=0; i<dim; ++i) {
-    v[i] -= s;
-  }
-  return v;
+template <typename R, unsigned int dim>
+VectorBinary<OperationSub, VectorScalar<dim>, R, dim> operator-(const double& s, const VectorExpression<R, dim>& r) {
+  return VectorBinary<OperationSub, VectorScalar<dim>, R, dim>(VectorScalar<dim>(s), r.derived());
 }
 
-/// @brief External multiplication operator with a scalar
-template <unsigned int dim>
-Vector<dim> operator*(const double& s, const Vector<dim>& u) {
-  Vector<dim> v(u);
-  for(unsigned int i=0; i<dim; ++i) {
-    v[i] *= s;
-  }
-  return v;
+template <typename R, unsigned int dim>
+VectorBinary<OperationMul, VectorScalar<dim>, R, dim> operator*(const double& s, const VectorExpression<R, dim>& r) {
+  return VectorBinary<OperationMul, VectorScalar<dim>, R, dim>(VectorScalar<dim>(s), r.derived());
 }
 
-/// @brief External division operator with a scalar
-template <unsigned int dim>
-Vector<dim> operator/(const double& s, const Vector<dim>& u) {
-  Vector<dim> v(u);
-  for(unsigned int i=0; i<dim; ++i) {
-    v[i] /= s;
-  }
-  return v;
+template <typename R, unsigned int dim>
+VectorBinary<OperationDiv, VectorScalar<dim>, R, dim> operator/(const double& s, const VectorExpression<R, dim>& r) {
+  return VectorBinary<OperationDiv, VectorScalar<dim>, R, dim>(VectorScalar<dim>(s), r.derived());
+}
+
+// Display operator
+
+template <typename E, unsigned int dim>
+std::ostream& operator<<(std::ostream& stream, const VectorExpression<E, dim>& v) {
+    const E& expression = v.derived();
+    for (unsigned int idx = 0; idx < dim; ++idx){
+        stream << expression[idx];
+        if (idx < dim - 1){
+            stream << ", ";
+        }
+   }
+
+   return stream;
 }
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <cmath>
+#include "accumulator.hpp"
+#include "mca.hpp"
+#include "distributions.hpp"
+
+
+namespace{
+
+class AccumulatorTest : public ::testing::Test {
+protected:
+  std::shared_ptr<std::vector<Vector<2>>> samples;
+
+  virtual void SetUp() override {
+    // Samples with a large offset to check the numerical stability
+    Normal<2> dist(1.e6, 4.);
+    samples = dist.samples(10000);
+  };
+
+  /// @brief Compute a moment with two passes over the samples in extended precision.
+  double reference(int d, unsigned int k, const std::string& mode) {
+    long double n = samples->size();
+    long double mean = 0.;
+    for (auto& x : *samples) mean += x[d] / n;
+    long double var = 0., central = 0., raw = 0.;
+    for (auto& x : *samples) {
+      var += std::pow(x[d] - mean, 2) / n;
+      central += std::pow(x[d] - mean, k) / n;
+      raw += std::pow((long double)x[d], k) / n;
+    }
+    if (mode == "raw") return raw;
+    if (mode == "central") return central;
+    return central / std::pow(var, k / 2.);
+  };
+};
+
+TEST_F(AccumulatorTest, AccumulatorMoments) {
+  // Check all the moments against the two-pass computation
+  MomentAccumulator<2> acc(6);
+  acc.add(*samples);
+  EXPECT_EQ(acc.count(), samples->size());
+  for (int d = 0; d < 2; ++d) {
+    for (unsigned int k = 1; k <= 6; ++k) {
+      for (std::string mode : {"raw", "central", "standardized"}) {
+        double ref = reference(d, k, mode);
+        EXPECT_NEAR(acc.moment(d, k, mode), ref, 1.e-8 * std::max(1., std::abs(ref))) << mode << " " << k;
+      }
+    }
+  }
+}
+
+TEST_F(AccumulatorTest, AccumulatorLayouts) {
+  // Check that the buffers give the same moments as the vectors
+  MomentAccumulator<2> acc1(4), acc2(4);
+  acc1.add(*samples);
+  acc2.add(&(*samples)[0][0], samples->size(), Layout::AoS);
+  EXPECT_EQ(acc1.moment(4, "central"), acc2.moment(4, "central"));
+  EXPECT_THROW(acc1.moment(0, 5, "raw"), InvalidInputException);
+  EXPECT_THROW(acc1.moment(0, 2, "other"), InvalidInputException);
+}
+
+TEST_F(AccumulatorTest, AccumulatorMerge) {
+  // Split the samples in three shards of different sizes
+  std::vector<Vector<2>> s1(samples->begin(), samples->begin() + 17);
+  std::vector<Vector<2>> s2(samples->begin() + 17, samples->begin() + 6000);
+  std::vector<Vector<2>> s3(samples->begin() + 6000, samples->end());
+  MomentAccumulator<2> all(6), a1(6), a2(6), a3(6);
+  all.add(*samples);
+  a1.add(s1);
+  a2.add(s2);
+  a3.add(s3);
+
+  // Check that the merge is associative and equivalent to a single pass
+  MomentAccumulator<2> left = a1, right = a2;
+  left += a2;
+  left += a3;
+  right += a3;
+  a1 += right;
+  EXPECT_EQ(left.count(), all.count());
+  for (int d = 0; d < 2; ++d) {
+    for (unsigned int k = 1; k <= 6; ++k) {
+      for (std::string mode : {"raw", "central", "standardized"}) {
+        double ref = all.moment(d, k, mode);
+        EXPECT_NEAR(left.moment(d, k, mode), ref, 1.e-8 * std::max(1., std::abs(ref)));
+        EXPECT_NEAR(a1.moment(d, k, mode), ref, 1.e-8 * std::max(1., std::abs(ref)));
+      }
+    }
+  }
+
+  // Check that a lower order cannot be merged
+  MomentAccumulator<2> low(2);
+  EXPECT_THROW(all.merge(low), InvalidInputException);
+  low.merge(all);
+  EXPECT_NEAR(low.var()[0], all.var()[0], 1.e-12);
+}
+
+TEST_F(AccumulatorTest, AccumulatorWeights) {
+  // Integer weights are equivalent to repeated samples
+  const std::size_t n = 1000;
+  std::vector<double> x(2 * n), w(n);
+  std::vector<Vector<2>> repeated;
+  for (std::size_t i = 0; i < n; ++i) {
+    w[i] = (double)(i % 4);
+    for (int d = 0; d < 2; ++d) {
+      x[d * n + i] = (*samples)[i][d];
+    }
+    for (std::size_t j = 0; j < i % 4; ++j) {
+      repeated.push_back((*samples)[i]);
+    }
+  }
+  MomentAccumulator<2> weighted(6), ref(6);
+  weighted.add(x.data(), w.data(), n, n);
+  ref.add(repeated);
+  EXPECT_EQ(weighted.count(), n);
+  EXPECT_EQ(weighted.weight(), (double)repeated.size());
+  for (int d = 0; d < 2; ++d) {
+    for (unsigned int k = 1; k <= 6; ++k) {
+      double expected = ref.moment(d, k, "central");
+      EXPECT_NEAR(weighted.moment(d, k, "central"), expected, 1.e-6 * std::max(1., std::abs(expected))) << k;
+    }
+  }
+
+  // The effective number of samples is (sum w)^2 / sum w^2, and the count without weights
+  EXPECT_NEAR(weighted.ess(), 1500. * 1500. / 3500., 1.e-9);
+  EXPECT_EQ(ref.ess(), (double)repeated.size());
+
+  // Samples without weight are only counted
+  std::vector<double> zeros(n, 0.);
+  MomentAccumulator<2> merged = weighted;
+  merged.add(x.data(), zeros.data(), n, n);
+  EXPECT_EQ(merged.count(), 2 * n);
+  EXPECT_EQ(merged.moment(4, "central"), weighted.moment(4, "central"));
+}
+
+TEST_F(AccumulatorTest, AccumulatorApproximator) {
+  // Check that an approximator can be built from merged accumulators
+  MomentAccumulator<2> acc(6);
+  acc.add(*samples);
+  MonteCarloApproximator<2> from_acc(acc);
+  MonteCarloApproximator<2> from_samples(samples);
+  EXPECT_TRUE(from_acc.kurtosis().isApprox(from_samples.kurtosis()));
+  EXPECT_FALSE(from_acc.has_data());
+  EXPECT_THROW(from_acc.moment(7, "raw"), InvalidInputException);
+}
+
+}
@@ -0,0 +1,95 @@
+#include "analytic.hpp"
+#include "functions.hpp"
+#include "distributions.hpp"
+#include "mca.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <cmath>
+
+
+namespace {
+
+TEST(AnalyticTest, AnalyticPolynomial) {
+  // p(u) = sum_d (c0_d + c1_d u_d + c2_d u_d^2) with c1 = (0, 0, 1.2) and c2 = (1, 3.4, 2.5)
+  Polynomial<3, 1> f(std::string(PROJECT_SOURCE_DIR) + "/tests/data/poly.dat");
+  Normal<3> normal(0., 1.);
+  MomentAccumulator<1> exact;
+  ASSERT_TRUE(analytic_moments(f, normal, 6, exact));
+  EXPECT_EQ(exact.order(), 6u);
+  EXPECT_NEAR(exact.mean()[0], 6.2 + 6.9, 1.e-12);
+  EXPECT_NEAR(exact.var()[0], 1.2 * 1.2 + 2. * (1. + 3.4 * 3.4 + 2.5 * 2.5), 1.e-12);
+
+  // Compare all the moments with the Monte Carlo approximations
+  Uniform<3> uniform(-1., 2.);
+  for (Distribution<3>* dist : std::vector<Distribution<3>*>{&normal, &uniform}) {
+    ASSERT_TRUE(analytic_moments(f, *dist, 6, exact));
+    MomentAccumulator<1> approx = f.accumulate(4000000, *dist, MCA_CHUNK_SIZE, 6, 4);
+    EXPECT_NEAR(approx.mean()[0], exact.mean()[0], 5. * std::sqrt(exact.var()[0] / approx.count()));
+    for (unsigned int k = 2; k <= 4; ++k) {
+      double value = exact.moment(0, k, "standardized");
+      EXPECT_NEAR(approx.moment(0, k, "standardized"), value, 0.02 * std::max(1., std::abs(value))) << k;
+    }
+  }
+
+  // Check the uniform moments exactly on [0, 1]: E[u] = 1/2 and E[u^2] = 1/3
+  Uniform<3> unit(0., 1.);
+  ASSERT_TRUE(analytic_moments(f, unit, 2, exact));
+  EXPECT_NEAR(exact.mean()[0], 6.2 + 1.2 / 2. + 6.9 / 3., 1.e-12);
+}
+
+TEST(AnalyticTest, AnalyticLinear) {
+  // L(u) = b + A u is normal with mean b + A mu and variance sigma^2 sum_d A_jd^2
+  Linear<3, 4> f(std::string(PROJECT_SOURCE_DIR) + "/tests/data/linear.dat");
+  Normal<3> dist(1., 2.);
+  MomentAccumulator<4> exact;
+  ASSERT_TRUE(analytic_moments(f, dist, 6, exact));
+  std::vector<std::vector<double>> A = {{3., 2., 1.2}, {0., 0., 1.2}, {1., 3.4, 2.5}, {1., 3.4, 2.5}};
+  std::vector<double> b = {3., 0., 1., 0.};
+  for (unsigned int j = 0; j < 4; ++j) {
+    double mean = b[j] + A[j][0] + A[j][1] + A[j][2];
+    double var = 2. * (A[j][0] * A[j][0] + A[j][1] * A[j][1] + A[j][2] * A[j][2]);
+    EXPECT_NEAR(exact.mean()[j], mean, 1.e-12);
+    EXPECT_NEAR(exact.var()[j], var, 1.e-12);
+    EXPECT_NEAR(exact.moment(j, 3, "standardized"), 0., 1.e-12);
+    EXPECT_NEAR(exact.moment(j, 4, "standardized"), 3., 1.e-12);
+    EXPECT_NEAR(exact.moment(j, 6, "standardized"), 15., 1.e-10);
+  }
+
+  // The approximator of the exact moments
+  MonteCarloApproximator<4> mca(exact);
+  EXPECT_NEAR(mca.kurtosis()[2], 3., 1.e-12);
+
+  // The sum of functions doubles the polynomial: 4 times the variance
+  Polynomial<3, 1> p(std::string(PROJECT_SOURCE_DIR) + "/tests/data/poly.dat");
+  CombinedFunctionSum<3, 1> sum(p, p);
+  CombinedFunctionSub<3, 1> zero(p, p);
+  MomentAccumulator<1> single, twice, none;
+  ASSERT_TRUE(analytic_moments(p, dist, 4, single));
+  ASSERT_TRUE(analytic_moments(sum, dist, 4, twice));
+  ASSERT_TRUE(analytic_moments(zero, dist, 4, none));
+  EXPECT_NEAR(twice.mean()[0], 2. * single.mean()[0], 1.e-12);
+  EXPECT_NEAR(twice.var()[0], 4. * single.var()[0], 1.e-10);
+  EXPECT_EQ(none.var()[0], 0.);
+}
+
+TEST(AnalyticTest, AnalyticUnsupported) {
+  // Other functions and correlated inputs are approximated
+  Polynomial<3, 1> p(std::string(PROJECT_SOURCE_DIR) + "/tests/data/poly.dat");
+  SumExponential<3, 1> e(std::string(PROJECT_SOURCE_DIR) + "/tests/data/sumexp.dat");
+  CombinedFunctionMul<3, 1> product(p, p);
+  CombinedFunctionSum<3, 1> sum(p, e);
+  Normal<3> dist(0., 1.);
+  MomentAccumulator<1> exact;
+  EXPECT_FALSE(analytic_moments(e, dist, 4, exact));
+  EXPECT_FALSE(analytic_moments(product, dist, 4, exact));
+  EXPECT_FALSE(analytic_moments(sum, dist, 4, exact));
+
+  std::vector<double> mean = {0., 0., 0.};
+  std::vector<std::vector<double>> covariance = {{1., 0.5, 0.}, {0.5, 1., 0.}, {0., 0., 1.}};
+  Normal<3> correlated(mean, covariance);
+  EXPECT_FALSE(analytic_moments(p, correlated, 4, exact));
+}
+
+} // namespace
@@ -0,0 +1,83 @@
+#include "control.hpp"
+#include "analytic.hpp"
+#include "functions.hpp"
+#include "distributions.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <cmath>
+
+
+namespace {
+
+TEST(ControlTest, ControlVariatesLinear) {
+  // The inputs explain all the fluctuations of a linear function, so the mean is exact
+  Linear<3, 4> f(std::string(PROJECT_SOURCE_DIR) + "/tests/data/linear.dat");
+  Normal<3> dist(1., 2.);
+  ControlVariateAccumulator<3, 4> acc = f.control(5000, dist, 1, 700, 4, 3);
+  MomentAccumulator<4> plain = f.accumulate(5000, dist, 700, 4, 3);
+  Vector<4> exact = f(dist.mean());
+  EXPECT_EQ(acc.count(), 5000);
+  for (unsigned int d = 0; d < 4; ++d) {
+    EXPECT_NEAR(acc.mean()[d], exact[d], 1.e-10 * std::max(1., std::abs(exact[d])));
+    EXPECT_NEAR(acc.plain_mean()[d], plain.mean()[d], 1.e-10 * std::max(1., std::abs(exact[d])));
+    EXPECT_GT(acc.reduction()[d], 1.e8);
+  }
+
+  // The adjusted central moments are close to the ones of the samples
+  MomentAccumulator<4> moments = acc.moments();
+  EXPECT_TRUE(moments.mean().isApprox(acc.mean(), 1.e-12));
+  EXPECT_TRUE(moments.var().isApprox(plain.var(), 5.e-2));
+
+  // The moments do not depend on the number of threads
+  ControlVariateAccumulator<3, 4> one = f.control(5000, dist, 1, 700, 4, 1);
+  EXPECT_TRUE(one.moments().moment(4, "central").isApprox(moments.moment(4, "central"), 1.e-10));
+  EXPECT_THROW(f.control(5000, dist, 0), InvalidInputException);
+  EXPECT_THROW(one += f.control(100, dist, 2, 700, 4), InvalidInputException);
+}
+
+TEST(ControlTest, ControlVariatesPolynomial) {
+  // The squares of the inputs are needed to explain a quadratic polynomial
+  Polynomial<3, 1> f(std::string(PROJECT_SOURCE_DIR) + "/tests/data/poly.dat");
+  Uniform<3> dist(-1., 2.);
+  MomentAccumulator<1> exact;
+  ASSERT_TRUE(analytic_moments(f, dist, 4, exact));
+  ControlVariateAccumulator<3, 1> linear = f.control(20000, dist, 1, 4096, 4, 2);
+  ControlVariateAccumulator<3, 1> quadratic = f.control(20000, dist, 2, 4096, 4, 2);
+  EXPECT_GT(linear.reduction()[0], 1.);
+  EXPECT_GT(quadratic.reduction()[0], 1.e8);
+  EXPECT_NEAR(quadratic.mean()[0], exact.mean()[0], 1.e-10 * std::abs(exact.mean()[0]));
+
+  // The controls also reduce the error of the variance
+  EXPECT_GT(quadratic.reduction(2)[0], 1.);
+  EXPECT_NEAR(quadratic.moments().var()[0], exact.var()[0], 2.e-2 * exact.var()[0]);
+}
+
+TEST(ControlTest, ControlVariatesDegenerate) {
+  // The ratio is one everywhere but at the mean, where some outputs are 0 / 0, so the shift falls back to zero
+  Linear<3, 4> g(std::string(PROJECT_SOURCE_DIR) + "/tests/data/linear.dat");
+  CombinedFunctionDiv<3, 4> f(g, g);
+  Normal<3> dist(0., 1.);
+  ControlVariateAccumulator<3, 4> acc = f.control(1000, dist, 1, 256, 4, 2);
+  for (unsigned int d = 0; d < 4; ++d) {
+    EXPECT_NEAR(acc.mean()[d], 1., 1.e-12);
+    EXPECT_NEAR(acc.moments().var()[d], 0., 1.e-12);
+  }
+
+  // Without samples, no moments are reported
+  ControlVariateAccumulator<3, 4> none = f.control(0, dist, 1, 256, 4, 2);
+  EXPECT_EQ(none.count(), 0u);
+  EXPECT_EQ(none.moments().count(), 0u);
+
+  // The output at the mean is not a sample, so it is not counted as a domain error
+  SumLogarithm<3, 1> log(std::string(PROJECT_SOURCE_DIR) + "/tests/data/sumlog.dat");
+  CombinedFunctionSum<3, 1> sum(log, log);
+  Uniform<3> centered(-1., 1.);
+  log.control(0, centered, 1, 256, 4, 2);
+  EXPECT_EQ(log.domain_errors(), 0u);
+  sum.control(0, centered, 1, 256, 4, 2);
+  EXPECT_EQ(sum.domain_errors(), 0u);
+}
+
+} // namespace
@@ -38,11 +38,11 @@ protected:
   virtual void SetUp() override {
     mean = new std::vector<double>({0., 1., 2., 3., 4.});
     covariance = new std::vector<std::vector<double>>({
-      {1., 2., 3., 4., 5.},
-      {2., 1., 2., 3., 4.},
-      {3., 2., 1., 2., 3.},
-      {4., 3., 2., 1., 2.},
-      {5., 4., 3., 2., 1.},
+      {1., .5, .25, .125, .0625},
+      {.5, 1., .5, .25, .125},
+      {.25, .5, 1., .5, .25},
+      {.125, .25, .5, 1., .5},
+      {.0625, .125, .25, .5, 1.},
     });
     dist = new Normal<5>(*mean, *covariance);
   };
@@ -85,6 +85,108 @@ TEST_F(UniformTest, UniformVariance) {
   }
 }
 
+TEST_F(UniformTest, UniformLayouts) {
+  // Check that both layouts contain the same samples
+  int n = 1000;
+  std::vector<double> aos(n * 5), soa(n * 5);
+  dist->seed(RAND_SEED);
+  dist->samples(aos.data(), n, Layout::AoS);
+  dist->seed(RAND_SEED);
+  dist->samples(soa.data(), n, Layout::SoA);
+  for (int i = 0; i < n; ++i) {
+    for (int d = 0; d < 5; ++d) {
+      EXPECT_EQ(aos[i * 5 + d], soa[d * n + i]);
+    }
+  }
+  // Check that the vector of samples has the same layout
+  dist->seed(RAND_SEED);
+  auto samples = dist->samples(n);
+  EXPECT_EQ((*samples)[n - 1][4], aos[n * 5 - 1]);
+}
+
+TEST_F(UniformTest, UniformLogDensity) {
+  // The density is constant inside of the bounds and zero outside
+  const std::size_t n = 3;
+  std::vector<double> x(5 * n), out(n);
+  for (int d = 0; d < 5; ++d) {
+    x[d * n] = ((*lower)[d] + (*upper)[d]) / 2.;
+    x[d * n + 1] = (*lower)[d];
+    x[d * n + 2] = (d == 3) ? (*upper)[d] + 1. : (*upper)[d];
+  }
+  dist->log_density(x.data(), n, out.data(), n);
+  EXPECT_NEAR(out[0], -std::log(1. * 2. * 3. * 4. * 5.), 1.e-14);
+  EXPECT_EQ(out[1], out[0]);
+  EXPECT_EQ(out[2], -INFINITY);
+}
+
+TEST_F(NormalTest, NormalSamples) {
+  // Check the empirical mean and variance of the samples
+  int n = 100000;
+  std::vector<double> x(n * 5);
+  dist->samples(x.data(), n, Layout::SoA);
+  for (int d = 0; d < 5; ++d) {
+    double mean = 0., var = 0.;
+    for (int i = 0; i < n; ++i) {
+      mean += x[d * n + i] / n;
+    }
+    for (int i = 0; i < n; ++i) {
+      var += (x[d * n + i] - mean) * (x[d * n + i] - mean) / n;
+    }
+    EXPECT_NEAR(mean, (*this->mean)[d], 0.02);
+    EXPECT_NEAR(var, 1., 0.02);
+  }
+}
+
+TEST_F(NormalTest, NormalCovariance) {
+  // Check the empirical covariance of the samples
+  int n = 100000;
+  std::vector<double> x(n * 5);
+  dist->samples(x.data(), n, Layout::SoA);
+  for (int d1 = 0; d1 < 5; ++d1) {
+    for (int d2 = 0; d2 < 5; ++d2) {
+      double cov = 0.;
+      for (int i = 0; i < n; ++i) {
+        cov += (x[d1 * n + i] - (*mean)[d1]) * (x[d2 * n + i] - (*mean)[d2]) / n;
+      }
+      EXPECT_NEAR(cov, (*covariance)[d1][d2], 0.02);
+    }
+  }
+}
+
+TEST_F(NormalTest, NormalLogDensity) {
+  // Compare with the quadratic form of the inverse covariance matrix
+  const std::size_t n = 300;
+  std::vector<double> x(5 * n), out(n);
+  dist->samples(x.data(), n, Layout::SoA);
+  dist->log_density(x.data(), n, out.data(), n);
+  Eigen::Matrix<double, 5, 5> sigma;
+  for (int d1 = 0; d1 < 5; ++d1) {
+    for (int d2 = 0; d2 < 5; ++d2) {
+      sigma(d1, d2) = (*covariance)[d1][d2];
+    }
+  }
+  Eigen::LLT<Eigen::Matrix<double, 5, 5>> llt(sigma);
+  double log_det = 0.;
+  for (int d = 0; d < 5; ++d) {
+    log_det += 2. * std::log(llt.matrixL()(d, d));
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    Eigen::Matrix<double, 5, 1> v;
+    for (int d = 0; d < 5; ++d) {
+      v[d] = x[d * n + i] - (*mean)[d];
+    }
+    double ref = -0.5 * v.dot(llt.solve(v)) - 0.5 * log_det - 2.5 * std::log(2. * M_PI);
+    EXPECT_NEAR(out[i], ref, 1.e-12 * std::max(1., std::abs(ref)));
+  }
+}
+
+TEST(NormalInvalidTest, NormalNotPositiveDefinite) {
+  // Check that a covariance matrix which is not positive definite is rejected
+  std::vector<double> mean({0., 0.});
+  std::vector<std::vector<double>> covariance({{1., 2.}, {2., 1.}});
+  EXPECT_THROW(Normal<2>(mean, covariance), InvalidArgumentException);
+}
+
 TEST_F(NormalTest, NormalVariance) {
   // Check that the variance is computed correctly
   std::vector<double> true_var({1., 1., 1., 1., 1.});
@@ -0,0 +1,95 @@
+#include "expressions.hpp"
+#include "functions.hpp"
+#include "distributions.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <string>
+
+
+namespace {
+
+#define dim 3
+
+class ExpressionTest : public ::testing::Test
+{
+protected:
+  std::shared_ptr<Polynomial<dim, 1>> f1;
+  std::shared_ptr<SumExponential<dim, 1>> f2;
+  std::shared_ptr<SumLogarithm<dim, 1>> f3;
+
+  virtual void SetUp() override {
+    f1 = std::make_shared<Polynomial<dim, 1>>(std::string(PROJECT_SOURCE_DIR) + "/tests/data/poly.dat");
+    f2 = std::make_shared<SumExponential<dim, 1>>(std::string(PROJECT_SOURCE_DIR) + "/tests/data/sumexp.dat");
+    f3 = std::make_shared<SumLogarithm<dim, 1>>(std::string(PROJECT_SOURCE_DIR) + "/tests/data/sumlog.dat");
+  };
+};
+
+TEST_F(ExpressionTest, ExpressionEval) {
+  // Check the expressions against the combined functions
+  Vector<dim> x = 1.;
+  auto e = (expr(f1) + expr(f2)) * expr(f3);
+  auto sum = (*f1) + (*f2);
+  auto prod = sum * (*f3);
+  EXPECT_DOUBLE_EQ(e(x)[0], prod(x)[0]);
+
+  // Check the constants and the order of the operands
+  double y1 = (*f1)(x)[0], y2 = (*f2)(x)[0], y3 = (*f3)(x)[0];
+  EXPECT_DOUBLE_EQ((2. * expr(f1) - 1.)(x)[0], 2. * y1 - 1.);
+  EXPECT_DOUBLE_EQ((1. - expr(f1) / expr(f3))(x)[0], 1. - y1 / y3);
+  EXPECT_DOUBLE_EQ((expr(f2) / 2. + 3.)(x)[0], y2 / 2. + 3.);
+  EXPECT_DOUBLE_EQ((4. / (expr(f1) - expr(f2)))(x)[0], 4. / (y1 - y2));
+}
+
+TEST_F(ExpressionTest, ExpressionBatch) {
+  // Check the batch evaluation on several blocks with a padded leading dimension
+  const std::size_t n = 600, ld = 608;
+  Uniform<dim> dist(0.5, 2.);
+  auto inputs = dist.samples(n);
+  std::vector<double> x(dim * ld), y(ld);
+  for (std::size_t i = 0; i < n; ++i) {
+    for (int d = 0; d < dim; ++d) x[d * ld + i] = (*inputs)[i][d];
+  }
+
+  auto e = (expr(f1) + expr(f2) * expr(f3)) - expr(f1) / expr(f3);
+  e(x.data(), ld, y.data(), ld, n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const Vector<dim>& u = (*inputs)[i];
+    double ref = ((*f1)(u)[0] + (*f2)(u)[0] * (*f3)(u)[0]) - (*f1)(u)[0] / (*f3)(u)[0];
+    EXPECT_NEAR(y[i], ref, 1.e-12 * std::max(1., std::abs(ref)));
+  }
+
+  // Check the function adapter
+  auto g = make_function(e);
+  std::fill(y.begin(), y.end(), 0.);
+  g(x.data(), ld, y.data(), ld, n);
+  for (std::size_t i = 0; i < n; ++i) {
+    EXPECT_EQ(y[i], e((*inputs)[i])[0]);
+  }
+}
+
+TEST_F(ExpressionTest, ExpressionOwnership) {
+  // Expressions built from temporaries own copies of the functions
+  auto build = [this]() {
+    std::vector<std::vector<double>> coeffs = {{1., 2., 3.}, {0., 1., 0.}};
+    return expr(Polynomial<dim, 1>(coeffs)) * 2. + expr(f1);
+  };
+  auto e = build();
+  Vector<dim> x = 1.;
+  EXPECT_DOUBLE_EQ(e(x)[0], 2. * 7. + (*f1)(x)[0]);
+
+  // Shared functions are not copied
+  long count = f1.use_count();
+  auto copy = e;
+  EXPECT_EQ(f1.use_count(), count + 1);
+
+  // Check the domain errors of the leaves
+  auto g = make_function(expr(f3) + expr(f3));
+  x[0] = -1.;
+  EXPECT_TRUE(std::isnan(g(x)[0]));
+  EXPECT_EQ(g.domain_errors(), 2u);
+}
+
+} // namespace
@@ -1,4 +1,5 @@
 #include "functions.hpp"
+#include "distributions.hpp"
 
 #include <gtest/gtest.h>
 #include <vector>
@@ -127,6 +128,127 @@ TEST_F(LinearTest, LinearEval) {
   EXPECT_DOUBLE_EQ(y[3], 3.5);
 }
 
+TEST_F(LinearTest, LinearParameters) {
+  // Check the construction from the weights and the copy
+  std::vector<std::vector<double>> weights = {{1., 2., 3.}, {0., -1., 0.5}};
+  std::vector<double> biases = {1., -1.};
+  Linear<3, 2> g(weights, biases);
+  Linear<3, 2> h(g);
+  Linear<3, 4> copy(*f);
+  Vector<3> x(std::vector<double>({1., 0., 1.}));
+  EXPECT_DOUBLE_EQ(h(x)[0], 5.);
+  EXPECT_DOUBLE_EQ(h(x)[1], -0.5);
+  EXPECT_DOUBLE_EQ(copy(x)[0], 7.2);
+
+  // Check the dimensions of the parameters
+  std::vector<double> short_biases = {1.};
+  std::vector<std::vector<double>> short_weights = {{1., 2.}, {0., -1.}};
+  EXPECT_THROW((Linear<3, 2>(weights, short_biases)), InvalidInputException);
+  EXPECT_THROW((Linear<3, 2>(short_weights, biases)), InvalidInputException);
+}
+
+TEST_F(LinearTest, FunctionAccumulate) {
+  // Accumulate 4500 samples in chunks of 1000 (the last chunk is partial)
+  Normal<3> dist(1., 2.);
+  MomentAccumulator<4> acc = f->accumulate(4500, dist, 1000);
+  EXPECT_EQ(acc.count(), 4500);
+
+  // Evaluate the same chunks with the stored samples
+  MomentAccumulator<4> ref;
+  for (int k = 0; k < 5; ++k) {
+    Philox rng = dist.rng().substream(k);
+    auto samples = dist.samples(k < 4 ? 1000 : 500, rng);
+    ref.add(*(*f)(samples));
+  }
+  for (unsigned int order = 1; order <= 6; ++order) {
+    EXPECT_TRUE(acc.moment(order, "central").isApprox(ref.moment(order, "central"), 1.e-10));
+  }
+
+  // The generator of the distribution is not advanced
+  MomentAccumulator<4> again = f->accumulate(4500, dist, 1000);
+  EXPECT_EQ(acc.mean(), again.mean());
+  EXPECT_THROW(f->accumulate(4500, dist, 0), InvalidInputException);
+}
+
+TEST_F(LinearTest, FunctionThreads) {
+  // Check that the threads give the same samples and moments
+  Normal<3> dist1(1., 2.), dist2(1., 2.);
+  auto mca1 = f->mca(3000, dist1);
+  auto mca2 = f->mca(3000, dist2, 4);
+  EXPECT_EQ(mca1.data()[2999][3], mca2.data()[2999][3]);
+  EXPECT_TRUE(mca1.kurtosis().isApprox(mca2.kurtosis(), 1.e-12));
+
+  // Check that the streaming mode is deterministic and close to a single thread
+  MomentAccumulator<4> acc1 = f->accumulate(5000, dist1, 700, 6, 1);
+  MomentAccumulator<4> acc3 = f->accumulate(5000, dist1, 700, 6, 3);
+  MomentAccumulator<4> again = f->accumulate(5000, dist1, 700, 6, 3);
+  EXPECT_EQ(acc3.count(), 5000);
+  EXPECT_EQ(acc3.moment(4, "central"), again.moment(4, "central"));
+  EXPECT_TRUE(acc1.moment(4, "central").isApprox(acc3.moment(4, "central"), 1.e-12));
+}
+
+TEST_F(LinearTest, FunctionAntithetic) {
+  // The reflected samples cancel the fluctuations of a linear function exactly
+  Normal<3> dist(1., 2.);
+  MomentAccumulator<4> pairs;
+  MomentAccumulator<4> acc = f->antithetic(5001, dist, pairs, 700, 4, 3);
+  EXPECT_EQ(acc.count(), 5002);
+  EXPECT_EQ(pairs.count(), 2501);
+  Vector<4> exact = (*f)(dist.mean());
+  for (unsigned int d = 0; d < 4; ++d) {
+    EXPECT_NEAR(acc.mean()[d], exact[d], 1.e-10 * std::max(1., std::abs(exact[d])));
+    EXPECT_NEAR(pairs.mean()[d], acc.mean()[d], 1.e-10 * std::max(1., std::abs(exact[d])));
+    EXPECT_LT(pairs.var()[d], 1.e-20 * std::max(1., acc.var()[d]));
+  }
+
+  // The moments of the outputs do not depend on the number of threads
+  MomentAccumulator<4> pairs1;
+  MomentAccumulator<4> acc1 = f->antithetic(5001, dist, pairs1, 700, 4, 1);
+  EXPECT_TRUE(acc1.moment(4, "central").isApprox(acc.moment(4, "central"), 1.e-12));
+  EXPECT_THROW(f->antithetic(5001, dist, pairs, 0), InvalidInputException);
+}
+
+TEST_F(LinearTest, FunctionImportanceSampling) {
+  // The weighted samples of a wider proposal estimate the moments of the target
+  Normal<3> target(1., 2.), proposal(1., 4.), plain(1., 2.);
+  auto weighted = f->mca(200000, proposal, target, 4);
+  auto ref = f->mca(200000, plain, 4);
+  ASSERT_TRUE(weighted.has_weights());
+  EXPECT_EQ(weighted.weights().size(), 200000u);
+  EXPECT_TRUE(weighted.mean().isApprox(ref.mean(), 2.e-2));
+  EXPECT_TRUE(weighted.var().isApprox(ref.var(), 2.e-2));
+
+  // The weights of a normal proposal with twice the variance have a finite second moment
+  const MomentAccumulator<4>& acc = weighted.accumulator();
+  EXPECT_NEAR(acc.weight() / acc.count(), 1., 2.e-2);
+  EXPECT_LT(acc.ess(), 200000.);
+  EXPECT_GT(acc.ess(), 0.5 * 200000.);
+
+  // The weights do not depend on the number of threads
+  Normal<3> proposal1(1., 4.);
+  auto single = f->mca(200000, proposal1, target, 1);
+  EXPECT_EQ(single.weights()[199999], weighted.weights()[199999]);
+  EXPECT_TRUE(single.kurtosis().isApprox(weighted.kurtosis(), 1.e-10));
+}
+
+TEST_F(MultivariatePolynomialTest, MultivariatePolynomialBatch) {
+  // Check the batch evaluation with padded blocks against the evaluation of each input
+  const std::size_t n = 300, ld = 310;
+  Uniform<3> dist(-2., 2.);
+  auto inputs = dist.samples(n);
+  std::vector<double> x(3 * ld), y(4 * ld);
+  for (std::size_t i = 0; i < n; ++i) {
+    for (int d = 0; d < 3; ++d) x[d * ld + i] = (*inputs)[i][d];
+  }
+  (*f)(x.data(), ld, y.data(), ld, n);
+  for (std::size_t i = 0; i < n; ++i) {
+    Vector<4> ref = (*f)((*inputs)[i]);
+    for (int d = 0; d < 4; ++d) {
+      EXPECT_NEAR(y[d * ld + i], ref[d], 1.e-12 * std::max(1., std::abs(ref[d])));
+    }
+  }
+}
+
 TEST_F(SumExponentialTest, SumExponentialEval) {
   Vector<dim> x(std::vector<double>({2., 0., 1.}));
   double y = (*f)(x)[0];
@@ -139,6 +261,25 @@ TEST_F(SumLogarithmTest, SumLogarithmEval) {
   EXPECT_DOUBLE_EQ(y, 7.1670378769122198);
 }
 
+TEST_F(SumLogarithmTest, SumLogarithmDomainErrors) {
+  // Check that the samples with non-positive inputs are counted instead of being reported one by one
+  Vector<dim> x = 1.;
+  double y = (*f)(x)[0];
+  EXPECT_EQ(f->domain_errors(), 0u);
+  x[0] = -1.;
+  y = (*f)(x)[0];
+  EXPECT_TRUE(std::isnan(y));
+  EXPECT_EQ(f->domain_errors(), 1u);
+  x[1] = 0.;
+  y = (*f)(x)[0];
+  EXPECT_EQ(f->domain_errors(), 2u);
+  // Check that the errors of combined functions are counted
+  SumExponential<dim, 1> g(std::string(PROJECT_SOURCE_DIR) + "/tests/data/sumexp.dat");
+  CombinedFunctionSum<dim, 1> h(*f, g);
+  h(x);
+  EXPECT_EQ(h.domain_errors(), 3u);
+}
+
 TEST_F(CombinationTest, CombinedSum) {
   // Check that the sum of two functions is evaluated correctly
   Vector<dim> x = 1.;
@@ -216,4 +357,29 @@ TEST_F(CombinationTest, ComplexCombination) {
   EXPECT_DOUBLE_EQ(y3, 454.73159276741984);
 }
 
+TEST_F(CombinationTest, CombinedBatch) {
+  // Check the batch evaluation of all the function types and of a combination
+  const std::size_t n = 300;
+  Uniform<dim> dist(0.5, 2.);
+  auto inputs = dist.samples(n);
+  std::vector<double> x(dim * n), y(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    for (int d = 0; d < dim; ++d) x[d * n + i] = (*inputs)[i][d];
+  }
+
+  // The combined functions only keep references to their sources
+  auto prod = (*f2) * (*f3);
+  auto div = (*f1) / (*f3);
+  auto sum = (*f1) + prod;
+  auto combination = sum - div;
+  std::vector<Function<dim, 1>*> functions = {f1, f2, f3, &combination};
+  for (auto f : functions) {
+    (*f)(x.data(), n, y.data(), n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+      double ref = (*f)((*inputs)[i])[0];
+      EXPECT_NEAR(y[i], ref, 1.e-12 * std::max(1., std::abs(ref)));
+    }
+  }
+}
+
 } // namespace
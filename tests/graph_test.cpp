@@ -0,0 +1,111 @@
+#include "graph.hpp"
+#include "functions.hpp"
+#include "distributions.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <string>
+
+
+namespace {
+
+#define dim 3
+
+/// @brief Function which counts the number of its evaluated samples.
+class CountingFunction : public Function<dim, 1>
+{
+public:
+  mutable std::size_t count = 0;
+
+private:
+  Vector<1> call(const Vector<dim>& x) const override {
+    ++count;
+    return x[0] + 2. * x[1] - x[2];
+  }
+
+  void call_batch(const double* x, std::size_t ldx, double* y, std::size_t, std::size_t n) const override {
+    count += n;
+    for (std::size_t i = 0; i < n; ++i) {
+      y[i] = x[i] + 2. * x[ldx + i] - x[2 * ldx + i];
+    }
+  }
+};
+
+TEST(GraphTest, GraphSharing) {
+  // Check that f * f + f evaluates f once per sample
+  auto f = std::make_shared<CountingFunction>();
+  FunctionGraph<dim, 1> g;
+  std::size_t a = g.function(f);
+  std::size_t b = g.function(f);
+  EXPECT_EQ(a, b);
+  std::size_t ff = g.combine(FunctionGraph<dim, 1>::NodeType::Mul, a, b);
+  g.output(g.combine(FunctionGraph<dim, 1>::NodeType::Sum, ff, a));
+  EXPECT_EQ(g.size(), 3u);
+
+  const std::size_t n = 600;
+  Uniform<dim> dist(-1., 1.);
+  auto inputs = dist.samples(n);
+  auto outputs = g(inputs);
+  EXPECT_EQ(f->count, n);
+  for (std::size_t i = 0; i < n; ++i) {
+    double v = (*f)((*inputs)[i])[0];
+    EXPECT_NEAR((*outputs)[i][0], v * v + v, 1.e-14 * std::max(1., std::abs(v)));
+  }
+
+  // Check that the commutative operations and the constants are shared
+  std::size_t c = g.constant(2.);
+  EXPECT_EQ(g.constant(2.), c);
+  EXPECT_EQ(g.combine(FunctionGraph<dim, 1>::NodeType::Mul, c, a), g.combine(FunctionGraph<dim, 1>::NodeType::Mul, a, c));
+  EXPECT_NE(g.combine(FunctionGraph<dim, 1>::NodeType::Sub, c, a), g.combine(FunctionGraph<dim, 1>::NodeType::Sub, a, c));
+  EXPECT_THROW(g.combine(FunctionGraph<dim, 1>::NodeType::Sum, a, 100), InvalidInputException);
+}
+
+TEST(GraphTest, GraphBuffers) {
+  // Check that the buffers are reused along a chain of operations
+  using NodeType = FunctionGraph<dim, 1>::NodeType;
+  auto f = std::make_shared<CountingFunction>();
+  FunctionGraph<dim, 1> g;
+  std::size_t node = g.function(f);
+  for (int k = 1; k <= 20; ++k) {
+    node = g.combine((k % 2) ? NodeType::Sum : NodeType::Mul, node, g.constant(1. + k / 20.));
+  }
+  g.output(node);
+  EXPECT_LE(g.buffers(), 3u);
+
+  double ref = 0.5;
+  for (int k = 1; k <= 20; ++k) {
+    ref = (k % 2) ? ref + (1. + k / 20.) : ref * (1. + k / 20.);
+  }
+  Vector<dim> x(std::vector<double>({0.5, 0., 0.}));
+  EXPECT_DOUBLE_EQ(g(x)[0], ref);
+}
+
+TEST(GraphTest, GraphFile) {
+  // Check the combination file against the source functions
+  auto g = load_function<dim, 1>(std::string(PROJECT_SOURCE_DIR) + "/tests/data/combination.dat");
+  Polynomial<dim, 1> f1(std::string(PROJECT_SOURCE_DIR) + "/tests/data/poly.dat");
+  SumExponential<dim, 1> f2(std::string(PROJECT_SOURCE_DIR) + "/tests/data/sumexp.dat");
+  SumLogarithm<dim, 1> f3(std::string(PROJECT_SOURCE_DIR) + "/tests/data/sumlog.dat");
+
+  Uniform<dim> dist(0.5, 2.);
+  auto inputs = dist.samples(300);
+  auto outputs = (*g)(inputs);
+  for (std::size_t i = 0; i < inputs->size(); ++i) {
+    const Vector<dim>& x = (*inputs)[i];
+    double y1 = f1(x)[0], y2 = f2(x)[0], y3 = f3(x)[0];
+    double ref = y1 * y1 + y1 - 2. * y2 / (y3 + 1.);
+    EXPECT_NEAR((*outputs)[i][0], ref, 1.e-12 * std::max(1., std::abs(ref)));
+  }
+  EXPECT_EQ(g->domain_errors(), 0u);
+
+  // Check the invalid files
+  EXPECT_THROW((FunctionGraph<dim, 1>(std::string(PROJECT_SOURCE_DIR) + "/tests/data/poly.dat")), InvalidInputException);
+  EXPECT_THROW((load_function<dim, 2>(std::string(PROJECT_SOURCE_DIR) + "/tests/data/combination.dat")), InvalidInputException);
+  EXPECT_THROW((load_function<dim, 1>(std::string(PROJECT_SOURCE_DIR) + "/tests/data/recursive.dat")), InvalidInputException);
+  // The file can be loaded again after the failure
+  EXPECT_NO_THROW((load_function<dim, 1>(std::string(PROJECT_SOURCE_DIR) + "/tests/data/combination.dat")));
+}
+
+} // namespace
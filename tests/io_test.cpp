@@ -0,0 +1,78 @@
+#include "io.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <cmath>
+
+
+namespace {
+
+/// @brief Workflow which exposes the approximations of its report.
+class WorkflowProbe : public Workflow<3, 4>
+{
+public:
+  using Workflow<3, 4>::Workflow;
+
+  /// @brief Return whether the exact moments are reported.
+  bool exact() const { return m_use_exact; }
+  /// @brief Return the reported approximator.
+  MonteCarloApproximator<4>& mca() { return m_mca; }
+  /// @brief Return the approximator of the exact moments.
+  MonteCarloApproximator<4>& analytic() { return m_exact; }
+  /// @brief Return the number of replicates.
+  std::size_t replicates() const { return m_replicates.size(); }
+  /// @brief Return the number of antithetic pairs.
+  std::uint64_t pairs() const { return m_pairs.count(); }
+  /// @brief Return the number of samples of the control variates.
+  std::uint64_t controls() const { return m_control.count(); }
+};
+
+/// @brief Parse the arguments of the linear test function, followed by extra arguments.
+ArgParser parse(std::vector<std::string> extra) {
+  std::vector<std::string> args = {"main", "--function", std::string(PROJECT_SOURCE_DIR) + "/tests/data/linear.dat",
+    "-n", "4000", "--threads", "2"};
+  args.insert(args.end(), extra.begin(), extra.end());
+  std::vector<char*> argv;
+  for (std::string& arg : args) {
+    argv.push_back(&arg[0]);
+  }
+  return ArgParser(argv.size(), argv.data());
+}
+
+TEST(WorkflowTest, WorkflowExplicitEstimators) {
+  // Without an explicit estimator, the exact moments of a linear function are reported
+  ArgParser parser = parse({});
+  WorkflowProbe workflow(parser);
+  ASSERT_TRUE(workflow.exact());
+  const Eigen::VectorXd mean = workflow.analytic().mean();
+  EXPECT_TRUE(workflow.mca().mean().isApprox(mean));
+
+  // The explicit estimators, the streaming mode, and the quasi-random sequences are run under the default
+  // --analytic, and only checked against the exact moments
+  ArgParser parser_control = parse({"--control", "1"});
+  WorkflowProbe control(parser_control);
+  EXPECT_EQ(control.controls(), 4000u);
+  ArgParser parser_antithetic = parse({"--antithetic", "1"});
+  WorkflowProbe antithetic(parser_antithetic);
+  EXPECT_EQ(antithetic.pairs(), 2000u);
+  ArgParser parser_proposal = parse({"--proposal", "2"});
+  WorkflowProbe proposal(parser_proposal);
+  EXPECT_TRUE(proposal.mca().has_weights());
+  ArgParser parser_replicates = parse({"--replicates", "4", "--dist", "sobol-normal"});
+  WorkflowProbe replicates(parser_replicates);
+  EXPECT_EQ(replicates.replicates(), 4u);
+  ArgParser parser_stream = parse({"--stream", "1"});
+  WorkflowProbe stream(parser_stream);
+  EXPECT_FALSE(stream.mca().has_data());
+  ArgParser parser_sequence = parse({"--dist", "sobol-normal"});
+  WorkflowProbe sequence(parser_sequence);
+  EXPECT_TRUE(sequence.mca().has_data());
+  for (WorkflowProbe* probe : {&control, &antithetic, &proposal, &replicates, &stream, &sequence}) {
+    EXPECT_FALSE(probe->exact());
+    EXPECT_TRUE(probe->analytic().mean().isApprox(mean));
+    EXPECT_TRUE(probe->mca().mean().isApprox(mean, 0.1));
+  }
+}
+
+} // namespace
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "mathutils.hpp"
+
+
+namespace{
+
+TEST(MathUtilsTest, NormalQuantileValues) {
+  EXPECT_EQ(normal_quantile(0.5), 0.);
+  EXPECT_NEAR(normal_quantile(0.975), 1.959963984540054, 1.e-15);
+  EXPECT_NEAR(normal_quantile(0.025), -1.959963984540054, 1.e-15);
+  EXPECT_NEAR(normal_quantile(1.e-10), -6.361340902404056, 1.e-14);
+  EXPECT_TRUE(std::isinf(normal_quantile(0.)));
+  EXPECT_TRUE(std::isinf(normal_quantile(1.)));
+  EXPECT_TRUE(std::isnan(normal_quantile(1.5)));
+}
+
+TEST(MathUtilsTest, NormalQuantileInverse) {
+  // Check that the normal CDF of the quantile gives back the probability
+  std::vector<double> ps = {1.e-300, 1.e-100, 1.e-20, 1.e-5, 0.01, 0.1, 0.3, 0.45, 0.5, 0.55, 0.8, 0.99, 1. - 1.e-10};
+  for (double p : ps) {
+    double z = normal_quantile(p);
+    double cdf = 0.5 * std::erfc(-z / std::sqrt(2.));
+    // The relative error of the CDF is amplified by z^2 in the tails
+    EXPECT_NEAR(cdf / p, 1., 1.e-14 * std::max(1., z * z));
+  }
+}
+
+TEST(MathUtilsTest, NormalQuantileBatch) {
+  // Check that the batch version matches the scalar version, also in-place
+  std::vector<double> p(100), z(100);
+  for (int i = 0; i < 100; ++i) {
+    p[i] = (i + 0.5) / 100.;
+  }
+  normal_quantile(p.data(), z.data(), p.size());
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(z[i], normal_quantile(p[i]));
+  }
+  normal_quantile(p.data(), p.data(), p.size());
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(p[i], z[i]);
+  }
+}
+
+TEST(MathUtilsTest, HornerBatch) {
+  // Alternating polynomial of high order with cancellations
+  const std::size_t order = 30, n = 53;
+  std::vector<double> coeffs(order + 1), x(n), y(n, 1.);
+  for (std::size_t k = 0; k <= order; ++k) {
+    coeffs[k] = ((k % 2) ? -1. : 1.) / (k + 1);
+  }
+  for (std::size_t i = 0; i < n; ++i) {
+    x[i] = -1.5 + 3. * i / (n - 1);
+  }
+  horner(coeffs.data(), order, x.data(), y.data(), n);
+
+  // Check against an evaluation in extended precision (relative to the condition number)
+  for (std::size_t i = 0; i < n; ++i) {
+    long double ref = 0., cond = 0.;
+    for (std::size_t k = order + 1; k-- > 0;) {
+      ref = ref * x[i] + coeffs[k];
+      cond = cond * std::abs(x[i]) + std::abs(coeffs[k]);
+    }
+    EXPECT_NEAR(y[i], 1. + ref, 1.e-15 * (1. + 4. * order * cond)) << x[i];
+  }
+}
+
+TEST(MathUtilsTest, PolynomialShift) {
+  // (1 + x) (1 - x) = 1 - x^2
+  std::vector<double> product = polynomial_product({1., 1.}, {1., -1.});
+  ASSERT_EQ(product.size(), 3u);
+  EXPECT_EQ(product[0], 1.);
+  EXPECT_EQ(product[1], 0.);
+  EXPECT_EQ(product[2], -1.);
+  EXPECT_TRUE(polynomial_product({}, {1., 2.}).empty());
+
+  // Check q(w) = p(x0 + w) on a few points
+  std::vector<double> p = {0.5, -2., 0.25, 3., -1.};
+  const double x0 = 1.7;
+  std::vector<double> q = polynomial_shift(p, x0);
+  ASSERT_EQ(q.size(), p.size());
+  for (double w : {-2., -0.3, 0., 1.1}) {
+    double pw = 0., qw = 0.;
+    for (std::size_t k = p.size(); k-- > 0;) {
+      pw = pw * (x0 + w) + p[k];
+      qw = qw * w + q[k];
+    }
+    EXPECT_NEAR(qw, pw, 1.e-12 * std::max(1., std::abs(pw))) << w;
+  }
+}
+
+TEST(MathUtilsTest, ExpLogBatch) {
+  // Compare with the standard library on a wide range of arguments (in ULP)
+  const std::size_t n = 20001;
+  std::vector<double> x(n), y(n), z(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    x[i] = -740. + 1449. * i / (n - 1);
+    z[i] = std::exp(0.035 * x[i] - 5.);
+  }
+  exp_batch(x.data(), y.data(), n);
+  for (std::size_t i = 0; i < n; ++i) {
+    double ref = std::exp(x[i]);
+    EXPECT_LE(std::abs(y[i] - ref), 2. * (std::nextafter(ref, INFINITY) - ref)) << x[i];
+  }
+  log_batch(z.data(), y.data(), n);
+  for (std::size_t i = 0; i < n; ++i) {
+    double ref = std::log(z[i]);
+    EXPECT_LE(std::abs(y[i] - ref), 2. * (std::nextafter(std::abs(ref), INFINITY) - std::abs(ref))) << z[i];
+  }
+
+  // Check the special values
+  std::vector<double> s = {0., -0., -1., INFINITY, -INFINITY, NAN, 800., -800., 4.e-320};
+  std::vector<double> e(s.size()), l(s.size());
+  exp_batch(s.data(), e.data(), s.size());
+  log_batch(s.data(), l.data(), s.size());
+  for (std::size_t i = 0; i < s.size(); ++i) {
+    if (std::isnan(std::exp(s[i]))) {
+      EXPECT_TRUE(std::isnan(e[i])) << s[i];
+    }
+    else {
+      EXPECT_EQ(e[i], std::exp(s[i])) << s[i];
+    }
+    if (std::isnan(std::log(s[i]))) {
+      EXPECT_TRUE(std::isnan(l[i])) << s[i];
+    }
+    else if (std::isinf(std::log(s[i]))) {
+      EXPECT_EQ(l[i], std::log(s[i])) << s[i];
+    }
+    else {
+      EXPECT_NEAR(l[i], std::log(s[i]), 1.e-13) << s[i];
+    }
+  }
+}
+
+TEST(MathUtilsTest, Erfinv) {
+  EXPECT_NEAR(erfinv(0.5), 0.4769362762044699, 1.e-15);
+  EXPECT_NEAR(erfinv(-0.5), -0.4769362762044699, 1.e-15);
+  EXPECT_NEAR(erfinv(1.e-20), std::sqrt(M_PI) / 2. * 1.e-20, 1.e-34);
+  for (double v = -0.999; v < 1.; v += 0.037) {
+    EXPECT_NEAR(std::erf(erfinv(v)), v, 1.e-15);
+  }
+  EXPECT_THROW(erfinv(1.), InvalidInputException);
+  EXPECT_THROW(erfinv(-1.), InvalidInputException);
+}
+
+}
@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <cstdint>
+#include <stdexcept>
+#include "parallel.hpp"
+
+
+namespace{
+
+TEST(ParallelTest, ParallelPartition) {
+  // Check that the parts cover the range and are aligned
+  std::vector<std::uint64_t> begins(5), ends(5);
+  parallel_for(1000, 5, [&](unsigned int t, std::uint64_t begin, std::uint64_t end) {
+    begins[t] = begin;
+    ends[t] = end;
+  }, 64);
+  EXPECT_EQ(begins[0], 0);
+  EXPECT_EQ(ends[4], 1000);
+  for (int t = 0; t < 5; ++t) {
+    EXPECT_EQ(begins[t] % 64, 0);
+    if (t > 0) {
+      EXPECT_EQ(begins[t], ends[t - 1]);
+    }
+  }
+
+  // Check that more threads than elements give empty parts
+  std::vector<std::uint64_t> sizes(4);
+  parallel_for(2, 4, [&](unsigned int t, std::uint64_t begin, std::uint64_t end) {
+    sizes[t] = end - begin;
+  });
+  EXPECT_EQ(sizes[0] + sizes[1] + sizes[2] + sizes[3], 2);
+  EXPECT_GE(default_threads(), 1);
+}
+
+TEST(ParallelTest, ParallelException) {
+  // Check that the errors of the threads are rethrown
+  auto task = [](unsigned int t, std::uint64_t, std::uint64_t) {
+    if (t == 2) throw std::runtime_error("error");
+  };
+  EXPECT_THROW(parallel_for(100, 4, task), std::runtime_error);
+}
+
+}
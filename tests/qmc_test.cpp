@@ -0,0 +1,163 @@
+#include "qmc.hpp"
+#include "distributions.hpp"
+#include "functions.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <memory>
+#include <cmath>
+
+
+namespace {
+
+TEST(QmcTest, SobolPoints) {
+  SobolSequence sobol(QMC_MAX_DIM);
+
+  // The first points of the first two coordinates (the origin is skipped)
+  double expected[2][6] = {
+    {0.5, 0.75, 0.25, 0.375, 0.875, 0.625},
+    {0.5, 0.25, 0.75, 0.375, 0.875, 0.125}
+  };
+  std::vector<double> points(QMC_MAX_DIM * 6);
+  sobol.points(0, 6, points.data(), 6);
+  for (unsigned int d = 0; d < 2; ++d) {
+    for (std::size_t i = 0; i < 6; ++i) {
+      EXPECT_NEAR(points[d * 6 + i], expected[d][i], 1.e-15);
+    }
+  }
+
+  // The first 2^m points of each coordinate fill the 2^m intervals of length 2^-m
+  const unsigned int m = 10;
+  for (unsigned int d = 0; d < QMC_MAX_DIM; ++d) {
+    std::vector<int> counts(1 << m, 0);
+    for (std::uint64_t i = 0; i < (1u << m); ++i) {
+      counts[sobol.integer_point(i)[d] >> (QMC_BITS - m)]++;
+    }
+    for (int count : counts) {
+      EXPECT_EQ(count, 1);
+    }
+  }
+
+  // Skipping ahead gives the same points as the Gray code recurrence
+  std::vector<double> all(3 * 1000), part(3 * 300);
+  SobolSequence sobol3(3);
+  sobol3.points(0, 1000, all.data(), 1000);
+  sobol3.points(700, 300, part.data(), 300);
+  for (unsigned int d = 0; d < 3; ++d) {
+    for (std::size_t i = 0; i < 300; ++i) {
+      EXPECT_EQ(part[d * 300 + i], all[d * 1000 + 700 + i]);
+    }
+  }
+  EXPECT_THROW(SobolSequence(QMC_MAX_DIM + 1), InvalidInputException);
+}
+
+TEST(QmcTest, HaltonPoints) {
+  HaltonSequence halton(2);
+
+  // Radical inverses in bases 2 and 3
+  double expected[2][6] = {
+    {1. / 2, 1. / 4, 3. / 4, 1. / 8, 5. / 8, 3. / 8},
+    {1. / 3, 2. / 3, 1. / 9, 4. / 9, 7. / 9, 2. / 9}
+  };
+  std::vector<double> points(2 * 6);
+  halton.points(0, 6, points.data(), 6);
+  for (unsigned int d = 0; d < 2; ++d) {
+    for (std::size_t i = 0; i < 6; ++i) {
+      EXPECT_NEAR(points[d * 6 + i], expected[d][i], 1.e-15);
+    }
+  }
+
+  // The incremental update with carries gives the same points as the direct computation
+  std::vector<double> all(2 * 2000), part(2 * 1000);
+  halton.points(0, 2000, all.data(), 2000);
+  halton.points(999, 1000, part.data(), 1000);
+  for (unsigned int d = 0; d < 2; ++d) {
+    for (std::size_t i = 0; i < 1000; ++i) {
+      EXPECT_NEAR(part[d * 1000 + i], all[d * 2000 + 999 + i], 1.e-15);
+    }
+  }
+}
+
+TEST(QmcTest, QuasiRandomDistributions) {
+  // The quasi-random samples do not depend on the number of threads
+  Normal<3> dist(0., 1.);
+  dist.set_sequence(std::make_shared<SobolSequence>(3));
+  SampleBlock<3> one(4096), four(4096);
+  Philox rng1 = dist.rng().split(5), rng4 = dist.rng().split(5);
+  dist.samples(one, rng1, 1);
+  dist.samples(four, rng4, 4);
+  EXPECT_EQ(rng1.position(), rng4.position());
+  for (std::size_t i = 0; i < 4096; ++i) {
+    for (unsigned int d = 0; d < 3; ++d) {
+      EXPECT_EQ(one[i][d], four[i][d]);
+    }
+  }
+
+  // The second moment is integrated much more accurately than with random samples
+  Eigen::VectorXd mean = one.matrix().colwise().mean();
+  Eigen::VectorXd square = one.matrix().array().square().colwise().mean();
+  for (unsigned int d = 0; d < 3; ++d) {
+    EXPECT_NEAR(mean[d], 0., 1.e-3);
+    EXPECT_NEAR(square[d], 1., 5.e-3);
+  }
+
+  // The chunks of the streaming mode cover the first points of the sequence
+  MultivariatePolynomial<3, 4> f(std::string(PROJECT_SOURCE_DIR) + "/tests/data/multipoly.dat");
+  Uniform<3> uniform(-1., 2.);
+  uniform.set_sequence(std::make_shared<HaltonSequence>(3));
+  MomentAccumulator<4> streamed = f.accumulate(5000, uniform, 700, 4, 3);
+  auto stored = f.mca(5000, uniform, 2);
+  for (unsigned int d = 0; d < 4; ++d) {
+    EXPECT_NEAR(streamed.mean()[d], stored.mean()[d], 1.e-12 * std::abs(stored.mean()[d]));
+  }
+  EXPECT_THROW(Normal<4>(0., 1.).set_sequence(std::make_shared<SobolSequence>(3)), InvalidInputException);
+}
+
+TEST(QmcTest, RandomizedReplicates) {
+  // The digital shift only depends on the key and keeps the stratification of the points
+  SobolSequence sobol(2, true);
+  const std::size_t n = 1024;
+  std::vector<double> a(2 * n), b(2 * n), c(2 * n);
+  sobol.points(0, n, a.data(), n, 1);
+  sobol.points(0, n, b.data(), n, 1);
+  sobol.points(0, n, c.data(), n, 2);
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+  for (unsigned int d = 0; d < 2; ++d) {
+    std::vector<int> counts(n, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+      counts[(std::size_t)(c[d * n + i] * n)]++;
+    }
+    for (int count : counts) {
+      EXPECT_EQ(count, 1);
+    }
+  }
+
+  // The first replicate is the streaming accumulation, and the randomized replicates are independent
+  MultivariatePolynomial<3, 4> f(std::string(PROJECT_SOURCE_DIR) + "/tests/data/multipoly.dat");
+  Uniform<3> random(-1., 2.), quasi(-1., 2.);
+  quasi.set_sequence(std::make_shared<SobolSequence>(3, true));
+  const unsigned int R = 8;
+  auto mc = f.replicate(4096, random, R, 1000, 4, 3);
+  auto rqmc = f.replicate(4096, quasi, R, 1000, 4, 3);
+  MomentAccumulator<4> first = f.accumulate(4096, quasi, 1000, 4, 2);
+  ASSERT_EQ(rqmc.size(), R);
+  for (unsigned int d = 0; d < 4; ++d) {
+    EXPECT_NEAR(first.mean()[d], rqmc[0].mean()[d], 1.e-12 * std::abs(first.mean()[d]));
+    EXPECT_NE(rqmc[0].mean()[d], rqmc[1].mean()[d]);
+  }
+
+  // The spread of the quasi-random replicates is much smaller
+  for (unsigned int d = 0; d < 4; ++d) {
+    MomentAccumulator<1> mc_means, rqmc_means;
+    for (unsigned int r = 0; r < R; ++r) {
+      EXPECT_EQ(rqmc[r].count(), 4096u);
+      mc_means.add(Vector<1>(mc[r].mean()[d]));
+      rqmc_means.add(Vector<1>(rqmc[r].mean()[d]));
+    }
+    EXPECT_LT(rqmc_means.var()[0], 1.e-2 * mc_means.var()[0]);
+  }
+}
+
+} // namespace
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <array>
+#include <cstdint>
+#include "random.hpp"
+#include "distributions.hpp"
+
+
+namespace{
+
+TEST(RandomTest, PhiloxKnownAnswer) {
+  // Known-answer tests of the Random123 reference implementation
+  std::array<std::uint32_t, 4> x = Philox::block({0, 0, 0, 0}, {0, 0});
+  std::array<std::uint32_t, 4> expected = {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8};
+  EXPECT_EQ(x, expected);
+
+  x = Philox::block({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff});
+  expected = {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd};
+  EXPECT_EQ(x, expected);
+
+  x = Philox::block({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0});
+  expected = {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1};
+  EXPECT_EQ(x, expected);
+}
+
+TEST(RandomTest, PhiloxReproducible) {
+  // Check that two generators with the same seed produce the same numbers
+  Philox rng1(7), rng2(7), rng3(8);
+  int n_diff = 0;
+  for (int i = 0; i < 100; ++i) {
+    double u = rng1.uniform();
+    EXPECT_EQ(u, rng2.uniform());
+    n_diff += (u != rng3.uniform());
+    EXPECT_GT(u, 0.);
+    EXPECT_LT(u, 1.);
+  }
+  EXPECT_EQ(n_diff, 100);
+}
+
+TEST(RandomTest, PhiloxDiscard) {
+  // Check that jumping ahead is the same as drawing the numbers
+  Philox rng1(RAND_SEED, 3), rng2(RAND_SEED, 3);
+  for (int i = 0; i < 1001; ++i) {
+    rng1.next();
+  }
+  rng2.discard(1001);
+  EXPECT_EQ(rng1.position(), rng2.position());
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(rng1.next(), rng2.next());
+  }
+}
+
+TEST(RandomTest, PhiloxBatch) {
+  // Check that the batch version matches successive scalar draws, from any position
+  Philox rng1, rng2;
+  rng1.next();
+  rng2.next();
+  std::vector<double> u(101);
+  rng1.uniform(u.data(), u.size());
+  for (int i = 0; i < 101; ++i) {
+    EXPECT_EQ(u[i], rng2.uniform());
+  }
+  EXPECT_EQ(rng1.position(), rng2.position());
+}
+
+TEST(RandomTest, PhiloxSplit) {
+  // Check that the streams are different and only depend on the seed and the stream identifier
+  Philox rng;
+  Philox s1 = rng.split(1), s2 = rng.split(2), s1bis = Philox(RAND_SEED, 1);
+  int n_diff = 0;
+  for (int i = 0; i < 100; ++i) {
+    std::uint64_t x = s1.next();
+    n_diff += (x != s2.next());
+    EXPECT_EQ(x, s1bis.next());
+  }
+  EXPECT_EQ(n_diff, 100);
+
+  // The identifiers of the substreams must fit in 32 bits
+  EXPECT_THROW(rng.substream(std::uint64_t(1) << 32), InvalidInputException);
+  EXPECT_THROW(rng.split(std::uint64_t(1) << 32).substream(0), InvalidInputException);
+}
+
+TEST(RandomTest, DistributionSeed) {
+  // Check that distributions with the same seed produce the same samples
+  Uniform<2> dist1(0., 1.), dist2(0., 1.);
+  auto samples1 = dist1.samples(10);
+  auto samples2 = dist2.samples(10);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ((*samples1)[i][0], (*samples2)[i][0]);
+    EXPECT_EQ((*samples1)[i][1], (*samples2)[i][1]);
+  }
+  dist1.seed(RAND_SEED);
+  samples2 = dist1.samples(10);
+  EXPECT_EQ((*samples1)[9][1], (*samples2)[9][1]);
+}
+
+TEST(RandomTest, DistributionThreads) {
+  // Check that the samples do not depend on the number of threads
+  Normal<3> dist1(0., 1.), dist2(0., 1.);
+  auto samples1 = dist1.samples(1000);
+  auto samples2 = dist2.samples(1000, 3);
+  for (int i = 0; i < 1000; ++i) {
+    for (int d = 0; d < 3; ++d) {
+      EXPECT_EQ((*samples1)[i][d], (*samples2)[i][d]);
+    }
+  }
+
+  // Check that the generators are advanced in the same way
+  EXPECT_EQ(dist1.rng().position(), dist2.rng().position());
+  EXPECT_EQ(dist1.samples(1)->at(0)[2], dist2.samples(1)->at(0)[2]);
+}
+
+}
@@ -0,0 +1,149 @@
+#include "samples.hpp"
+#include "distributions.hpp"
+#include "functions.hpp"
+#include "accumulator.hpp"
+#include "mca.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cmath>
+
+
+namespace {
+
+TEST(SamplesTest, SampleBlockLayout) {
+  // The columns start on cache lines
+  SampleBlock<3> block(100);
+  EXPECT_EQ(block.size(), 100u);
+  EXPECT_EQ(block.ld() % (SAMPLE_ALIGNMENT / sizeof(double)), 0u);
+  EXPECT_GE(block.ld(), block.size());
+  for (unsigned int d = 0; d < 3; ++d) {
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(block.column(d)) % SAMPLE_ALIGNMENT, 0u);
+    EXPECT_EQ(block.column(d), block.data() + d * block.ld());
+  }
+
+  // The conversions from and to vectors and the matrix view
+  std::vector<Vector<3>> vectors(100);
+  for (std::size_t i = 0; i < vectors.size(); ++i) {
+    vectors[i] = std::vector<double>{1. * i, -2. * i, 0.5};
+  }
+  SampleBlock<3> converted(vectors);
+  auto back = converted.to_vectors();
+  for (std::size_t i = 0; i < vectors.size(); ++i) {
+    for (unsigned int d = 0; d < 3; ++d) {
+      EXPECT_EQ(converted.column(d)[i], vectors[i][d]);
+      EXPECT_EQ(converted.matrix()(i, d), vectors[i][d]);
+      EXPECT_EQ(back[i][d], vectors[i][d]);
+    }
+  }
+  EXPECT_DOUBLE_EQ(converted.matrix().col(0).mean(), 49.5);
+  converted.matrix().col(2).setConstant(4.);
+  EXPECT_EQ(converted[10][2], 4.);
+}
+
+TEST(SamplesTest, SampleBlockPipeline) {
+  // The samples of a block are the same as the ones of the vectors
+  Uniform<3> dist(-1., 2.);
+  dist.seed(7);
+  auto vectors = dist.samples(1000);
+  dist.seed(7);
+  SampleBlock<3> block(1000);
+  dist.samples(block, 3);
+  for (std::size_t i = 0; i < 1000; ++i) {
+    for (unsigned int d = 0; d < 3; ++d) {
+      EXPECT_EQ(block[i][d], (*vectors)[i][d]);
+    }
+  }
+
+  // The outputs of a function
+  MultivariatePolynomial<3, 4> f(std::string(PROJECT_SOURCE_DIR) + "/tests/data/multipoly.dat");
+  SampleBlock<4> outputs = f(block);
+  auto reference = f(vectors);
+  for (std::size_t i = 0; i < 1000; ++i) {
+    for (unsigned int d = 0; d < 4; ++d) {
+      EXPECT_NEAR(outputs[i][d], (*reference)[i][d], 1.e-12 * std::abs((*reference)[i][d]));
+    }
+  }
+
+  // The moments of the block
+  MomentAccumulator<4> a, b;
+  a.add(outputs);
+  b.add(*reference);
+  MonteCarloApproximator<4> mca(std::make_shared<SampleBlock<4>>(outputs));
+  for (unsigned int d = 0; d < 4; ++d) {
+    EXPECT_NEAR(a.mean()[d], b.mean()[d], 1.e-12 * std::abs(b.mean()[d]));
+    EXPECT_NEAR(a.moment(d, 4, "central"), b.moment(d, 4, "central"), 1.e-10 * b.moment(d, 4, "central"));
+    EXPECT_DOUBLE_EQ(mca.mean()[d], outputs.matrix().col(d).mean());
+  }
+}
+
+TEST(SamplesTest, BufferPoolRecycle) {
+  BufferPool pool;
+  {
+    // Leased buffers are aligned, and the smallest large enough buffer is recycled
+    BufferPool::Buffer a = pool.acquire(100);
+    BufferPool::Buffer b = pool.acquire(1000);
+    EXPECT_GE(a.capacity(), 100u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b.data()) % SAMPLE_ALIGNMENT, 0u);
+    double* small = a.data();
+    a.reset();
+    b = pool.acquire(50);
+    EXPECT_EQ(b.data(), small);
+    EXPECT_EQ(pool.allocations(), 2u);
+    EXPECT_EQ(pool.available(), 1u);
+  }
+  EXPECT_EQ(pool.available(), 2u);
+
+  // The blocks lease their columns from the pool, also when they are copied
+  {
+    SampleBlock<2> block(400, pool);
+    SampleBlock<2> copy(block);
+    EXPECT_EQ(pool.allocations(), 3u);
+    EXPECT_EQ(pool.available(), 1u);
+    copy.resize(10);
+    EXPECT_EQ(pool.allocations(), 3u);
+  }
+  EXPECT_EQ(pool.available(), 3u);
+  pool.clear();
+  EXPECT_EQ(pool.available(), 0u);
+
+  // The largest available buffers are freed down to the limit of the pool
+  {
+    BufferPool::Buffer a = pool.acquire(100);
+    BufferPool::Buffer b = pool.acquire(1000);
+  }
+  pool.trim(500);
+  EXPECT_EQ(pool.available(), 1u);
+  pool.set_limit(0);
+  EXPECT_EQ(pool.available(), 0u);
+  {
+    BufferPool::Buffer c = pool.acquire(10);
+  }
+  EXPECT_EQ(pool.available(), 0u);
+  EXPECT_EQ(pool.limit(), 0u);
+}
+
+TEST(SamplesTest, BufferPoolSteadyState) {
+  // Repeated estimates only allocate buffers for the first one
+  MultivariatePolynomial<3, 4> f(std::string(PROJECT_SOURCE_DIR) + "/tests/data/multipoly.dat");
+  Uniform<3> dist(-1., 2.);
+  BufferPool::shared().clear();
+  std::size_t allocations = 0;
+  for (int k = 0; k < 5; ++k) {
+    {
+      auto mca = f.mca(5000, dist, 4);
+      auto moments = f.accumulate(5000, dist, 1000, 4, 1);
+      EXPECT_EQ(mca.samples().size(), 5000u);
+      EXPECT_EQ(moments.count(), 5000u);
+    }
+    if (k == 0) {
+      allocations = BufferPool::shared().allocations();
+      EXPECT_GT(allocations, 0u);
+    }
+    EXPECT_EQ(BufferPool::shared().allocations(), allocations);
+  }
+}
+
+} // namespace
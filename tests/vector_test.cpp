@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
 #include <vector>
+#include <type_traits>
+#include <cstdint>
 #include "vector.hpp"
 
 
@@ -65,4 +67,78 @@ TEST(VectorTest, VectorDot){
   }
 }
 
+TEST(VectorTest, VectorLayout){
+  // Trivially copyable vectors without padding, aligned to their size in dimensions 2 and 4
+  EXPECT_TRUE(std::is_trivially_copyable<Vector<1>>::value);
+  EXPECT_TRUE(std::is_trivially_copyable<Vector<2>>::value);
+  EXPECT_TRUE(std::is_trivially_copyable<Vector<3>>::value);
+  EXPECT_TRUE(std::is_trivially_copyable<Vector<4>>::value);
+  EXPECT_EQ(sizeof(Vector<2>), 2 * sizeof(double));
+  EXPECT_EQ(sizeof(Vector<3>), 3 * sizeof(double));
+  EXPECT_EQ(sizeof(Vector<4>), 4 * sizeof(double));
+  EXPECT_EQ(alignof(Vector<2>), 16u);
+  EXPECT_EQ(alignof(Vector<4>), 32u);
+
+  // The elements of the vectors in a standard vector are aligned
+  std::vector<Vector<4>> a(7, Vector<4>(1.5));
+  for (const auto& v : a) {
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&v[0]) % 32, 0u);
+  }
+
+  // The element-wise operations on aligned vectors
+  Vector<4> v = std::vector<double>{1., -2., 3., -4.};
+  Vector<4> w = std::vector<double>{0.5, 4., -1., 2.};
+  Vector<4> u = (v + w) * w - v / w;
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(u[i], (v[i] + w[i]) * w[i] - v[i] / w[i]);
+    EXPECT_EQ((-v).abs()[i], std::abs(v[i]));
+  }
+  EXPECT_EQ(v.dot(w), 0.5 - 8. - 3. - 8.);
+  u += 1.;
+  u *= 2.;
+  EXPECT_EQ(u[0], 2. * ((1.5 * 0.5 - 2.) + 1.));
+
+  // The assignments with another aligned vector
+  Vector<4> t = v;
+  t += w;
+  t -= v;
+  t *= w;
+  t /= w;
+  for (int i = 0; i < 4; i++) {
+    EXPECT_DOUBLE_EQ(t[i], w[i]);
+  }
+}
+
+TEST(VectorTest, VectorExpressions){
+  // A whole expression is evaluated into a vector at assignment
+  Vector<3> v = std::vector<double>{1., -2., 4.};
+  Vector<3> w = std::vector<double>{2., 0.5, -1.};
+  Vector<3> u = ((v - w).abs() / v + 2. * w) ^ 2.;
+  for (int i = 0; i < 3; i++) {
+    EXPECT_DOUBLE_EQ(u[i], std::pow(std::abs(v[i] - w[i]) / v[i] + 2. * w[i], 2.));
+  }
+
+  // The scalar is the left operand
+  Vector<3> s = 1. - v;
+  Vector<3> d = 2. / v;
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(s[i], 1. - v[i]);
+    EXPECT_EQ(d[i], 2. / v[i]);
+  }
+
+  // The operands of the expressions are copied, so expressions of temporaries are valid
+  auto e = (v + Vector<3>(1.)).exp();
+  Vector<3> x = e;
+  EXPECT_EQ(x[2], std::exp(5.));
+  EXPECT_DOUBLE_EQ(e.log().dot(v), 2. * 1. + (-1.) * (-2.) + 5. * 4.);
+
+  // Assignments of expressions of the vector itself
+  x = v;
+  x += x * x;
+  x -= -v;
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(x[i], v[i] + v[i] * v[i] + v[i]);
+  }
+}
+
 }  // namespace
\ No newline at end of file